@@ -1,21 +1,285 @@
 #include "IPCServer.h"
 #include "WMCompositor.h"
+#include "WMOutput.h"
+#include "StatePage.h"
+#include "StateTree.h"
+#include "ScreencastManager.h"
 #include "core/Config.h"
+#include "core/InputRecorder.h"
+#include "core/TilingEngine.h"
+#include "core/Window.h"
+#include "core/Workspace.h"
 
 #include <QLocalServer>
 #include <QLocalSocket>
 #include <QJsonDocument>
 #include <QJsonObject>
+#include <QJsonArray>
+#include <QGuiApplication>
+#include <QLoggingCategory>
+#include <QMutexLocker>
+#include <QScreen>
+#include <QSemaphore>
+#include <QThread>
 #include <QDir>
+#include <QFileInfo>
 #include <QDebug>
+#include <utility>
+
+// Every command, off unless asked for:
+//   QT_LOGGING_RULES="hackerlandwm.ipc.debug=true"
+Q_LOGGING_CATEGORY(lcIpc, "hackerlandwm.ipc", QtInfoMsg)
+
+// ─────────────────────────────────────────────────────────────────────────────
+// IPCServer::Thread — the listening socket, every client, reading and parsing
+// ─────────────────────────────────────────────────────────────────────────────
+
+class IPCServer::Thread : public QThread {
+public:
+    Thread(IPCServer* owner, const QString& path) : m_owner(owner), m_path(path) {}
+
+    /// Start and wait until the socket listens (or failed).
+    bool launch() {
+        start();
+        m_started.acquire();
+        return m_ok;
+    }
+
+    QString errorString() const { return m_error; }
+
+    /// Write \p out on this thread.  Queued calls run in order.
+    void deliver(QVector<Outgoing> out) {
+        QMetaObject::invokeMethod(m_context, [this, out = std::move(out)] {
+            write(out);
+        }, Qt::QueuedConnection);
+    }
+
+    /// Push out what was delivered before, close every client and stop.
+    void shutdown() {
+        QMetaObject::invokeMethod(m_context, [this] {
+            closeAll();
+            quit();
+        }, Qt::QueuedConnection);
+        wait();
+    }
+
+protected:
+    void run() override {
+        QLocalServer server;
+        server.setSocketOptions(QLocalServer::UserAccessOption);
+        QLocalServer::removeServer(m_path); // clean up stale socket
+        m_ok = server.listen(m_path);
+        if (!m_ok) m_error = server.errorString();
+        m_context = &server;
+        m_started.release();
+        if (!m_ok) return;
+
+        QTimer retry;
+        retry.setSingleShot(true);
+        retry.setInterval(kRetryMs);
+        m_retry = &retry;
+        QObject::connect(&retry, &QTimer::timeout, &retry, [this] { resume(); });
+        QObject::connect(&server, &QLocalServer::newConnection, &server,
+                         [this, &server] { accept(server); });
+
+        exec();
+
+        // The sockets are children of the server and go with it
+        m_clients.clear();
+        m_retry = nullptr;
+    }
+
+private:
+    struct Client {
+        QLocalSocket* socket   = nullptr;
+        quint8        events   = 0;         ///< Subscribed EventClass mask
+        double        tokens   = kRateBurst;
+        qint64        refillNs = 0;
+        bool          paused   = false;     ///< Lines left unread until resume()
+    };
+
+    static constexpr int    kRetryMs      = 10;
+    static constexpr qint64 kMaxLineBytes = 64 * 1024;
+
+    void accept(QLocalServer& server);
+    void read(quint64 id);
+    void defer(Client& c);
+    void resume();
+    void drop(quint64 id, bool abort);
+    void write(const QVector<Outgoing>& out);
+    void closeAll();
+
+    IPCServer*              m_owner;
+    QString                 m_path;
+    QSemaphore              m_started;
+    bool                    m_ok      = false;
+    QString                 m_error;
+    QObject*                m_context = nullptr;    ///< Lives on this thread
+    QTimer*                 m_retry   = nullptr;
+    QHash<quint64, Client>  m_clients;
+    quint64                 m_nextId  = 0;
+};
+
+void IPCServer::Thread::accept(QLocalServer& server) {
+    while (auto* socket = server.nextPendingConnection()) {
+        const quint64 id = ++m_nextId;
+        Client c;
+        c.socket   = socket;
+        c.refillNs = m_owner->m_clock.nsecsElapsed();
+        m_clients.insert(id, c);
+        ++m_owner->m_clientCount;
+        QObject::connect(socket, &QLocalSocket::readyRead,    socket, [this, id] { read(id); });
+        QObject::connect(socket, &QLocalSocket::disconnected, socket, [this, id] { drop(id, false); });
+    }
+}
+
+void IPCServer::Thread::read(quint64 id) {
+    const auto it = m_clients.find(id);
+    if (it == m_clients.end()) return;
+    Client& c = *it;
+    c.paused = false;
+
+    while (c.socket->canReadLine()) {
+        // Anything that says "not now" leaves the rest in the socket: order
+        // is kept and the kernel buffer pushes back on the client
+        if (c.socket->bytesToWrite() > kMaxQueuedBytes) {     // Its replies pile up unread
+            defer(c);
+            return;
+        }
+
+        const qint64 now = m_owner->m_clock.nsecsElapsed();
+        c.tokens   = qMin(kRateBurst, c.tokens + (now - c.refillNs) * (kRatePerSec / 1e9));
+        c.refillNs = now;
+        if (c.tokens < 1.0) {
+            ++m_owner->m_throttled;
+            defer(c);
+            return;
+        }
+        if (m_owner->queued() >= kMaxQueued) {
+            ++m_owner->m_queueStalls;
+            defer(c);
+            return;
+        }
+
+        const QString line = QString::fromUtf8(c.socket->readLine()).trimmed();
+        if (line.isEmpty()) continue;
+
+        Request r = parseRequest(id, line);
+        c.tokens -= qMax(1, int(r.commands.size()));   // A batch pays per command
+        r.queuedNs = m_owner->m_clock.nsecsElapsed();
+        m_owner->enqueue(std::move(r));
+    }
+
+    if (c.socket->bytesAvailable() > kMaxLineBytes) {
+        qWarning() << "[IPC] client sent" << c.socket->bytesAvailable()
+                   << "bytes without a newline, disconnecting";
+        drop(id, true);
+    }
+}
+
+void IPCServer::Thread::defer(Client& c) {
+    c.paused = true;
+    if (!m_retry->isActive()) m_retry->start();
+}
+
+void IPCServer::Thread::resume() {
+    // read() may drop clients — walk the ids
+    const auto ids = m_clients.keys();
+    for (const quint64 id : ids) {
+        const auto it = m_clients.constFind(id);
+        if (it != m_clients.cend() && it->paused) read(id);
+    }
+}
+
+void IPCServer::Thread::drop(quint64 id, bool abort) {
+    const auto it = m_clients.find(id);
+    if (it == m_clients.end()) return;
+    QLocalSocket* socket = it->socket;
+    m_clients.erase(it);
+    --m_owner->m_clientCount;
+
+    if (abort) {
+        ++m_owner->m_dropped;
+        socket->disconnect();
+        socket->abort();
+    }
+    socket->deleteLater();
+
+    // Behind the client's own requests in the same queue: a subscribe it
+    // sent just before hanging up runs first, then this undoes it.  A
+    // separate queued call could overtake that subscribe and leave a dead
+    // subscriber behind for good.  Not counted and never refused.
+    Request gone;
+    gone.client = id;
+    gone.gone   = true;
+    QMutexLocker lock(&m_owner->m_queueLock);
+    m_owner->m_queue.enqueue(std::move(gone));
+}
+
+void IPCServer::Thread::write(const QVector<Outgoing>& out) {
+    for (const auto& o : out) {
+        switch (o.kind) {
+            case Outgoing::ToClient: {
+                const auto it = m_clients.constFind(o.client);
+                if (it != m_clients.cend()) it->socket->write(o.data);
+                break;
+            }
+            case Outgoing::Subscribe: {
+                const auto it = m_clients.find(o.client);
+                if (it != m_clients.end()) it->events |= o.events;
+                break;
+            }
+            case Outgoing::Broadcast: {
+                // No flush: each socket's write buffer is its queue, drained
+                // by this thread's event loop
+                QVector<quint64> slow;
+                for (auto it = m_clients.cbegin(); it != m_clients.cend(); ++it) {
+                    if (!(it->events & o.events)) continue;
+                    if (it->socket->bytesToWrite() + o.data.size() > kMaxQueuedBytes) {
+                        qWarning() << "[IPC] subscriber stopped reading —"
+                                   << it->socket->bytesToWrite() << "bytes queued, disconnecting";
+                        slow << it.key();
+                        continue;
+                    }
+                    it->socket->write(o.data);
+                }
+                for (const quint64 id : slow) drop(id, true);
+                break;
+            }
+        }
+    }
+}
+
+void IPCServer::Thread::closeAll() {
+    for (const auto& c : std::as_const(m_clients)) {
+        c.socket->disconnect();
+        c.socket->flush();
+        c.socket->disconnectFromServer();
+    }
+    m_clients.clear();
+    m_owner->m_clientCount = 0;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// IPCServer
+// ─────────────────────────────────────────────────────────────────────────────
 
 IPCServer::IPCServer(WMCompositor* compositor, QObject* parent)
 : QObject(parent), m_compositor(compositor)
 {
-    m_server = new QLocalServer(this);
-    m_server->setSocketOptions(QLocalServer::UserAccessOption);
-    connect(m_server, &QLocalServer::newConnection,
-            this, &IPCServer::onNewConnection);
+    m_clock.start();
+    m_tree = new StateTree(compositor, this);
+    m_statePage = new StatePage(compositor, m_tree, this);
+    connectEvents();
+
+    // Commands run at the top of a frame; the fallback keeps them moving
+    // while no output renders
+    if (auto* output = compositor->primaryOutput())
+        connect(output, &WMOutput::frameStarted, this, &IPCServer::drain);
+    m_fallback.setInterval(kFallbackMs);
+    connect(&m_fallback, &QTimer::timeout, this, [this] {
+        if (m_clock.nsecsElapsed() - m_lastDrainNs >= kFallbackMs * 1000000LL) drain();
+    });
 }
 
 IPCServer::~IPCServer() { stop(); }
@@ -26,104 +290,528 @@ QString IPCServer::socketPath() {
 }
 
 bool IPCServer::start() {
+    if (m_thread) return true;
     const QString path = socketPath();
-    QLocalServer::removeServer(path); // clean up stale socket
-    if (!m_server->listen(path)) {
-        qWarning() << "[IPC] failed to listen on" << path << m_server->errorString();
+    auto* thread = new Thread(this, path);
+    if (!thread->launch()) {
+        qWarning() << "[IPC] failed to listen on" << path << thread->errorString();
+        thread->wait();
+        delete thread;
         return false;
     }
+    m_thread      = thread;
+    m_lastDrainNs = m_clock.nsecsElapsed();
+    m_fallback.start();
     qInfo() << "[IPC] listening on" << path;
     return true;
 }
 
 void IPCServer::stop() {
-    for (auto* c : m_clients) c->disconnectFromServer();
-    m_clients.clear();
-    m_server->close();
+    m_fallback.stop();
+    if (m_thread) {
+        flushOutbox();
+        m_thread->shutdown();
+        delete m_thread;
+        m_thread = nullptr;
+    }
+    {
+        QMutexLocker lock(&m_queueLock);
+        m_queue.clear();
+    }
+    m_outbox.clear();
+    m_subscribers.clear();
+    m_subscribedMask = 0;
 }
 
-bool IPCServer::isRunning() const { return m_server->isListening(); }
+// ─────────────────────────────────────────────────────────────────────────────
+// Request queue
+// ─────────────────────────────────────────────────────────────────────────────
 
-void IPCServer::onNewConnection() {
-    auto* client = m_server->nextPendingConnection();
-    if (!client) return;
-    m_clients.append(client);
-    connect(client, &QLocalSocket::readyRead,     this, &IPCServer::onClientData);
-    connect(client, &QLocalSocket::disconnected,  this, &IPCServer::onClientDisconnected);
+int IPCServer::queued() const {
+    QMutexLocker lock(&m_queueLock);
+    return m_queue.size();
 }
 
-void IPCServer::onClientData() {
-    auto* client = qobject_cast<QLocalSocket*>(sender());
-    if (!client) return;
-    while (client->canReadLine()) {
-        const QString cmd = QString::fromUtf8(client->readLine()).trimmed();
-        if (!cmd.isEmpty()) handleCommand(client, cmd);
+void IPCServer::enqueue(Request&& r) {
+    QMutexLocker lock(&m_queueLock);
+    m_queue.enqueue(std::move(r));
+    ++m_enqueued;
+    m_peakQueued = qMax(m_peakQueued, int(m_queue.size()));
+}
+
+bool IPCServer::dequeue(Request& r) {
+    QMutexLocker lock(&m_queueLock);
+    if (m_queue.isEmpty()) return false;
+    r = m_queue.dequeue();
+    return true;
+}
+
+void IPCServer::drain() {
+    const qint64 start = m_clock.nsecsElapsed();
+    m_lastDrainNs = start;
+
+    // At least one request per frame, however slow; then only while the
+    // budget lasts
+    bool    ran = false;
+    Request r;
+    while (dequeue(r)) {
+        if (r.gone) {
+            clientGone(r.client);
+            continue;
+        }
+        m_wait.add((m_clock.nsecsElapsed() - r.queuedNs) / 1000);
+        run(r);
+        ran = true;
+        if (m_clock.nsecsElapsed() - start >= kFrameBudgetNs) {
+            if (queued() > 0) ++m_overBudget;
+            break;
+        }
+    }
+    if (!ran) return;
+
+    m_drainCost.add((m_clock.nsecsElapsed() - start) / 1000);
+    flushOutbox();
+}
+
+void IPCServer::post(Outgoing&& o) {
+    m_outbox.append(std::move(o));
+    if (m_outboxScheduled) return;
+    m_outboxScheduled = true;
+    QTimer::singleShot(0, this, &IPCServer::flushOutbox);
+}
+
+void IPCServer::flushOutbox() {
+    m_outboxScheduled = false;
+    if (m_outbox.isEmpty()) return;
+    if (m_thread) m_thread->deliver(std::exchange(m_outbox, {}));
+    else          m_outbox.clear();
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Commands
+// ─────────────────────────────────────────────────────────────────────────────
+
+QStringList IPCServer::splitBatch(const QString& line, bool* batch, QString* error) {
+    QStringList cmds;
+
+    // ["workspace 3", "exec alacritty"]
+    if (line.startsWith('[')) {
+        *batch = true;
+        QJsonParseError err;
+        const QJsonDocument doc = QJsonDocument::fromJson(line.toUtf8(), &err);
+        if (err.error != QJsonParseError::NoError || !doc.isArray()) {
+            *error = "malformed JSON command array: " + err.errorString();
+            return {};
+        }
+        for (const auto& v : doc.array()) {
+            const QString c = v.toString().trimmed();
+            if (c.isEmpty()) { *error = "command array holds an empty or non-string entry"; return {}; }
+            cmds << c;
+        }
+        return cmds;
+    }
+
+    // workspace 3; exec "a; b" — ';' inside double quotes belongs to the command
+    bool    quoted = false;
+    QString cur;
+    for (const QChar c : line) {
+        if (c == '"') quoted = !quoted;
+        if (c == ';' && !quoted) {
+            cmds << cur.trimmed();
+            cur.clear();
+            continue;
+        }
+        cur += c;
     }
+    cmds << cur.trimmed();
+    cmds.removeAll(QString());
+    *batch = cmds.size() > 1;
+    return cmds;
 }
 
-void IPCServer::onClientDisconnected() {
-    auto* client = qobject_cast<QLocalSocket*>(sender());
-    m_clients.removeOne(client);
-    client->deleteLater();
+IPCServer::Request IPCServer::parseRequest(quint64 client, const QString& line) {
+    Request r;
+    r.client = client;
+    r.line   = line;
+
+    QString error;
+    const QStringList cmds = splitBatch(line, &r.batch, &error);
+    if (cmds.isEmpty()) {
+        r.rejected = { Reply{ false, error.isEmpty() ? "empty command" : error } };
+        return r;
+    }
+
+    // Parse the whole batch before running any of it — all or nothing
+    r.commands.resize(cmds.size());
+    for (int i = 0; i < cmds.size(); ++i) {
+        if (!parseCommand(cmds[i], r.commands[i], &error)) {
+            r.rejected = QVector<Reply>(cmds.size(), Reply{ false, "not run" });
+            r.rejected[i] = Reply{ false, error };
+            r.commands.clear();
+            return r;
+        }
+    }
+    return r;
 }
 
-void IPCServer::handleCommand(QLocalSocket* client, const QString& cmd) {
-    qInfo() << "[IPC] command:" << cmd;
-    emit commandReceived(cmd);
+void IPCServer::run(const Request& r) {
+    qCDebug(lcIpc) << "[IPC] command:" << r.line;
+    if (auto* rec = InputRecorder::active()) rec->ipc(r.line);
+    emit commandReceived(r.line);
+    ++m_executed;
+
+    if (!r.rejected.isEmpty()) {
+        sendReplies(r.client, r.batch, r.rejected);
+        return;
+    }
+
+    // Run in order, so a query sees the actions before it.  Layout work
+    // only schedules a retile; the whole batch costs one pass at the next
+    // frame.
+    QVector<Reply> replies;
+    replies.reserve(r.commands.size());
+    bool quit = false;
+    for (const auto& c : r.commands) {
+        if (!c.action.isValid()) {
+            replies << runQuery(r.client, c.verb, c.arg);
+        } else if (c.action.op == ActionOp::Quit) {
+            quit = true;
+            replies << Reply{};
+        } else {
+            m_compositor->dispatch(c.action);
+            replies << Reply{};
+        }
+    }
+    sendReplies(r.client, r.batch, replies);
+
+    // Quit last, with the reply handed to the IPC thread — stop() lets it
+    // write that before the thread goes
+    if (quit) {
+        flushOutbox();
+        m_compositor->dispatch(Action(ActionOp::Quit));
+    }
+}
 
-    // Parse: "verb [args...]"
+bool IPCServer::parseCommand(const QString& cmd, Command& out, QString* error) {
+    // "verb [args...]"
     const QStringList parts = cmd.split(' ', Qt::SkipEmptyParts);
-    if (parts.isEmpty()) { sendResponse(client, false, "empty command"); return; }
-
-    const QString verb = parts[0].toLower();
-    const QString arg  = parts.size() > 1 ? parts.mid(1).join(' ') : QString();
-
-    if (verb == "workspace") {
-        bool ok; int n = arg.toInt(&ok);
-        if (ok) { m_compositor->switchWorkspace(n); sendResponse(client, true); }
-        else sendResponse(client, false, "invalid workspace number");
-    } else if (verb == "exec") {
-        if (arg.isEmpty()) { sendResponse(client, false, "exec needs a command"); return; }
-        m_compositor->launchApp(arg);
-        sendResponse(client, true);
-    } else if (verb == "close") {
-        if (auto* w = m_compositor->activeWindow())
-            m_compositor->closeWindow(w);
-        sendResponse(client, true);
-    } else if (verb == "layout") {
-        m_compositor->setLayout(TilingEngine::layoutFromString(arg));
-        sendResponse(client, true);
-    } else if (verb == "reload") {
-        m_compositor->reloadConfig();
-        sendResponse(client, true);
-    } else if (verb == "quit") {
-        sendResponse(client, true);
-        QCoreApplication::quit();
-    } else if (verb == "fullscreen") {
-        m_compositor->toggleFullscreen();
-        sendResponse(client, true);
-    } else if (verb == "float") {
-        m_compositor->toggleFloat();
-        sendResponse(client, true);
-    } else if (verb == "focus") {
-        m_compositor->focusDirection(arg);
-        sendResponse(client, true);
-    } else if (verb == "status") {
+    if (parts.isEmpty()) { *error = "empty command"; return false; }
+
+    out.verb = parts[0].toLower();
+    out.arg  = parts.size() > 1 ? parts.mid(1).join(' ') : QString();
+
+    // Queries are answered here; they carry no Action
+    if (out.verb == "status" || out.verb == "latency" || out.verb == "subscribe" ||
+        out.verb == "get_tree" || out.verb == "get_tree_since" || out.verb == "state_page" ||
+        out.verb == "ipc_stats" || out.verb == "screenshot_window")
+        return true;
+
+    // Everything else is an action: "verb arg" is the keybind "verb:arg"
+    out.action = Action::parse(out.arg.isEmpty() ? out.verb : out.verb + ':' + out.arg, error);
+    return out.action.isValid();
+}
+
+IPCServer::Reply IPCServer::runQuery(quint64 client, const QString& verb, const QString& arg) {
+    if (verb == "status") {
+        // Count in place — allWindows() would build the whole list
+        int windows = 0;
+        for (int id = 1; id <= m_compositor->workspaceCount(); ++id)
+            if (const auto* ws = m_compositor->workspace(id)) windows += ws->windows().size();
+
         QJsonObject st;
-        st["workspace"] = m_compositor->activeWorkspaceId();
-        st["windows"]   = m_compositor->allWindows().size();
-        const auto* w   = m_compositor->activeWindow();
-        st["active"]    = w ? w->title() : "";
-        sendResponse(client, true, QJsonDocument(st).toJson(QJsonDocument::Compact));
-    } else {
-        sendResponse(client, false, "unknown command: " + verb);
+        st["workspace"]  = m_compositor->activeWorkspaceId();
+        st["windows"]    = windows;
+        const auto* w    = m_compositor->activeWindow();
+        st["active"]     = w ? w->title() : "";
+        st["generation"] = qint64(m_tree->generation());
+        return { true, QJsonDocument(st).toJson(QJsonDocument::Compact) };
+    }
+    if (verb == "get_tree") {
+        if (!arg.isEmpty()) return { false, "get_tree takes no argument" };
+        return { true, QJsonDocument(m_tree->toJson()).toJson(QJsonDocument::Compact) };
+    }
+    if (verb == "get_tree_since") {
+        bool ok = false;
+        const quint64 since = arg.toULongLong(&ok);
+        if (!ok) return { false, "get_tree_since needs a generation number" };
+        return { true, QJsonDocument(m_tree->toJson(since)).toJson(QJsonDocument::Compact) };
+    }
+    if (verb == "state_page") {
+        if (!m_statePage->isValid()) return { false, "no state page (memfd unavailable)" };
+        QJsonObject o;
+        o["path"]    = m_statePage->path();
+        o["size"]    = qint64(HLWM_STATE_SIZE);
+        o["version"] = qint64(HLWM_STATE_VERSION);
+        o["writes"]  = qint64(m_statePage->writes());
+        return { true, QJsonDocument(o).toJson(QJsonDocument::Compact) };
+    }
+    if (verb == "subscribe") {
+        return subscribe(client, arg);
+    }
+    if (verb == "screenshot_window") {
+        // screenshot_window <id|app_id> [--decorations] [path]
+        QStringList parts = arg.split(' ', Qt::SkipEmptyParts);
+        if (parts.isEmpty()) return { false, "screenshot_window needs a window id or app_id" };
+        auto* screencast = m_compositor->screencast();
+        if (!screencast) return { false, "screen capture unavailable" };
+
+        const QString target = parts.takeFirst();
+        if (!screencast->findWindow(target)) return { false, "no window '" + target + "'" };
+        const bool decorations = !parts.isEmpty() && parts.first() == "--decorations";
+        if (decorations) parts.removeFirst();
+
+        const QString given  = parts.join(' ');
+        const QString suffix = QFileInfo(given).suffix().toLower();
+        const QString format = suffix.isEmpty() ? QStringLiteral("png") : suffix;
+        const QString path   = ScreencastManager::screenshotPath(given, format);
+
+        // Encoding runs on the screencast pool; the reply names the job and
+        // where the file will land
+        QJsonObject o;
+        o["job"]  = qint64(screencast->takeWindowScreenshot(target, path, decorations, format));
+        o["path"] = path;
+        return { true, QJsonDocument(o).toJson(QJsonDocument::Compact) };
     }
+    if (verb == "ipc_stats") {
+        if (arg == "reset") {
+            m_wait.clear();
+            m_drainCost.clear();
+            m_overBudget = 0;
+            QMutexLocker lock(&m_queueLock);
+            m_peakQueued = m_queue.size();
+            return {};
+        }
+        if (arg.isEmpty())
+            return { true, QJsonDocument(statsJson()).toJson(QJsonDocument::Compact) };
+        return { false, "ipc_stats takes no argument or 'reset'" };
+    }
+    if (verb == "latency") {
+        auto& tracer = LatencyTracer::instance();
+        if (arg == "reset") {
+            tracer.reset();
+            return {};
+        }
+        if (arg.isEmpty())
+            return { true, QJsonDocument(tracer.toJson()).toJson(QJsonDocument::Compact) };
+        return { false, "latency takes no argument or 'reset'" };
+    }
+    return { false, "unknown query '" + verb + "'" };
 }
 
-void IPCServer::sendResponse(QLocalSocket* client, bool ok, const QString& msg) {
+QJsonObject IPCServer::replyJson(const Reply& r) {
     QJsonObject obj;
-    obj["success"] = ok;
-    if (!msg.isEmpty()) obj[ok ? "result" : "error"] = msg;
-    client->write(QJsonDocument(obj).toJson(QJsonDocument::Compact) + "\n");
-    client->flush();
+    obj["success"] = r.ok;
+    if (!r.msg.isEmpty()) obj[r.ok ? "result" : "error"] = r.msg;
+    return obj;
+}
+
+void IPCServer::sendReplies(quint64 client, bool batch, const QVector<Reply>& replies) {
+    if (!client) {
+        for (const auto& r : replies)
+            if (!r.ok) qWarning() << "[IPC] command failed:" << r.msg;
+        return;
+    }
+
+    // A single command keeps the plain {"success":...} reply; a batch
+    // answers with an array, one entry per command
+    QJsonDocument doc;
+    if (batch) {
+        QJsonArray arr;
+        for (const auto& r : replies) arr.append(replyJson(r));
+        doc.setArray(arr);
+    } else {
+        doc.setObject(replyJson(replies.value(0)));
+    }
+
+    Outgoing o;
+    o.client = client;
+    o.data   = doc.toJson(QJsonDocument::Compact) + "\n";
+    post(std::move(o));
+}
+
+QJsonObject IPCServer::statsJson() const {
+    QJsonObject o;
+    {
+        QMutexLocker lock(&m_queueLock);
+        o["queued"]      = int(m_queue.size());
+        o["peak_queued"] = m_peakQueued;
+        o["enqueued"]    = qint64(m_enqueued);
+    }
+    o["max_queued"]         = kMaxQueued;
+    o["executed"]           = qint64(m_executed);
+    o["clients"]            = m_clientCount.load();
+    o["frame_budget_us"]    = qint64(kFrameBudgetNs / 1000);
+    o["over_budget_frames"] = qint64(m_overBudget);
+    o["rate_per_sec"]       = kRatePerSec;
+    o["throttled"]          = qint64(m_throttled.load());
+    o["queue_full"]         = qint64(m_queueStalls.load());
+    o["dropped_clients"]    = qint64(m_dropped.load());
+    o["queue_wait"]         = m_wait.toJson();
+    o["drain"]              = m_drainCost.toJson();
+    return o;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Event subscriptions
+// ─────────────────────────────────────────────────────────────────────────────
+
+IPCServer::Reply IPCServer::subscribe(quint64 client, const QString& arg) {
+    if (!client) return { false, "subscribe needs a connection" };
+
+    static const QHash<QString, EventClass> classes = {
+        { "workspace", WorkspaceEvents },
+        { "window",    WindowEvents    },
+        { "layout",    LayoutEvents    },
+        { "config",    ConfigEvents    },
+        { "output",    OutputEvents    },
+    };
+
+    // Either "workspace window" or i3's ["workspace","window"]
+    QStringList names;
+    if (arg.startsWith('[')) {
+        for (const auto& v : QJsonDocument::fromJson(arg.toUtf8()).array())
+            names << v.toString();
+    } else {
+        names = arg.split(' ', Qt::SkipEmptyParts);
+    }
+    if (names.isEmpty()) {
+        return { false, "subscribe needs an event class: "
+                        "workspace|window|layout|config|output" };
+    }
+
+    quint8 mask = 0;
+    for (const auto& name : names) {
+        const auto it = classes.constFind(name.toLower());
+        if (it == classes.cend())
+            return { false, "unknown event class '" + name + "'" };
+        mask |= it.value();
+    }
+
+    m_subscribers[client] |= mask;
+    updateSubscribedMask();
+
+    // Ahead of the reply in the outbox, so no event can slip in between
+    Outgoing o;
+    o.kind   = Outgoing::Subscribe;
+    o.client = client;
+    o.events = mask;
+    post(std::move(o));
+    return {};
+}
+
+void IPCServer::connectEvents() {
+    m_lastWorkspace = m_compositor->activeWorkspaceId();
+    m_lastFocused   = m_compositor->activeWindow();
+
+    // ── workspace ─────────────────────────────────────────────────────────
+    connect(m_compositor, &WMCompositor::activeWorkspaceChanged, this, [this](int id) {
+        const int old = std::exchange(m_lastWorkspace, id);
+        if (!wants(WorkspaceEvents)) return;
+        QJsonObject ev;
+        ev["change"]  = "focus";
+        ev["current"] = id;
+        ev["old"]     = old;
+        pushEvent(WorkspaceEvents, ev);
+    });
+
+    // ── window ────────────────────────────────────────────────────────────
+    connect(m_compositor, &WMCompositor::windowAdded, this, [this](Window* w) {
+        watchWindow(w);
+        pushWindowEvent("new", w);
+    });
+    connect(m_compositor, &WMCompositor::windowRemoved, this, [this](Window* w) {
+        if (m_lastFocused == w) m_lastFocused = nullptr;
+        pushWindowEvent("close", w);
+    });
+    connect(m_compositor, &WMCompositor::activeWindowChanged, this, [this](Window* w) {
+        // Re-emitted on every focus move and workspace switch — report changes only
+        if (w == m_lastFocused) return;
+        m_lastFocused = w;
+        if (w) pushWindowEvent("focus", w);
+    });
+    for (auto* w : m_compositor->allWindows())
+        watchWindow(w);
+
+    // ── layout ────────────────────────────────────────────────────────────
+    for (int id = 1; id <= m_compositor->workspaceCount(); ++id) {
+        auto* ws = m_compositor->workspace(id);
+        if (!ws) continue;
+        connect(ws, &Workspace::layoutChanged, this, [this, id](TilingLayout l) {
+            if (!wants(LayoutEvents)) return;
+            QJsonObject ev;
+            ev["change"]    = "layout";
+            ev["workspace"] = id;
+            ev["layout"]    = TilingEngine::layoutToString(l);
+            pushEvent(LayoutEvents, ev);
+        });
+    }
+
+    // ── config ────────────────────────────────────────────────────────────
+    connect(&Config::instance(), &Config::configReloaded, this, [this] {
+        if (!wants(ConfigEvents)) return;
+        QJsonObject ev;
+        ev["change"] = "reload";
+        pushEvent(ConfigEvents, ev);
+    });
+
+    // ── output ────────────────────────────────────────────────────────────
+    auto outputEvent = [this](const char* change, const QScreen* screen) {
+        if (!wants(OutputEvents)) return;
+        QJsonObject ev;
+        ev["change"] = change;
+        ev["output"] = StateTree::outputJson(screen);
+        pushEvent(OutputEvents, ev);
+    };
+    auto watchScreen = [this, outputEvent](QScreen* screen) {
+        connect(screen, &QScreen::geometryChanged, this,
+                [outputEvent, screen] { outputEvent("mode", screen); });
+    };
+    for (auto* screen : QGuiApplication::screens())
+        watchScreen(screen);
+    connect(qGuiApp, &QGuiApplication::screenAdded, this,
+            [outputEvent, watchScreen](QScreen* screen) {
+                watchScreen(screen);
+                outputEvent("added", screen);
+            });
+    connect(qGuiApp, &QGuiApplication::screenRemoved, this,
+            [outputEvent](QScreen* screen) { outputEvent("removed", screen); });
+}
+
+void IPCServer::watchWindow(Window* w) {
+    connect(w, &Window::titleChanged,     this, [this, w] { pushWindowEvent("title", w); });
+    connect(w, &Window::stateChanged,     this, [this, w] { pushWindowEvent("state", w); });
+    connect(w, &Window::workspaceChanged, this, [this, w] { pushWindowEvent("move",  w); });
+}
+
+void IPCServer::pushWindowEvent(const char* change, const Window* w) {
+    if (!wants(WindowEvents)) return;
+    QJsonObject ev;
+    ev["change"]    = change;
+    ev["container"] = StateTree::windowJson(w);
+    pushEvent(WindowEvents, ev);
+}
+
+void IPCServer::pushEvent(EventClass cls, QJsonObject event) {
+    switch (cls) {
+        case WorkspaceEvents: event["event"] = "workspace"; break;
+        case WindowEvents:    event["event"] = "window";    break;
+        case LayoutEvents:    event["event"] = "layout";    break;
+        case ConfigEvents:    event["event"] = "config";    break;
+        case OutputEvents:    event["event"] = "output";    break;
+    }
+    Outgoing o;
+    o.kind   = Outgoing::Broadcast;
+    o.events = cls;
+    o.data   = QJsonDocument(event).toJson(QJsonDocument::Compact) + '\n';
+    post(std::move(o));
+}
+
+void IPCServer::clientGone(quint64 client) {
+    if (m_subscribers.remove(client)) updateSubscribedMask();
+}
+
+void IPCServer::updateSubscribedMask() {
+    m_subscribedMask = 0;
+    for (const quint8 mask : std::as_const(m_subscribers))
+        m_subscribedMask |= mask;
 }
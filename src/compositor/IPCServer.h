@@ -1,10 +1,21 @@
 #pragma once
 #include <QObject>
-#include <QLocalServer>
-#include <QLocalSocket>
-#include <QList>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QJsonObject>
+#include <QMutex>
+#include <QQueue>
+#include <QTimer>
+#include <QVector>
+#include <atomic>
+
+#include "core/Action.h"
+#include "core/LatencyTracer.h"
 
 class WMCompositor;
+class Window;
+class StateTree;
+class StatePage;
 
 // ─────────────────────────────────────────────────────────────────────────────
 // IPCServer — Unix socket IPC, compatible with i3/Sway CLI format
@@ -15,9 +26,41 @@ class WMCompositor;
 //         hackerlandwm-msg reload
 //         hackerlandwm-msg layout spiral
 //         hackerlandwm-msg close
+//         hackerlandwm-msg subscribe workspace window
+//         hackerlandwm-msg get_tree
+//         hackerlandwm-msg get_tree_since 1234
+//         hackerlandwm-msg state_page
+//         hackerlandwm-msg ipc_stats
+//         hackerlandwm-msg screenshot_window firefox --decorations
 //
 // Protocol: newline-terminated plain text commands
 // Response: JSON {"success":true} or {"success":false,"error":"..."}
+//
+// Batches:  "workspace 3; exec alacritty" or ["workspace 3","exec alacritty"]
+//           on one line.  Every command is parsed before any runs — one bad
+//           command and nothing happens — and the reply is an array with one
+//           entry per command.  Any number of requests may be pipelined on a
+//           connection; replies come back in order.
+//
+// Events:   "subscribe <class>..." (or a JSON array of classes) keeps the
+//           connection open and pushes one JSON line per change, i3 style:
+//             {"event":"workspace","change":"focus","current":3,"old":2}
+//           Classes: workspace, window, layout, config, output.  Events are
+//           only built when someone subscribed to their class.  A subscriber
+//           that lets more than kMaxQueuedBytes pile up unread is dropped
+//           rather than buffered without bound.
+//
+// Threading: sockets, line splitting and parsing live on an IPC thread,
+//           which queues parsed requests (at most kMaxQueued).  The GUI
+//           thread runs them from drain(), once per frame at the top of
+//           WMOutput's render tick, for at most kFrameBudgetNs — whatever
+//           is left waits for the next frame.  A client whose token bucket
+//           (kRatePerSec commands, kRateBurst deep) is empty, whose replies
+//           pile up unread, or that finds the queue full is simply not
+//           read for a while: its requests wait in the kernel buffer, in
+//           order, and the frame never pays for them.  A disconnect
+//           travels through the same queue, after the client's requests.
+//           ipc_stats reports queue depth, wait times and throttling.
 // ─────────────────────────────────────────────────────────────────────────────
 class IPCServer : public QObject {
     Q_OBJECT
@@ -27,23 +70,139 @@ public:
 
     bool start();
     void stop();
-    bool isRunning() const;
+    bool isRunning() const { return m_thread != nullptr; }
 
     static QString socketPath();
 
+    /// Run \p cmd as if a client had sent it, discarding the reply
+    /// (InputReplayer).  Runs right away, past the queue; works without
+    /// start().
+    void execute(const QString& cmd) { run(parseRequest(0, cmd)); }
+
+public slots:
+    /// Run queued requests until the queue is empty or kFrameBudgetNs is
+    /// spent.  Called once per frame.
+    void drain();
+
 signals:
     void commandReceived(const QString& cmd);
 
-private slots:
-    void onNewConnection();
-    void onClientData();
-    void onClientDisconnected();
-
 private:
-    void handleCommand(QLocalSocket* client, const QString& cmd);
-    void sendResponse(QLocalSocket* client, bool ok, const QString& msg = {});
+    class Thread;           // Socket I/O and parsing — IPCServer.cpp
+
+    enum EventClass : quint8 {
+        WorkspaceEvents = 1 << 0,
+        WindowEvents    = 1 << 1,
+        LayoutEvents    = 1 << 2,
+        ConfigEvents    = 1 << 3,
+        OutputEvents    = 1 << 4
+    };
+
+    struct Reply {
+        bool    ok = true;
+        QString msg;            ///< "result" when ok, "error" otherwise
+    };
+
+    struct Command {
+        QString verb;
+        QString arg;
+        Action  action;         ///< Invalid for queries (status, get_tree, latency, ...)
+    };
+
+    /// One request line, parsed on the IPC thread.  Clients are ids so
+    /// the GUI thread never touches a socket; 0 is execute().
+    struct Request {
+        quint64          client = 0;
+        QString          line;
+        bool             batch  = false;
+        QVector<Command> commands;
+        QVector<Reply>   rejected;      ///< Parse failure: the replies, nothing runs
+        qint64           queuedNs = 0;  ///< On m_clock
+        bool             gone   = false;  ///< Not a request: the client disconnected
+    };
+
+    /// GUI thread → IPC thread, handed over once per drain / event burst.
+    struct Outgoing {
+        enum Kind : quint8 { ToClient, Broadcast, Subscribe };
+        Kind       kind   = ToClient;
+        quint64    client = 0;          ///< ToClient, Subscribe
+        quint8     events = 0;          ///< Broadcast: its class; Subscribe: classes added
+        QByteArray data;
+    };
+
+    /// One request line → its commands.  \p batch is set for a JSON array
+    /// or more than one ';'-separated command.
+    static QStringList splitBatch(const QString& line, bool* batch, QString* error);
+    static bool        parseCommand(const QString& cmd, Command& out, QString* error);
+
+    /// Thread-safe: splitting and parsing only, nothing is run.
+    static Request parseRequest(quint64 client, const QString& line);
+
+    void  run(const Request& r);
+    Reply runQuery(quint64 client, const QString& verb, const QString& arg);
+    QJsonObject statsJson() const;
+
+    static QJsonObject replyJson(const Reply& r);
+    void sendReplies(quint64 client, bool batch, const QVector<Reply>& replies);
+
+    // ── Request queue (IPC thread in, GUI thread out) ─────────────────────
+    int  queued() const;
+    void enqueue(Request&& r);
+    bool dequeue(Request& r);
+
+    // ── Outbox (GUI thread out, IPC thread writes) ────────────────────────
+    void post(Outgoing&& o);
+    void flushOutbox();
+
+    // ── Event subscriptions ───────────────────────────────────────────────
+    Reply subscribe(quint64 client, const QString& arg);
+    void connectEvents();
+    void watchWindow(Window* w);
+    void clientGone(quint64 client);
+    void updateSubscribedMask();
+
+    /// True if anyone listens to \p cls — checked before building an event.
+    bool wants(EventClass cls) const { return m_subscribedMask & cls; }
+
+    /// Send \p event to every subscriber of \p cls.  Serialised once.
+    void pushEvent(EventClass cls, QJsonObject event);
+    void pushWindowEvent(const char* change, const Window* w);
+
+    static constexpr qint64 kMaxQueuedBytes = 256 * 1024;
+    static constexpr int    kMaxQueued      = 256;          ///< Requests, all clients
+    static constexpr qint64 kFrameBudgetNs  = 2000000;      ///< GUI time per frame
+    static constexpr int    kFallbackMs     = 50;           ///< Drain without frames
+    static constexpr double kRatePerSec     = 1000.0;       ///< Commands per client
+    static constexpr double kRateBurst      = 200.0;
 
     WMCompositor*       m_compositor = nullptr;
-    QLocalServer*       m_server     = nullptr;
-    QList<QLocalSocket*> m_clients;
+    Thread*             m_thread     = nullptr;
+    StateTree*          m_tree       = nullptr;
+    StatePage*          m_statePage  = nullptr;
+    QElapsedTimer       m_clock;                    ///< Shared by both threads
+    QTimer              m_fallback;                 ///< Drains while no output renders
+    qint64              m_lastDrainNs = 0;
+
+    mutable QMutex      m_queueLock;
+    QQueue<Request>     m_queue;                    ///< Guarded by m_queueLock
+    int                 m_peakQueued = 0;           ///< Guarded by m_queueLock
+    quint64             m_enqueued   = 0;           ///< Guarded by m_queueLock
+
+    QVector<Outgoing>   m_outbox;
+    bool                m_outboxScheduled = false;
+
+    // ── Metrics (ipc_stats) ───────────────────────────────────────────────
+    quint64               m_executed    = 0;
+    quint64               m_overBudget  = 0;        ///< Frames that left work queued
+    LatencyHistogram      m_wait;                   ///< Queued → run
+    LatencyHistogram      m_drainCost;              ///< GUI time per non-empty drain
+    std::atomic<quint64>  m_throttled   { 0 };      ///< Reads deferred: rate limit
+    std::atomic<quint64>  m_queueStalls { 0 };      ///< Reads deferred: queue full
+    std::atomic<quint64>  m_dropped     { 0 };      ///< Clients cut off
+    std::atomic<int>      m_clientCount { 0 };
+
+    QHash<quint64, quint8> m_subscribers;           ///< Client → EventClass mask
+    quint8               m_subscribedMask = 0;      ///< Union of m_subscribers
+    int                  m_lastWorkspace  = 0;
+    const Window*        m_lastFocused    = nullptr;
 };
@@ -7,7 +7,10 @@
 //   1. captureFrame() — grabuje aktualną klatkę z QOpenGLWidget (GPU→CPU)
 //   2. pushFrameToPipeWire() — wysyła do PipeWire (screen share dla np. Firefox)
 //   3. sendFrameToFFmpeg()   — pipe do ffmpeg stdin (nagrywanie pliku)
-//   4. takeScreenshot()      — jednorazowy grab → QImage → plik PNG/JPG
+//   4. takeScreenshot()      — jednorazowy grab → QImage, kodowanie i zapis
+//                              PNG/JPG asynchronicznie na puli wątków
+//   5. captureWindow()       — bufor jednego okna (SHM lub tekstura przez FBO),
+//                              bez grabowania i przycinania całego outputu
 //
 // PipeWire:
 //   Kod kompiluje się zarówno z PipeWire jak i bez niego.
@@ -31,6 +34,7 @@
 #include "ScreencastManager.h"
 #include "WMCompositor.h"
 #include "WMOutput.h"
+#include "core/Window.h"
 
 #include <QPainter>
 #include <QProcess>
@@ -46,6 +50,10 @@
 #include <QDebug>
 #include <QImageWriter>
 #include <QBuffer>
+#include <QSet>
+#include <QThread>
+#include <QThreadPool>
+#include <QtConcurrent/QtConcurrentRun>
 
 // PipeWire headers — opcjonalne
 #ifdef HAVE_PIPEWIRE
@@ -58,6 +66,7 @@
 
 #include <cstdio>
 #include <cstring>
+#include <climits>
 
 // ─────────────────────────────────────────────────────────────────────────────
 // PWState — wewnętrzne dane PipeWire (zdefiniowane tylko gdy HAVE_PIPEWIRE)
@@ -125,6 +134,37 @@ static const pw_stream_events kStreamEvents = {
 
 #endif // HAVE_PIPEWIRE
 
+// ─────────────────────────────────────────────────────────────────────────────
+// encodeToFile — kodowanie + zapis zrzutu, wywoływane z puli wątków
+//
+// Nie dotyka żadnego stanu kompozytora.  Zwraca "" przy sukcesie albo opis
+// błędu.  fast = minimalna kompresja: PNG z quality 100 (zlib level 0),
+// JPG 85 zamiast 95; BMP/PPM i tak są nieskompresowane.
+// ─────────────────────────────────────────────────────────────────────────────
+namespace {
+
+    QString encodeToFile(const QImage&  frame,
+                         const QString& outPath,
+                         const QString& fmt,
+                         bool           fast) {
+        // Utwórz katalog jeśli nie istnieje
+        QDir().mkpath(QFileInfo(outPath).absolutePath());
+
+        QImageWriter writer(outPath);
+        writer.setFormat(fmt.toLocal8Bit());
+
+        if (fmt == "jpg" || fmt == "jpeg")
+            writer.setQuality(fast ? 85 : 95);
+        else if (fmt == "png" && fast)
+            writer.setQuality(100);     // dla PNG: 100 = brak kompresji zlib
+
+        if (!writer.write(frame))
+            return QString("zapis nieudany: %1").arg(writer.errorString());
+        return {};
+    }
+
+} // namespace
+
 // ─────────────────────────────────────────────────────────────────────────────
 // Konstruktor / destruktor
 // ─────────────────────────────────────────────────────────────────────────────
@@ -135,9 +175,27 @@ ScreencastManager::ScreencastManager(WMCompositor* compositor, QObject* parent)
 , m_pw(new PWState())
 {
     m_captureTimer = new QTimer(this);
+    m_captureTimer->setTimerType(Qt::PreciseTimer);
     connect(m_captureTimer, &QTimer::timeout,
             this, &ScreencastManager::onCaptureTick);
 
+    // Osobna pula — kodowanie PNG nie konkuruje z globalną pulą Qt
+    // (relayout, QtConcurrent w innych miejscach)
+    m_encodePool = new QThreadPool(this);
+    m_encodePool->setMaxThreadCount(qMax(1, QThread::idealThreadCount() / 2));
+
+    // Klatki zamkniętego okna nie trafią już do nikogo — także bazowe
+    // (bez scaleTo) i te po konsumencie, który jeszcze nie zdążył się wypisać
+    if (m_compositor) {
+        connect(m_compositor, &WMCompositor::windowRemoved, this, [this](Window* w) {
+            const uint64_t id = w->id();
+            for (auto it = m_lastFrames.begin(); it != m_lastFrames.end(); ) {
+                if (it.key().windowId == id) it = m_lastFrames.erase(it);
+                else                         ++it;
+            }
+        });
+    }
+
     #ifdef HAVE_PIPEWIRE
     m_pw->mgr = this;
     #endif
@@ -172,6 +230,8 @@ bool ScreencastManager::initialize() {
 void ScreencastManager::shutdown() {
     stopRecording();
     stopStream();
+    // Dokończ zapisy w toku — nie zostawiamy uciętych plików
+    m_encodePool->waitForDone();
     cleanupPipeWire();
 }
 
@@ -183,226 +243,517 @@ bool ScreencastManager::isAvailable() const {
 // Zrzut ekranu (screenshot)
 // ─────────────────────────────────────────────────────────────────────────────
 
-QString ScreencastManager::takeScreenshot(const QString& path,
-                                          const QRect&   region,
-                                          const QString& format) {
-    // Grabuj klatkę
-    const QImage frame = captureFrame(region);
+quint64 ScreencastManager::takeScreenshot(const QString&   path,
+                                          const QRect&     region,
+                                          const QString&   format,
+                                          ScreenshotEncode mode) {
+    const quint64 job = m_nextJobId++;
+
+    // Grab musi być na wątku GUI (kontekst GL) — reszta idzie do puli.
+    // Jeśli szyna ma świeżą klatkę tego regionu, nie robimy readbacku.
+    QImage frame = recentFrame(CaptureKey{region});
+    if (frame.isNull()) frame = captureFrame(region);
     if (frame.isNull()) {
-        const QString err = "nie można pobrać klatki z kompozytora";
-        qWarning() << "[Screenshot]" << err;
-        emit screenshotFailed(err);
-        return {};
+        failScreenshot(job, "nie można pobrać klatki z kompozytora");
+        return job;
+    }
+    submitEncode(job, frame, path, format, mode);
+    return job;
+}
+
+quint64 ScreencastManager::takeWindowScreenshot(const QString&   target,
+                                                const QString&   path,
+                                                bool             withDecorations,
+                                                const QString&   format,
+                                                ScreenshotEncode mode) {
+    const quint64 job = m_nextJobId++;
+
+    Window* w = findWindow(target);
+    if (!w) {
+        failScreenshot(job, QString("nie znaleziono okna: %1").arg(target));
+        return job;
+    }
+
+    const QImage frame = captureWindow(w, withDecorations);
+    if (frame.isNull()) {
+        failScreenshot(job, QString("okno %1 nie ma jeszcze bufora").arg(w->id()));
+        return job;
+    }
+    submitEncode(job, frame, path, format, mode);
+    return job;
+}
+
+QString ScreencastManager::screenshotPath(const QString& path, const QString& format) {
+    if (!path.isEmpty()) return path;
+    // Na wątku GUI — nazwa musi być unikalna także przy wielu zrzutach
+    // w tej samej sekundzie
+    const QString ext = format.isEmpty() ? QStringLiteral("png") : format.toLower();
+    return defaultScreenshotDir() + "/" + timestampedFilename(ext);
+}
+
+void ScreencastManager::failScreenshot(quint64 jobId, const QString& reason) {
+    qWarning() << "[Screenshot]" << reason;
+    // Zawsze asynchronicznie — wołający dostaje id zanim przyjdzie sygnał
+    QMetaObject::invokeMethod(this, [this, jobId, reason] {
+        emit screenshotFailed(jobId, reason);
+    }, Qt::QueuedConnection);
+}
+
+void ScreencastManager::submitEncode(quint64          jobId,
+                                     const QImage&    frame,
+                                     const QString&   path,
+                                     const QString&   format,
+                                     ScreenshotEncode mode) {
+    const QString fmt     = format.isEmpty() ? QStringLiteral("png") : format.toLower();
+    const QString outPath = screenshotPath(path, fmt);
+
+    ++m_pendingJobs;
+
+    // frame jest już odłączoną kopią (captureFrame / grabBuffer), więc
+    // worker może go trzymać bez synchronizacji.  Destruktor czeka na pulę,
+    // więc `this` żyje dłużej niż każde zadanie.
+    QtConcurrent::run(m_encodePool, [this, jobId, frame, outPath, fmt, mode] {
+        const QString err = encodeToFile(frame, outPath, fmt,
+                                         mode == ScreenshotEncode::Fast);
+        const QSize size = frame.size();
+        QMetaObject::invokeMethod(this, [this, jobId, outPath, err, size] {
+            finishEncode(jobId, outPath, err, size);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void ScreencastManager::finishEncode(quint64        jobId,
+                                     const QString& path,
+                                     const QString& error,
+                                     const QSize&   size) {
+    --m_pendingJobs;
+
+    if (!error.isEmpty()) {
+        qWarning() << "[Screenshot]" << error;
+        emit screenshotFailed(jobId, error);
+        return;
+    }
+
+    qInfo() << "[Screenshot] zapisano:" << path
+    << size.width() << "x" << size.height();
+    emit screenshotSaved(jobId, path);
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Nagrywanie do pliku (przez ffmpeg)
+// ─────────────────────────────────────────────────────────────────────────────
+
+bool ScreencastManager::startRecording(const QString& outputPath,
+                                       int            fps,
+                                       const QRect&   region) {
+    if (m_recording) {
+        qWarning() << "[Screencast] nagrywanie już trwa:" << m_recordingPath;
+        return false;
+    }
+
+    // Rozmiar znamy z ostatniej klatki szyny (np. trwa stream), inaczej
+    // grabujemy jedną klatkę testową
+    const CaptureKey key{region};
+    QImage probe = recentFrame(key);
+    if (probe.isNull()) probe = captureFrame(region);
+    if (probe.isNull()) {
+        qWarning() << "[Screencast] nie można pobrać klatki testowej";
+        return false;
     }
 
-    // Wyznacz ścieżkę docelową
-    QString outPath = path;
-    if (outPath.isEmpty()) {
-        const QString ext = format.isEmpty() ? "png" : format.toLower();
-        outPath = defaultScreenshotDir() + "/" + timestampedFilename(ext);
+    m_recordWindowId = 0;
+    return beginRecording(key, probe.size(), outputPath, fps);
+}
+
+bool ScreencastManager::startWindowRecording(const QString& target,
+                                             const QString& outputPath,
+                                             int            fps,
+                                             bool           withDecorations) {
+    if (m_recording) {
+        qWarning() << "[Screencast] nagrywanie już trwa:" << m_recordingPath;
+        return false;
+    }
+
+    Window* w = findWindow(target);
+    if (!w) {
+        qWarning() << "[Screencast] nie znaleziono okna:" << target;
+        return false;
+    }
+
+    const QImage probe = captureWindow(w, withDecorations);
+    if (probe.isNull()) {
+        qWarning() << "[Screencast] okno" << w->id() << "nie ma jeszcze bufora";
+        return false;
     }
 
-    // Utwórz katalog jeśli nie istnieje
+    // ffmpeg dostaje stały rozmiar -s WxH — scaleTo = rozmiar pierwszej
+    // klatki, więc po resize okna szyna robi letterbox
+    CaptureKey key;
+    key.windowId    = w->id();
+    key.decorations = withDecorations;
+    key.scaleTo     = probe.size();
+
+    m_recordWindowId = w->id();
+    return beginRecording(key, probe.size(), outputPath, fps);
+}
+
+bool ScreencastManager::beginRecording(const CaptureKey& key,
+                                       const QSize&      size,
+                                       const QString&    outputPath,
+                                       int               fps) {
+    // Wyznacz ścieżkę
+    QString outPath = outputPath;
+    if (outPath.isEmpty())
+        outPath = defaultScreenshotDir() + "/" + timestampedFilename("mp4");
+
     QDir().mkpath(QFileInfo(outPath).absolutePath());
 
-    // Zapisz
-    QImageWriter writer(outPath);
-    writer.setFormat(format.isEmpty() ? "png" : format.toLower().toLocal8Bit());
+    // Sprawdź czy ffmpeg jest dostępny
+    QProcess probe2;
+    probe2.start("ffmpeg", {"-version"});
+    probe2.waitForFinished(2000);
+    if (probe2.exitCode() != 0) {
+        qWarning() << "[Screencast] ffmpeg nie znaleziony w PATH";
+        qWarning() << "  Zainstaluj: sudo apt install ffmpeg";
+        m_recordWindowId = 0;
+        return false;
+    }
 
-    // Jakość dla JPG
-    if (format.toLower() == "jpg" || format.toLower() == "jpeg")
-        writer.setQuality(95);
+    // Uruchom ffmpeg
+    if (!startFFmpeg(outPath, size, fps)) {
+        m_recordWindowId = 0;
+        return false;
+    }
 
-    if (!writer.write(frame)) {
-        const QString err = QString("zapis nieudany: %1").arg(writer.errorString());
-        qWarning() << "[Screenshot]" << err;
-        emit screenshotFailed(err);
-        return {};
+    m_recordingPath  = outPath;
+    m_recording      = true;
+    m_frameCount     = 0;
+
+    // Konsument szyny — ta sama klatka może równocześnie iść do PipeWire
+    m_recordConsumer = addCaptureConsumer(key, fps, [this](const CapturedFrame& f) {
+        if (m_ffmpegProc && m_ffmpegProc->state() == QProcess::Running) {
+            sendFrameToFFmpeg(f.image);
+            ++m_frameCount;
+        }
+    });
+
+    qInfo() << "[Screencast] nagrywanie started:" << outPath
+    << fps << "fps" << size
+    << (m_recordWindowId ? QString("okno %1").arg(m_recordWindowId) : QString("output"));
+    emit recordingStarted(outPath);
+    return true;
+}
+
+void ScreencastManager::stopRecording() {
+    if (!m_recording) return;
+
+    removeCaptureConsumer(m_recordConsumer);
+    m_recordConsumer = 0;
+    stopFFmpeg();
+
+    m_recording = false;
+    const QString path = m_recordingPath;
+    m_recordingPath.clear();
+    m_frameCount     = 0;
+    m_recordWindowId = 0;
+
+    qInfo() << "[Screencast] nagrywanie stopped:" << path;
+    emit recordingStopped(path);
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// PipeWire stream (screen share)
+// ─────────────────────────────────────────────────────────────────────────────
+
+bool ScreencastManager::startStream(int fps) {
+    #ifdef HAVE_PIPEWIRE
+    if (m_streaming) return true;
+    if (!m_pwAvailable) {
+        qWarning() << "[Screencast] PipeWire niedostępny";
+        return false;
     }
 
-    qInfo() << "[Screenshot] zapisano:" << outPath
-    << frame.width() << "x" << frame.height();
-    emit screenshotSaved(outPath);
-    return outPath;
-                                          }
-
-                                          // ─────────────────────────────────────────────────────────────────────────────
-                                          // Nagrywanie do pliku (przez ffmpeg)
-                                          // ─────────────────────────────────────────────────────────────────────────────
-
-                                          bool ScreencastManager::startRecording(const QString& outputPath,
-                                                                                 int            fps,
-                                                                                 const QRect&   region) {
-                                              if (m_recording) {
-                                                  qWarning() << "[Screencast] nagrywanie już trwa:" << m_recordingPath;
-                                                  return false;
-                                              }
-
-                                              // Grabuj jedną klatkę żeby znać rozmiar
-                                              const QImage probe = captureFrame(region);
-                                              if (probe.isNull()) {
-                                                  qWarning() << "[Screencast] nie można pobrać klatki testowej";
-                                                  return false;
-                                              }
-
-                                              // Wyznacz ścieżkę
-                                              QString outPath = outputPath;
-                                              if (outPath.isEmpty())
-                                                  outPath = defaultScreenshotDir() + "/" + timestampedFilename("mp4");
-
-                                              QDir().mkpath(QFileInfo(outPath).absolutePath());
-
-                                              // Sprawdź czy ffmpeg jest dostępny
-                                              QProcess probe2;
-                                              probe2.start("ffmpeg", {"-version"});
-                                              probe2.waitForFinished(2000);
-                                              if (probe2.exitCode() != 0) {
-                                                  qWarning() << "[Screencast] ffmpeg nie znaleziony w PATH";
-                                                  qWarning() << "  Zainstaluj: sudo apt install ffmpeg";
-                                                  return false;
-                                              }
-
-                                              // Uruchom ffmpeg
-                                              if (!startFFmpeg(outPath, probe.size(), fps)) return false;
-
-                                              m_recordingPath  = outPath;
-                                              m_captureFps     = fps;
-                                              m_captureRegion  = region;
-                                              m_recording      = true;
-                                              m_frameCount     = 0;
-
-                                              // Timer nagrywania
-                                              m_captureTimer->setInterval(1000 / fps);
-                                              m_captureTimer->start();
-
-                                              qInfo() << "[Screencast] nagrywanie started:" << outPath
-                                              << fps << "fps" << probe.size();
-                                              emit recordingStarted(outPath);
-                                              return true;
-                                                                                 }
+    m_streamConsumer = addCaptureConsumer(CaptureKey{}, fps,
+                                          [this](const CapturedFrame& f) {
+        pushFrameToPipeWire(f.image);
+    });
 
-                                                                                 void ScreencastManager::stopRecording() {
-                                                                                     if (!m_recording) return;
+    m_streaming = true;
+    qInfo() << "[Screencast] PipeWire stream started, fps:" << fps;
+    return true;
+    #else
+    Q_UNUSED(fps);
+    qWarning() << "[Screencast] skompilowano bez PipeWire";
+    return false;
+    #endif
+}
 
-                                                                                     m_captureTimer->stop();
-                                                                                     stopFFmpeg();
+void ScreencastManager::stopStream() {
+    if (!m_streaming) return;
 
-                                                                                     m_recording = false;
-                                                                                     const QString path = m_recordingPath;
-                                                                                     m_recordingPath.clear();
-                                                                                     m_frameCount = 0;
+    removeCaptureConsumer(m_streamConsumer);
+    m_streamConsumer = 0;
+    m_streaming = false;
 
-                                                                                     qInfo() << "[Screencast] nagrywanie stopped:" << path;
-                                                                                     emit recordingStopped(path);
-                                                                                 }
+    #ifdef HAVE_PIPEWIRE
+    if (m_pw->stream) {
+        pw_stream_disconnect(m_pw->stream);
+    }
+    #endif
 
-                                                                                 // ─────────────────────────────────────────────────────────────────────────────
-                                                                                 // PipeWire stream (screen share)
-                                                                                 // ─────────────────────────────────────────────────────────────────────────────
+    emit streamStopped();
+    qInfo() << "[Screencast] PipeWire stream stopped";
+}
 
-                                                                                 bool ScreencastManager::startStream(int fps) {
-                                                                                     #ifdef HAVE_PIPEWIRE
-                                                                                     if (m_streaming) return true;
-                                                                                     if (!m_pwAvailable) {
-                                                                                         qWarning() << "[Screencast] PipeWire niedostępny";
-                                                                                         return false;
-                                                                                     }
+uint32_t ScreencastManager::pipeWireNodeId() const {
+    #ifdef HAVE_PIPEWIRE
+    return m_pw->nodeId;
+    #else
+    return 0;
+    #endif
+}
 
-                                                                                     m_captureFps = fps;
-                                                                                     m_captureTimer->setInterval(1000 / fps);
-                                                                                     m_captureTimer->start();
+// ─────────────────────────────────────────────────────────────────────────────
+// Szyna przechwytywania — rejestracja konsumentów
+// ─────────────────────────────────────────────────────────────────────────────
 
-                                                                                     m_streaming = true;
-                                                                                     qInfo() << "[Screencast] PipeWire stream started, fps:" << fps;
-                                                                                     return true;
-                                                                                     #else
-                                                                                     Q_UNUSED(fps);
-                                                                                     qWarning() << "[Screencast] skompilowano bez PipeWire";
-                                                                                     return false;
-                                                                                     #endif
-                                                                                 }
+int ScreencastManager::addCaptureConsumer(const CaptureKey& key, int fps,
+                                          FrameSink sink) {
+    const int id = m_nextConsumerId++;
 
-                                                                                 void ScreencastManager::stopStream() {
-                                                                                     if (!m_streaming) return;
+    CaptureConsumer c;
+    c.key        = key;
+    c.intervalMs = 1000 / qBound(1, fps, 240);
+    c.sink       = std::move(sink);
+    m_consumers.insert(id, std::move(c));
 
-                                                                                     m_captureTimer->stop();
-                                                                                     m_streaming = false;
+    if (!m_busClock.isValid()) m_busClock.start();
+    updateCaptureTimer();
+    return id;
+}
 
-                                                                                     #ifdef HAVE_PIPEWIRE
-                                                                                     if (m_pw->stream) {
-                                                                                         pw_stream_disconnect(m_pw->stream);
-                                                                                     }
-                                                                                     #endif
+void ScreencastManager::removeCaptureConsumer(int id) {
+    if (!m_consumers.remove(id)) return;
+
+    // Zapomnij klatki, których nikt już nie słucha.  Klatka bazowa
+    // skalowanego klucza zostaje, dopóki ktoś ten klucz jeszcze ma.
+    QSet<CaptureKey> live;
+    for (const auto& c : std::as_const(m_consumers)) {
+        live.insert(c.key);
+        CaptureKey base = c.key;
+        base.scaleTo    = {};
+        live.insert(base);
+    }
+    for (auto it = m_lastFrames.begin(); it != m_lastFrames.end(); ) {
+        if (live.contains(it.key())) ++it;
+        else                          it = m_lastFrames.erase(it);
+    }
+    updateCaptureTimer();
+}
 
-                                                                                     emit streamStopped();
-                                                                                     qInfo() << "[Screencast] PipeWire stream stopped";
-                                                                                 }
+void ScreencastManager::updateCaptureTimer() {
+    if (m_consumers.isEmpty()) {
+        m_captureTimer->stop();
+        return;
+    }
 
-                                                                                 uint32_t ScreencastManager::pipeWireNodeId() const {
-                                                                                     #ifdef HAVE_PIPEWIRE
-                                                                                     return m_pw->nodeId;
-                                                                                     #else
-                                                                                     return 0;
-                                                                                     #endif
-                                                                                 }
+    // Timer chodzi w tempie najszybszego konsumenta; wolniejsi są
+    // decymowani w onCaptureTick
+    int interval = INT_MAX;
+    for (const auto& c : std::as_const(m_consumers))
+        interval = qMin(interval, c.intervalMs);
 
-                                                                                 // ─────────────────────────────────────────────────────────────────────────────
-                                                                                 // Pętla przechwytywania
-                                                                                 // ─────────────────────────────────────────────────────────────────────────────
+    m_captureTimer->setInterval(interval);
+    if (!m_captureTimer->isActive()) m_captureTimer->start();
+}
+
+QImage ScreencastManager::recentFrame(const CaptureKey& key) const {
+    // Klatka z szyny jest "świeża" jeśli nie jest starsza niż jeden tick —
+    // zrzut ekranu w trakcie nagrywania nie robi wtedy drugiego readbacku
+    auto it = m_lastFrames.constFind(key);
+    if (it == m_lastFrames.constEnd() || !m_captureTimer->isActive()) return {};
+    if (m_busClock.elapsed() - it->timestampMs > m_captureTimer->interval()) return {};
+    return it->image;
+}
 
-                                                                                 void ScreencastManager::onCaptureTick() {
-                                                                                     const QImage frame = captureFrame(m_captureRegion);
-                                                                                     if (frame.isNull()) return;
+// ─────────────────────────────────────────────────────────────────────────────
+// Pętla przechwytywania
+// ─────────────────────────────────────────────────────────────────────────────
 
-                                                                                     // Nagrywanie → ffmpeg
-                                                                                     if (m_recording && m_ffmpegProc &&
-                                                                                         m_ffmpegProc->state() == QProcess::Running) {
-                                                                                         sendFrameToFFmpeg(frame);
-                                                                                     ++m_frameCount;
-                                                                                         }
+void ScreencastManager::onCaptureTick() {
+    const qint64 now = m_busClock.elapsed();
+    // Pół ticku tolerancji — timer Qt nie jest idealnie równy
+    const qint64 slack = m_captureTimer->interval() / 2;
+    ++m_tickSeq;
 
-                                                                                         // Screen share → PipeWire
-                                                                                         if (m_streaming) {
-                                                                                             pushFrameToPipeWire(frame);
-                                                                                         }
+    QHash<CaptureKey, CapturedFrame> tickFrames;
+    QImage output;      // readback outputu, co najwyżej raz na tick
 
-                                                                                         // Emituj podgląd (np. do thumbnail w barze)
-                                                                                         emit frameReady(frame);
-                                                                                 }
+    // Najpierw produkcja, potem dostarczenie — sink może usunąć konsumenta
+    // (np. stopRecording), więc nie iterujemy po m_consumers w trakcie
+    struct Delivery { FrameSink sink; CapturedFrame frame; };
+    QList<Delivery> deliveries;
 
-                                                                                 // ─────────────────────────────────────────────────────────────────────────────
-                                                                                 // captureFrame — grab z QOpenGLWidget
-                                                                                 // ─────────────────────────────────────────────────────────────────────────────
+    for (auto it = m_consumers.begin(); it != m_consumers.end(); ++it) {
+        CaptureConsumer& c = it.value();
+        if (c.lastMs >= 0 && now - c.lastMs + slack < c.intervalMs) continue;
 
-                                                                                 QImage ScreencastManager::captureFrame(const QRect& region) {
-                                                                                     // Pobierz output (QOpenGLWidget) z kompozytora
-                                                                                     WMOutput* output = m_compositor->primaryOutput();
-                                                                                     if (!output) {
-                                                                                         qWarning() << "[Screencast] brak primaryOutput";
-                                                                                         return {};
-                                                                                     }
+        const CapturedFrame f = produceFrame(c.key, now, tickFrames, output);
+        if (f.image.isNull()) continue;
 
-                                                                                     // grabFramebuffer() — najszybszy sposób, działa na QOpenGLWidget
-                                                                                     // Zwraca QImage w formacie ARGB32 z bieżącej klatki GL
-                                                                                     QImage frame = output->grabFramebuffer();
-                                                                                     if (frame.isNull()) {
-                                                                                         // Fallback: render przez QScreen
-                                                                                         if (QScreen* scr = output->screen()) {
-                                                                                             frame = scr->grabWindow(0).toImage();
-                                                                                         }
-                                                                                     }
-                                                                                     if (frame.isNull()) return {};
+        c.lastMs = now;
+        deliveries.append({c.sink, f});
+    }
 
-                                                                                     // Przytnij do regionu jeśli podany
-                                                                                     if (!region.isEmpty() && region != QRect(0,0,frame.width(),frame.height())) {
-                                                                                         const QRect clipped = region.intersected(frame.rect());
-                                                                                         if (!clipped.isEmpty())
-                                                                                             frame = frame.copy(clipped);
-                                                                                     }
+    for (auto it = tickFrames.constBegin(); it != tickFrames.constEnd(); ++it)
+        m_lastFrames.insert(it.key(), it.value());
 
-                                                                                     // Konwertuj do RGB32 (bez alpha) — ffmpeg i PipeWire preferują
-                                                                                     return frame.convertToFormat(QImage::Format_RGB32);
-                                                                                 }
+    for (const Delivery& d : std::as_const(deliveries)) {
+        d.sink(d.frame);
+        ++m_deliveries;
+    }
+
+    // Emituj podgląd (np. do thumbnail w barze)
+    if (!deliveries.isEmpty())
+        emit frameReady(deliveries.first().frame.image);
+}
+
+CapturedFrame ScreencastManager::produceFrame(const CaptureKey& key, qint64 now,
+                                              QHash<CaptureKey, CapturedFrame>& tickFrames,
+                                              QImage& output) {
+    auto hit = tickFrames.constFind(key);
+    if (hit != tickFrames.constEnd()) return hit.value();
+
+    CapturedFrame f;
+    f.timestampMs = now;
+    f.sequence    = m_tickSeq;
+
+    if (!key.scaleTo.isEmpty()) {
+        // Skalowana wersja powstaje z klatki bazowej tego samego źródła
+        CaptureKey base = key;
+        base.scaleTo    = {};
+        const CapturedFrame src = produceFrame(base, now, tickFrames, output);
+        if (src.image.isNull()) return {};
+        f.image = fitInto(src.image, key.scaleTo);
+    } else if (key.windowId) {
+        Window* w = findWindow(QString::number(key.windowId));
+        if (!w) {
+            // Okno zamknięte — kończymy nagrywanie zamiast wysyłać puste klatki
+            if (m_recording && m_recordWindowId == key.windowId) {
+                qInfo() << "[Screencast] okno" << key.windowId
+                << "zniknęło — zatrzymuję nagrywanie";
+                QTimer::singleShot(0, this, &ScreencastManager::stopRecording);
+            }
+            return {};
+        }
+        f.image = captureWindow(w, key.decorations);
+        ++m_readbacks;
+    } else {
+        if (output.isNull()) {
+            output = grabOutput();
+            if (output.isNull()) return {};
+            ++m_readbacks;
+        }
+        const QRect full = output.rect();
+        const QRect clipped = key.region.isEmpty() ? full : key.region.intersected(full);
+        // copy() na całym obrazie byłby zbędną kopią — dzielimy bufor
+        f.image = (clipped.isEmpty() || clipped == full) ? output : output.copy(clipped);
+    }
+
+    if (f.image.isNull()) return {};
+    tickFrames.insert(key, f);
+    return f;
+}
+
+QImage ScreencastManager::fitInto(const QImage& img, const QSize& size) {
+    if (img.size() == size) return img;
+
+    // Proporcjonalnie w czarne tło (letterbox)
+    QImage canvas(size, QImage::Format_RGB32);
+    canvas.fill(Qt::black);
+    const QImage scaled = img.scaled(size, Qt::KeepAspectRatio,
+                                     Qt::SmoothTransformation);
+    QPainter p(&canvas);
+    p.drawImage((size.width()  - scaled.width())  / 2,
+                (size.height() - scaled.height()) / 2, scaled);
+    p.end();
+    return canvas;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// captureFrame — grab z QOpenGLWidget
+// ─────────────────────────────────────────────────────────────────────────────
+
+QImage ScreencastManager::grabOutput() {
+    // Pobierz output (QOpenGLWidget) z kompozytora
+    WMOutput* output = m_compositor->primaryOutput();
+    if (!output) {
+        qWarning() << "[Screencast] brak primaryOutput";
+        return {};
+    }
+
+    // grabFramebuffer() — najszybszy sposób, działa na QOpenGLWidget
+    // Zwraca QImage w formacie ARGB32 z bieżącej klatki GL
+    QImage frame = output->grabFramebuffer();
+    if (frame.isNull()) {
+        // Fallback: render przez QScreen
+        if (QScreen* scr = output->screen()) {
+            frame = scr->grabWindow(0).toImage();
+        }
+    }
+    if (frame.isNull()) return {};
+
+    // Konwertuj do RGB32 (bez alpha) — ffmpeg i PipeWire preferują
+    return frame.convertToFormat(QImage::Format_RGB32);
+}
+
+QImage ScreencastManager::captureFrame(const QRect& region) {
+    QImage frame = grabOutput();
+    if (frame.isNull()) return {};
+
+    // Przytnij do regionu jeśli podany
+    if (!region.isEmpty() && region != frame.rect()) {
+        const QRect clipped = region.intersected(frame.rect());
+        if (!clipped.isEmpty())
+            frame = frame.copy(clipped);
+    }
+    return frame;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// captureWindow — bufor jednego okna, bez grabowania całego outputu
+// ─────────────────────────────────────────────────────────────────────────────
+
+QImage ScreencastManager::captureWindow(Window* w, bool withDecorations) {
+    WMOutput* output = m_compositor->primaryOutput();
+    if (!w || !output) return {};
+
+    const QImage img = output->grabWindow(w, withDecorations);
+    if (img.isNull()) return {};
+
+    // Screenshot z dekoracjami zachowuje przezroczyste rogi (PNG);
+    // sama zawartość klienta idzie jako RGB32 jak klatki outputu.
+    return withDecorations
+    ? img.convertToFormat(QImage::Format_ARGB32)
+    : img.convertToFormat(QImage::Format_RGB32);
+}
+
+Window* ScreencastManager::findWindow(const QString& target) const {
+    if (target.isEmpty()) return nullptr;
+
+    // Liczba → Window::id, w przeciwnym razie app_id (bez rozróżniania
+    // wielkości liter).  allWindows() obejmuje wszystkie workspace'y.
+    bool isId = false;
+    const qulonglong id = target.toULongLong(&isId);
+
+    const QList<Window*> wins = m_compositor->allWindows();
+    for (Window* w : wins) {
+        if (isId ? w->id() == id
+                 : w->appId().compare(target, Qt::CaseInsensitive) == 0)
+            return w;
+    }
+    return nullptr;
+}
 
                                                                                  // ─────────────────────────────────────────────────────────────────────────────
                                                                                  // PipeWire init / cleanup
@@ -637,7 +988,10 @@ QString ScreencastManager::takeScreenshot(const QString& path,
                                                                                                                      }
 
                                                                                                                      QString ScreencastManager::timestampedFilename(const QString& ext) {
+                                                                                                                         // Milisekundy nie wystarczą — skrypt w trybie Fast robi kilka zrzutów
+                                                                                                                         // w tej samej ms.  Licznik procesu rozróżnia je (wątek GUI).
+                                                                                                                         static quint64 seq = 0;
                                                                                                                          const QString ts = QDateTime::currentDateTime()
-                                                                                                                         .toString("yyyy-MM-dd_hh-mm-ss");
-                                                                                                                         return QString("screenshot-%1.%2").arg(ts).arg(ext);
+                                                                                                                         .toString("yyyy-MM-dd_hh-mm-ss-zzz");
+                                                                                                                         return QString("screenshot-%1-%2.%3").arg(ts).arg(++seq).arg(ext);
                                                                                                                      }
@@ -7,10 +7,14 @@
 #include <QTimer>
 #include <QImage>
 #include <QProcess>
+#include <QHash>
+#include <QElapsedTimer>
 #include <functional>
 
 class WMCompositor;
 class WMOutput;
+class Window;
+class QThreadPool;
 
 // ─────────────────────────────────────────────────────────────────────────────
 // ScreencastSession — jedna sesja nagrywania / udostępniania ekranu
@@ -23,6 +27,43 @@ struct ScreencastSession {
     int         fps      = 30;
 };
 
+// ─────────────────────────────────────────────────────────────────────────────
+// CaptureKey — źródło klatki na szynie przechwytywania
+//
+// Region outputu albo bufor okna, plus opcjonalny docelowy rozmiar.
+// Konsumenci z tym samym kluczem dzielą jeden readback na tick; klucze
+// różniące się tylko scaleTo dzielą readback i skalowanie jest robione
+// raz na rozmiar.
+// ─────────────────────────────────────────────────────────────────────────────
+struct CaptureKey {
+    QRect    region;                // pusty = cały output
+    uint64_t windowId    = 0;       // != 0 → bufor okna zamiast outputu
+    bool     decorations = false;   // tylko dla windowId
+    QSize    scaleTo;               // pusty = natywny rozmiar (letterbox gdy != )
+
+    bool operator==(const CaptureKey&) const = default;
+};
+
+inline size_t qHash(const CaptureKey& k, size_t seed = 0) {
+    return qHashMulti(seed, k.region.x(), k.region.y(),
+                      k.region.width(), k.region.height(),
+                      k.windowId, k.decorations,
+                      k.scaleTo.width(), k.scaleTo.height());
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// CapturedFrame — jedna klatka współdzielona przez wszystkich konsumentów
+//
+// QImage jest implicit-shared z licznikiem referencji, więc przekazanie do
+// ffmpeg, PipeWire i podglądu nie kopiuje pikseli.  Konsumenci dostają
+// const& i traktują obraz jako niezmienny.
+// ─────────────────────────────────────────────────────────────────────────────
+struct CapturedFrame {
+    QImage   image;
+    qint64   timestampMs = 0;       // zegar szyny (m_busClock)
+    quint64  sequence    = 0;       // numer ticku, w którym powstała
+};
+
 // ─────────────────────────────────────────────────────────────────────────────
 // ScreencastManager
 //
@@ -36,6 +77,10 @@ struct ScreencastSession {
 //   1. DBus: nasłuchuje na org.freedesktop.portal.ScreenCast
 //   2. PipeWire: tworzy węzeł video/source i pushuje klatki
 //   3. Klatki: grabowane z QOpenGLWidget::grabFramebuffer()
+//   4. Szyna przechwytywania: nagrywanie, stream i inni konsumenci
+//      rejestrują się z własnym CaptureKey i fps; na tick output jest
+//      czytany z GPU co najwyżej raz, a klatka trafia do wszystkich
+//      należnych konsumentów
 //
 // Kompilacja:
 //   Wymaga libpipewire-0.3-dev — jeśli nieobecne, cała klasa to stub.
@@ -55,17 +100,53 @@ public:
     bool isAvailable() const;   // true jeśli PipeWire działa
 
     // ── Zrzut ekranu ──────────────────────────────────────────────────────
-    // Zapisuje PNG/JPG do podanej ścieżki.
-    // Jeśli path jest pusty — zapisuje do ~/Zrzuty ekranu/screenshot-TIMESTAMP.png
-    // Zwraca ścieżkę do pliku lub "" przy błędzie.
-    QString takeScreenshot(const QString& path     = {},
-                           const QRect&   region   = {},
-                           const QString& format   = "png");
+    // Tryb kodowania zrzutu:
+    //   Default — PNG/JPG z normalną kompresją
+    //   Fast    — minimalna kompresja (PNG zlib 0, BMP/PPM bez zmian),
+    //             dla skryptów robiących dużo zrzutów pod rząd
+    enum class ScreenshotEncode { Default, Fast };
+
+    // Grab odbywa się od razu na wątku GUI, kodowanie i zapis na puli
+    // wątków — funkcja wraca natychmiast z id zadania.  Wynik przychodzi
+    // przez screenshotSaved / screenshotFailed z tym samym id.
+    // Jeśli path jest pusty — zapisuje do ~/Obrazy/screenshot-TIMESTAMP.png
+    quint64 takeScreenshot(const QString&   path     = {},
+                           const QRect&     region   = {},
+                           const QString&   format   = "png",
+                           ScreenshotEncode mode     = ScreenshotEncode::Default);
+
+    // ── Zrzut pojedynczego okna ───────────────────────────────────────────
+    // target: id okna (Window::id) albo app_id, np. "firefox".
+    // Czyta bufor klienta bezpośrednio — działa dla okien zasłoniętych
+    // i na innych workspace'ach.  withDecorations dorysowuje ramkę i pasek
+    // tytułu w prywatnym FBO.
+    quint64 takeWindowScreenshot(const QString&   target,
+                                 const QString&   path            = {},
+                                 bool             withDecorations = false,
+                                 const QString&   format          = "png",
+                                 ScreenshotEncode mode            = ScreenshotEncode::Default);
+
+    // Okno po id (Window::id) albo app_id — jak target powyżej
+    Window* findWindow(const QString& target) const;
+
+    // Ścieżka, pod którą trafi zrzut: path, a gdy pusty — nowa nazwa
+    // w domyślnym katalogu.  Wołający (IPC) może ją podać od razu, zanim
+    // przyjdzie screenshotSaved.
+    static QString screenshotPath(const QString& path, const QString& format = "png");
+
+    // Liczba zrzutów w trakcie kodowania / zapisu
+    int pendingScreenshots() const { return m_pendingJobs; }
 
     // ── Nagrywanie do pliku ────────────────────────────────────────────────
     bool startRecording(const QString& outputPath = {},
                         int            fps        = 30,
                         const QRect&   region     = {});
+    // Nagrywanie jednego okna — rozmiar wideo ustalany z pierwszej klatki,
+    // kolejne klatki są skalowane (letterbox) gdy okno zmieni rozmiar.
+    bool startWindowRecording(const QString& target,
+                              const QString& outputPath      = {},
+                              int            fps             = 30,
+                              bool           withDecorations = false);
     void stopRecording();
     bool isRecording() const { return m_recording; }
     QString recordingPath() const { return m_recordingPath; }
@@ -76,14 +157,26 @@ public:
     bool  isStreaming()  const { return m_streaming; }
     uint32_t pipeWireNodeId() const;
 
+    // ── Szyna przechwytywania ─────────────────────────────────────────────
+    // Rejestruje konsumenta klatek.  fps to górny limit — konsument dostaje
+    // klatkę tylko w tickach, w których minął jego interwał.  Zwraca id
+    // do removeCaptureConsumer().  sink jest wołany na wątku GUI.
+    using FrameSink = std::function<void(const CapturedFrame&)>;
+    int   addCaptureConsumer(const CaptureKey& key, int fps, FrameSink sink);
+    void  removeCaptureConsumer(int id);
+
+    // Statystyki: ile readbacków z GPU vs ile klatek dostarczono
+    quint64 readbackCount()  const { return m_readbacks;  }
+    quint64 deliveryCount()  const { return m_deliveries; }
+
 signals:
-    void screenshotSaved  (const QString& path);
-    void screenshotFailed (const QString& reason);
+    void screenshotSaved  (quint64 jobId, const QString& path);
+    void screenshotFailed (quint64 jobId, const QString& reason);
     void recordingStarted (const QString& path);
     void recordingStopped (const QString& path);
     void streamStarted    (uint32_t nodeId);
     void streamStopped    ();
-    void frameReady       (const QImage& frame);  // dla podglądu
+    void frameReady       (const QImage& frame);  // dla podglądu — pierwsza klatka ticku
 
 private slots:
     void onCaptureTick();
@@ -91,6 +184,28 @@ private slots:
 private:
     // ── Frame capture ──────────────────────────────────────────────────────
     QImage captureFrame(const QRect& region = {});
+    QImage captureWindow(Window* w, bool withDecorations);
+    QImage grabOutput();                // pełny framebuffer, bez przycinania
+
+    // ── Szyna — produkcja klatek ───────────────────────────────────────────
+    // Zwraca klatkę dla klucza w bieżącym ticku; readback outputu i klatki
+    // bazowe (bez skalowania) są zapamiętane w tickFrames / output.
+    CapturedFrame produceFrame(const CaptureKey& key, qint64 now,
+                               QHash<CaptureKey, CapturedFrame>& tickFrames,
+                               QImage& output);
+    QImage recentFrame(const CaptureKey& key) const;
+    void   updateCaptureTimer();
+    static QImage fitInto(const QImage& img, const QSize& size);
+
+    // ── Wspólne ścieżki zapisu / startu nagrywania ────────────────────────
+    void    submitEncode(quint64 jobId, const QImage& frame,
+                         const QString& path, const QString& format,
+                         ScreenshotEncode mode);
+    void    finishEncode(quint64 jobId, const QString& path,
+                         const QString& error, const QSize& size);
+    void    failScreenshot(quint64 jobId, const QString& reason);
+    bool    beginRecording(const CaptureKey& key, const QSize& size,
+                           const QString& outputPath, int fps);
 
     // ── PipeWire helpers ───────────────────────────────────────────────────
     bool  initPipeWire();
@@ -109,20 +224,39 @@ private:
     // ── Members ───────────────────────────────────────────────────────────
     WMCompositor* m_compositor  = nullptr;
 
-    // Capture timer
-    QTimer*       m_captureTimer= nullptr;
-    QRect         m_captureRegion;
-    int           m_captureFps  = 30;
+    // Capture bus
+    struct CaptureConsumer {
+        CaptureKey key;
+        int        intervalMs = 33;
+        qint64     lastMs     = -1;     // -1 = jeszcze nic nie dostał
+        FrameSink  sink;
+    };
+    QTimer*       m_captureTimer  = nullptr;
+    QElapsedTimer m_busClock;
+    QHash<int, CaptureConsumer>       m_consumers;
+    QHash<CaptureKey, CapturedFrame>  m_lastFrames;   // ostatnia klatka per klucz
+    int           m_nextConsumerId = 1;
+    quint64       m_tickSeq        = 0;
+    quint64       m_readbacks      = 0;
+    quint64       m_deliveries     = 0;
+
+    // Screenshot encoding (pula wątków, wyniki wracają na wątek GUI)
+    QThreadPool*  m_encodePool    = nullptr;
+    quint64       m_nextJobId     = 1;
+    int           m_pendingJobs   = 0;
 
     // Recording state
     bool          m_recording     = false;
     QString       m_recordingPath;
     QProcess*     m_ffmpegProc    = nullptr;
     int           m_frameCount    = 0;
+    int           m_recordConsumer = 0;
+    uint64_t      m_recordWindowId = 0;     // 0 = nagrywamy output
 
     // PipeWire stream state
     bool          m_streaming     = false;
     bool          m_pwAvailable   = false;
+    int           m_streamConsumer = 0;
 
     // PipeWire opaque pointers (defined only when HAVE_PIPEWIRE)
     struct PWState;
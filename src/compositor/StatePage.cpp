@@ -0,0 +1,141 @@
+#include "StatePage.h"
+#include "StateTree.h"
+#include "WMCompositor.h"
+#include "core/Window.h"
+#include "core/Workspace.h"
+
+#include <QCoreApplication>
+#include <QTimer>
+#include <QDebug>
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace {
+
+    /// NUL-terminated UTF-8 in \p cap bytes, cut on a character boundary.
+    void copyUtf8(char* dst, size_t cap, const QString& s) {
+        const QByteArray u = s.toUtf8();
+        size_t n = qMin(size_t(u.size()), cap - 1);
+        while (n > 0 && n < size_t(u.size()) && (u[n] & 0xC0) == 0x80) --n;
+        std::memcpy(dst, u.constData(), n);
+        dst[n] = '\0';
+    }
+
+} // namespace
+
+StatePage::StatePage(WMCompositor* compositor, StateTree* tree, QObject* parent)
+: QObject(parent), m_compositor(compositor), m_tree(tree)
+{
+    m_fd = memfd_create("hackerlandwm-state", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (m_fd < 0) {
+        qWarning() << "[StatePage] memfd_create failed:" << strerror(errno);
+        return;
+    }
+    if (ftruncate(m_fd, HLWM_STATE_SIZE) < 0) {
+        qWarning() << "[StatePage] ftruncate failed:" << strerror(errno);
+        close(m_fd);
+        m_fd = -1;
+        return;
+    }
+    fcntl(m_fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL);
+
+    void* p = mmap(nullptr, HLWM_STATE_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+    if (p == MAP_FAILED) {
+        qWarning() << "[StatePage] mmap failed:" << strerror(errno);
+        close(m_fd);
+        m_fd = -1;
+        return;
+    }
+    m_page    = static_cast<hlwm_state_page*>(p);
+    m_staging = std::make_unique<hlwm_state_page>();
+
+    // Pages fresh from ftruncate are zero — seq 0, even: nothing to read yet
+    m_page->magic   = HLWM_STATE_MAGIC;
+    m_page->version = HLWM_STATE_VERSION;
+    m_page->size    = HLWM_STATE_SIZE;
+
+    connect(m_tree, &StateTree::changed, this, &StatePage::schedule);
+    publish();
+
+    // Inherited by everything launchApp() starts
+    qputenv("HACKERLANDWM_STATE", path().toLocal8Bit());
+    qInfo() << "[StatePage] state page at" << path();
+}
+
+StatePage::~StatePage() {
+    if (m_page) munmap(m_page, HLWM_STATE_SIZE);
+    if (m_fd >= 0) close(m_fd);
+}
+
+QString StatePage::path() const {
+    if (m_fd < 0) return {};
+    return QString("/proc/%1/fd/%2").arg(QCoreApplication::applicationPid()).arg(m_fd);
+}
+
+void StatePage::schedule() {
+    if (m_scheduled) return;
+    m_scheduled = true;
+    QTimer::singleShot(0, this, &StatePage::publish);
+}
+
+void StatePage::publish() {
+    m_scheduled = false;
+    if (!m_page) return;
+
+    // ── Build the snapshot off to the side ────────────────────────────────
+    hlwm_state_page& s = *m_staging;
+    s.generation       = m_tree->generation();
+    s.active_workspace = m_compositor->activeWorkspaceId();
+    s.workspace_count  = m_compositor->workspaceCount();
+
+    timespec ts{};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    s.update_ns = quint64(ts.tv_sec) * 1000000000ULL + quint64(ts.tv_nsec);
+
+    const Window* focused = m_compositor->activeWindow();
+    s.focused_window = focused ? focused->id() : 0;
+    copyUtf8(s.focused_title, sizeof s.focused_title, focused ? focused->title() : QString());
+
+    quint32 n = 0, total = 0;
+    for (int id = 1; id <= m_compositor->workspaceCount(); ++id) {
+        const auto* ws = m_compositor->workspace(id);
+        if (!ws) continue;
+        for (const auto* w : ws->windows()) {
+            ++total;
+            if (n == HLWM_STATE_MAX_WINDOWS) continue;
+            hlwm_state_window& e = s.windows[n++];
+            const QRect g = w->geometry();
+            e.id        = w->id();
+            e.workspace = w->workspaceId();
+            e.flags     = (w->isActive()     ? HLWM_WINDOW_FOCUSED    : 0u)
+                        | (w->isVisible()    ? HLWM_WINDOW_VISIBLE    : 0u)
+                        | (w->isFloating()   ? HLWM_WINDOW_FLOATING   : 0u)
+                        | (w->isFullscreen() ? HLWM_WINDOW_FULLSCREEN : 0u)
+                        | (w->isMaximized()  ? HLWM_WINDOW_MAXIMIZED  : 0u);
+            e.x = g.x(); e.y = g.y(); e.width = g.width(); e.height = g.height();
+            copyUtf8(e.app_id, sizeof e.app_id, w->appId());
+            copyUtf8(e.title,  sizeof e.title,  w->title());
+        }
+    }
+    s.window_count  = n;
+    s.total_windows = total;
+
+    // ── Seqlock write: odd, copy, even ────────────────────────────────────
+    // Everything after the seqlock counter up to the windows in use
+    constexpr size_t kFirst = offsetof(hlwm_state_page, generation);
+    const size_t     bytes  = offsetof(hlwm_state_page, windows) - kFirst
+                            + n * sizeof(hlwm_state_window);
+
+    const quint64 seq = m_page->seq;
+    __atomic_store_n(&m_page->seq, seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    std::memcpy(reinterpret_cast<char*>(m_page) + kFirst,
+                reinterpret_cast<const char*>(&s) + kFirst, bytes);
+    __atomic_store_n(&m_page->seq, seq + 2, __ATOMIC_RELEASE);
+    ++m_writes;
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <QObject>
+#include <QString>
+#include <memory>
+
+#include "hackerlandwm-state.h"
+
+class WMCompositor;
+class StateTree;
+
+// ─────────────────────────────────────────────────────────────────────────────
+// StatePage — compositor state in shared memory, for readers that poll
+//
+// A memfd holding one struct hlwm_state_page (src/hackerlandwm-state.h,
+// installed for clients): active workspace, focused window, window list.
+// Rewritten whenever the StateTree generation moves — coalesced to once per
+// event-loop turn — under a seqlock, so readers mapping it read-only get a
+// consistent snapshot without a syscall.  The snapshot is built off to the
+// side and copied in, keeping the odd (writing) window to one memcpy.
+//
+// Advertised as /proc/<pid>/fd/<n>: in $HACKERLANDWM_STATE for everything
+// the compositor launches, and via the `state_page` IPC query.  The memfd is
+// sealed against resizing, so a mapping can never be cut short under a
+// reader.
+// ─────────────────────────────────────────────────────────────────────────────
+class StatePage : public QObject {
+    Q_OBJECT
+public:
+    StatePage(WMCompositor* compositor, StateTree* tree, QObject* parent = nullptr);
+    ~StatePage() override;
+
+    bool    isValid() const { return m_page != nullptr; }
+    QString path()    const;
+    quint64 writes()  const { return m_writes; }
+
+private:
+    void schedule();
+    void publish();
+
+    WMCompositor*                    m_compositor = nullptr;
+    StateTree*                       m_tree       = nullptr;
+    int                              m_fd         = -1;
+    hlwm_state_page*                 m_page       = nullptr;   ///< The shared mapping
+    std::unique_ptr<hlwm_state_page> m_staging;                ///< Built here, then copied in
+    bool                             m_scheduled  = false;
+    quint64                          m_writes     = 0;
+};
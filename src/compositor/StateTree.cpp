@@ -0,0 +1,195 @@
+#include "StateTree.h"
+#include "WMCompositor.h"
+#include "WMOutput.h"
+#include "core/TilingEngine.h"
+#include "core/Window.h"
+#include "core/Workspace.h"
+
+#include <QGuiApplication>
+#include <QJsonArray>
+#include <QScreen>
+
+StateTree::StateTree(WMCompositor* compositor, QObject* parent)
+: QObject(parent), m_compositor(compositor)
+{
+    m_focusedWs = m_compositor->activeWorkspaceId();
+
+    for (int id = 1; id <= m_compositor->workspaceCount(); ++id)
+        if (auto* ws = m_compositor->workspace(id)) watchWorkspace(ws);
+    for (auto* w : m_compositor->allWindows())
+        watchWindow(w);
+
+    connect(m_compositor, &WMCompositor::windowAdded, this, [this](Window* w) {
+        watchWindow(w);
+        touchWindow(w);
+    });
+    connect(m_compositor, &WMCompositor::windowRemoved, this, [this](Window* w) {
+        // Signals from here until deleteLater() lands are no news
+        w->disconnect(this);
+        m_windowGen.remove(w);
+        if (m_removed.size() == kMaxRemoved)
+            m_removedFloor = m_removed.takeFirst().generation;
+        m_removed.append({ w->id(), bump() });
+    });
+
+    // "focused" flips on both workspaces
+    connect(m_compositor, &WMCompositor::activeWorkspaceChanged, this, [this](int id) {
+        touchWorkspace(m_focusedWs);
+        touchWorkspace(id);
+        m_focusedWs = id;
+    });
+
+    auto watchScreen = [this](QScreen* screen) {
+        connect(screen, &QScreen::geometryChanged, this, [this] { m_outputGen = bump(); });
+    };
+    for (auto* screen : QGuiApplication::screens()) watchScreen(screen);
+
+    // Hotplug: a new screen can become primary, and an unplugged one may
+    // have been the one reported
+    connect(qGuiApp, &QGuiApplication::screenAdded, this, [this, watchScreen](QScreen* screen) {
+        watchScreen(screen);
+        m_outputGen = bump();
+    });
+    connect(qGuiApp, &QGuiApplication::screenRemoved, this, [this] { m_outputGen = bump(); });
+}
+
+quint64 StateTree::bump() {
+    ++m_generation;
+    emit changed(m_generation);
+    return m_generation;
+}
+
+void StateTree::watchWindow(Window* w) {
+    auto touch = [this, w] { touchWindow(w); };
+    connect(w, &Window::titleChanged,      this, touch);
+    connect(w, &Window::geometryChanged,   this, touch);
+    connect(w, &Window::stateChanged,      this, touch);
+    connect(w, &Window::activeChanged,     this, touch);
+    connect(w, &Window::visibilityChanged, this, touch);
+    connect(w, &Window::workspaceChanged,  this, touch);
+}
+
+void StateTree::watchWorkspace(Workspace* ws) {
+    const int id = ws->id();
+    auto touch = [this, id] { touchWorkspace(id); };
+    connect(ws, &Workspace::windowAdded,         this, touch);
+    connect(ws, &Workspace::windowRemoved,       this, touch);
+    connect(ws, &Workspace::activeWindowChanged, this, touch);
+    connect(ws, &Workspace::layoutChanged,       this, touch);
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Serialisation
+// ─────────────────────────────────────────────────────────────────────────────
+
+const char* StateTree::stateName(WindowState s) {
+    switch (s) {
+        case WindowState::Normal:     return "normal";
+        case WindowState::Maximized:  return "maximized";
+        case WindowState::Fullscreen: return "fullscreen";
+        case WindowState::Minimized:  return "minimized";
+        case WindowState::Floating:   return "floating";
+        case WindowState::Tiled:      return "tiled";
+        case WindowState::Monocle:    return "monocle";
+    }
+    return "normal";
+}
+
+QJsonObject StateTree::windowJson(const Window* w) {
+    const QRect g = w->geometry();
+    QJsonObject geom;
+    geom["x"]      = g.x();
+    geom["y"]      = g.y();
+    geom["width"]  = g.width();
+    geom["height"] = g.height();
+
+    QJsonObject o;
+    o["id"]        = qint64(w->id());
+    o["title"]     = w->title();
+    o["app_id"]    = w->appId();
+    o["workspace"] = w->workspaceId();
+    o["state"]     = stateName(w->state());
+    o["focused"]   = w->isActive();
+    o["visible"]   = w->isVisible();
+    o["geometry"]  = geom;
+    return o;
+}
+
+QJsonObject StateTree::outputJson(const QScreen* screen) {
+    const QRect g = screen->geometry();
+    QJsonObject o;
+    o["name"]    = screen->name();
+    o["x"]       = g.x();
+    o["y"]       = g.y();
+    o["width"]   = g.width();
+    o["height"]  = g.height();
+    o["refresh"] = screen->refreshRate();
+    return o;
+}
+
+QJsonObject StateTree::workspaceJson(const Workspace* ws, quint64 since, bool full) const {
+    QJsonArray ids;
+    QJsonArray windows;
+    for (auto* w : ws->windows()) {
+        ids.append(qint64(w->id()));
+        const quint64 gen = m_windowGen.value(w);
+        if (!full && gen <= since) continue;
+        QJsonObject o = windowJson(w);
+        o["generation"] = qint64(gen);
+        windows.append(o);
+    }
+
+    const quint64 gen = m_workspaceGen.value(ws->id());
+    if (!full && gen <= since && windows.isEmpty()) return {};
+
+    const auto* active = ws->activeWindow();
+    QJsonObject o;
+    o["id"]            = ws->id();
+    o["name"]          = ws->name();
+    o["layout"]        = TilingEngine::layoutToString(ws->layout());
+    o["focused"]       = ws->id() == m_compositor->activeWorkspaceId();
+    o["active_window"] = active ? QJsonValue(qint64(active->id())) : QJsonValue();
+    o["window_ids"]    = ids;
+    o["windows"]       = windows;
+    o["generation"]    = qint64(gen);
+    return o;
+}
+
+QJsonObject StateTree::toJson(quint64 since) const {
+    // A generation from the future (a mirror kept across a compositor
+    // restart) has nothing to diff against
+    const bool full = since == 0 || since < m_removedFloor || since > m_generation;
+
+    QJsonArray workspaces;
+    for (int id = 1; id <= m_compositor->workspaceCount(); ++id) {
+        const auto* ws = m_compositor->workspace(id);
+        if (!ws) continue;
+        const QJsonObject o = workspaceJson(ws, since, full);
+        if (!o.isEmpty()) workspaces.append(o);
+    }
+
+    // Single output for now — every workspace lives on the primary one
+    QJsonArray outputs;
+    const auto* primary = m_compositor->primaryOutput();
+    if (primary && primary->screen() &&
+        (full || m_outputGen > since || !workspaces.isEmpty())) {
+        QJsonObject o = outputJson(primary->screen());
+        o["primary"]    = true;
+        o["generation"] = qint64(m_outputGen);
+        o["workspaces"] = workspaces;
+        outputs.append(o);
+    }
+
+    QJsonObject tree;
+    tree["generation"] = qint64(m_generation);
+    tree["full"]       = full;
+    tree["outputs"]    = outputs;
+    if (!full) {
+        tree["since"] = qint64(since);
+        QJsonArray removed;
+        for (const auto& r : m_removed)
+            if (r.generation > since) removed.append(qint64(r.windowId));
+        tree["removed"] = removed;
+    }
+    return tree;
+}
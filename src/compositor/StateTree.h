@@ -0,0 +1,72 @@
+#pragma once
+#include <QObject>
+#include <QHash>
+#include <QJsonObject>
+#include <QVector>
+
+class WMCompositor;
+class Window;
+class Workspace;
+class QScreen;
+enum class WindowState;
+
+// ─────────────────────────────────────────────────────────────────────────────
+// StateTree — the compositor's state as outputs → workspaces → windows,
+// for IPC introspection (get_tree / get_tree_since)
+//
+// Every change a tree client could see bumps one monotonically increasing
+// generation and stamps the node it touched with it.  So
+// toJson(since) can return only the nodes stamped after \p since, plus the
+// ids of windows closed since then — a mirror applies the diff instead of
+// refetching and comparing everything.
+//
+// Closed windows are remembered for the last kMaxRemoved closes.  A client
+// asking from further back than that gets the full tree ("full": true).
+// ─────────────────────────────────────────────────────────────────────────────
+class StateTree : public QObject {
+    Q_OBJECT
+public:
+    explicit StateTree(WMCompositor* compositor, QObject* parent = nullptr);
+
+    quint64 generation() const { return m_generation; }
+
+    /// The full tree for \p since 0 (or a generation this tree never
+    /// reached); otherwise only what changed after generation \p since.  In a diff, a workspace's "windows" holds just
+    /// its changed windows — "window_ids" always lists them all, in order.
+    QJsonObject toJson(quint64 since = 0) const;
+
+    // ── Node serialisation (also used by IPC events) ──────────────────────
+    static const char* stateName(WindowState s);
+    static QJsonObject windowJson(const Window* w);
+    static QJsonObject outputJson(const QScreen* screen);
+
+signals:
+    /// The generation moved on.  Emitted per change — coalesce if needed.
+    void changed(quint64 generation);
+
+private:
+    void watchWindow(Window* w);
+    void watchWorkspace(Workspace* ws);
+    quint64 bump();
+
+    void touchWindow(const Window* w)  { m_windowGen[w] = bump(); }
+    void touchWorkspace(int id)        { m_workspaceGen[id] = bump(); }
+
+    QJsonObject workspaceJson(const Workspace* ws, quint64 since, bool full) const;
+
+    static constexpr int kMaxRemoved = 1024;
+
+    struct Removed {
+        quint64 windowId;
+        quint64 generation;
+    };
+
+    WMCompositor*                  m_compositor = nullptr;
+    quint64                        m_generation = 0;
+    QHash<const Window*, quint64>  m_windowGen;
+    QHash<int, quint64>            m_workspaceGen;
+    quint64                        m_outputGen  = 0;
+    int                            m_focusedWs  = 0;
+    QVector<Removed>               m_removed;           ///< Oldest first
+    quint64                        m_removedFloor = 0;  ///< Generation of the newest forgotten close
+};
@@ -3,9 +3,11 @@
 #include "ui/AppLauncher.h"
 #include "WMOutput.h"
 #include "WMSurface.h"
+#include "ScreencastManager.h"
 #include "core/Window.h"
 #include "core/Workspace.h"
 #include "core/Config.h"
+#include "core/InputHandler.h"
 #include "ui/BarWidget.h"
 #include "ui/AppLauncher.h"
 #include "ui/NotificationOverlay.h"
@@ -16,8 +18,15 @@
 #include <QWaylandSeat>
 #include <QProcess>
 #include <QDebug>
+#include <QLoggingCategory>
 #include <QScreen>
 #include <QGuiApplication>
+#include <QTimer>
+#include <QtConcurrent/QtConcurrentMap>
+
+// Every flush with the running retile counts, off unless asked for:
+//   QT_LOGGING_RULES="hackerlandwm.tiling.debug=true"
+Q_LOGGING_CATEGORY(lcTiling, "hackerlandwm.tiling", QtInfoMsg)
 
 // ─────────────────────────────────────────────────────────────────────────────
 // Construction / destruction
@@ -27,9 +36,15 @@ WMCompositor::WMCompositor(QObject* parent)
 : QWaylandCompositor(parent)
 , m_animEngine(this)
 {
+    // A ticking output applies a finished batch at its next flush; without
+    // one nothing else would
+    connect(&m_retileWatcher, &QFutureWatcher<void>::finished, this, [this] {
+        if (!m_primaryOutput || !m_primaryOutput->isTicking()) flushRetiles();
+    });
 }
 
 WMCompositor::~WMCompositor() {
+    m_retileBatch.waitForFinished();
     qDeleteAll(m_workspaces);
 }
 
@@ -46,6 +61,12 @@ bool WMCompositor::initialize() {
     setupOutputs();
     setupShell();
     setupBar();
+    setupInput();
+
+    // Screenshots and window capture work without PipeWire; only screen
+    // share needs it
+    m_screencast = new ScreencastManager(this, this);
+    m_screencast->initialize();
 
     m_initialized = true;
     return true;
@@ -63,10 +84,18 @@ void WMCompositor::setupWorkspaces() {
         connect(ws, &Workspace::retileRequested, this, [this](const QRect&) {
             emit tiledWindowsChanged();
         });
+        connect(ws, &Workspace::retileNeeded, this, [this, ws] {
+            scheduleRetile(ws);
+        });
     }
     m_activeWorkspaceId = 1;
     if (!m_workspaces.isEmpty())
         m_workspaces[0]->setActive(true);
+
+    // Connected after the workspaces, so their engines already carry the
+    // new gaps / ratios when the relayout is scheduled.
+    connect(&Config::instance(), &Config::configReloaded,
+            this, &WMCompositor::scheduleRetileAll);
 }
 
 void WMCompositor::setupOutputs() {
@@ -82,9 +111,16 @@ void WMCompositor::setupOutputs() {
 
         if (!m_primaryOutput) {
             m_primaryOutput = new WMOutput(this, screen, this);
+            connect(screen, &QScreen::geometryChanged,
+                    this, &WMCompositor::scheduleRetileAll);
         }
         break; // single-screen for now
     }
+
+    connect(qGuiApp, &QGuiApplication::screenAdded,
+            this, &WMCompositor::scheduleRetileAll);
+    connect(qGuiApp, &QGuiApplication::screenRemoved,
+            this, &WMCompositor::scheduleRetileAll);
 }
 
 void WMCompositor::setupShell() {
@@ -117,6 +153,27 @@ void WMCompositor::setupBar() {
             this, &WMCompositor::launchApp);
 }
 
+void WMCompositor::setupInput() {
+    m_input = new InputHandler(this, this);
+
+    connect(m_input, &InputHandler::actionTriggered,
+            this, &WMCompositor::dispatch);
+    connect(m_input, &InputHandler::windowFocusRequested,
+            this, &WMCompositor::focusWindow);
+    connect(m_input, &InputHandler::closeButtonClicked,
+            this, &WMCompositor::closeWindow);
+    connect(m_input, &InputHandler::maximizeButtonClicked,
+            this, [this](Window* w) { toggleMaximize(w); });
+    // Same as a client's xdg_toplevel.set_minimized (WMXdgShell)
+    connect(m_input, &InputHandler::minimizeButtonClicked,
+            this, [](Window* w) {
+                w->setState(WindowState::Minimized);
+                w->setVisible(false);
+            });
+
+    if (m_primaryOutput) m_primaryOutput->setInputHandler(m_input);
+}
+
 // ─────────────────────────────────────────────────────────────────────────────
 // show / shutdown
 // ─────────────────────────────────────────────────────────────────────────────
@@ -204,16 +261,11 @@ void WMCompositor::onXdgToplevelCreated(QWaylandXdgToplevel* toplevel,
                                             if (!ws) return;
 
                                             ws->addWindow(w);
-                                            retileWorkspace(ws);
 
-                                            // Animate open
-                                            const auto tiles = ws->computeTiles(workArea());
-                                            for (const auto& t : tiles) {
-                                                if (t.window == w) {
-                                                    m_animEngine.animateWindowOpen(w, t.targetGeometry);
-                                                    break;
-                                                }
-                                            }
+                                            // The open animation is started by the coalesced layout pass, which
+                                            // is the only place the window's target geometry is computed.
+                                            m_pendingOpen.insert(w);
+                                            scheduleRetile(ws);
 
                                             ws->setActiveWindow(w);
                                             emit activeWindowChanged(w);
@@ -223,10 +275,11 @@ void WMCompositor::onXdgToplevelCreated(QWaylandXdgToplevel* toplevel,
                                             for (auto* ws : m_workspaces) {
                                                 if (ws->contains(w)) {
                                                     ws->removeWindow(w);
-                                                    retileWorkspace(ws);
+                                                    scheduleRetile(ws);
                                                     break;
                                                 }
                                             }
+                                            m_pendingOpen.remove(w);
                                             emit windowRemoved(w);
                                             emit activeWindowChanged(activeWindow());
                                         }
@@ -271,26 +324,130 @@ void WMCompositor::onXdgToplevelCreated(QWaylandXdgToplevel* toplevel,
 
                                         void WMCompositor::retileCurrentWorkspace() {
                                             if (auto* ws = activeWorkspace())
-                                                retileWorkspace(ws);
+                                                scheduleRetile(ws);
                                         }
 
                                         // ─────────────────────────────────────────────────────────────────────────────
                                         // Tiling
                                         // ─────────────────────────────────────────────────────────────────────────────
 
+                                        void WMCompositor::scheduleRetile(Workspace* ws) {
+                                            if (!ws) return;
+                                            ++m_retileStats.requests;
+                                            if (m_retileDirty.contains(ws)) return;
+
+                                            m_retileDirty.append(ws);
+
+                                            // The output flushes at the top of its render tick; with no output,
+                                            // or one not ticking (hidden, not shown yet), run on the next
+                                            // event-loop turn so the request is never lost.
+                                            const bool ticking = m_primaryOutput && m_primaryOutput->isTicking();
+                                            if (!ticking && m_retileDirty.size() == 1)
+                                                QTimer::singleShot(0, this, &WMCompositor::flushRetiles);
+                                        }
+
+                                        void WMCompositor::scheduleRetileAll() {
+                                            for (Workspace* ws : std::as_const(m_workspaces))
+                                                scheduleRetile(ws);
+                                        }
+
+                                        void WMCompositor::flushRetiles() {
+                                            // Layouts computed off-thread since the last flush land first.  While
+                                            // they are still running, new requests wait for the next tick.
+                                            if (m_retileInFlight) {
+                                                if (!m_retileBatch.isFinished()) return;
+                                                applyRetileBatch();
+                                            }
+                                            if (m_retileDirty.isEmpty()) return;
+
+                                            // retileWorkspace() may emit signals whose handlers schedule again;
+                                            // those land in the next frame rather than re-entering this loop.
+                                            const QList<Workspace*> dirty = std::move(m_retileDirty);
+                                            m_retileDirty.clear();
+                                            if (dirty.size() == 1)
+                                                retileWorkspace(dirty.first());
+                                            else
+                                                retileBatch(dirty);
+                                            qCDebug(lcTiling) << "[Tiling] flush:" << dirty.size() << "workspace(s);"
+                                                              << m_retileStats.requests << "requests,"
+                                                              << m_retileStats.passes << "passes,"
+                                                              << m_retileStats.merged() << "merged";
+                                        }
+
                                         void WMCompositor::retileWorkspace(Workspace* ws) {
                                             if (!ws) return;
-                                            const auto tiles = ws->computeTiles(workArea());
-                                            for (const auto& t : tiles) {
-                                                if (t.window->geometry() != t.targetGeometry
-                                                    && !m_animEngine.isAnimating(t.window)) {
-                                                    m_animEngine.animateWindowMove(
-                                                        t.window, t.window->geometry(), t.targetGeometry);
-                                                    }
+                                            ++m_retileStats.passes;
+
+                                            ws->computeTileChanges(workArea(), m_tileScratch);
+                                            applyTiles(ws, m_tileScratch);
+                                            emit tiledWindowsChanged();
+                                        }
+
+                                        void WMCompositor::retileBatch(const QList<Workspace*>& dirty) {
+                                            // Each workspace owns its TilingEngine and BSP tree, so the layouts are
+                                            // independent and run side by side on the global pool, while this
+                                            // thread goes on with the frame.  What they read from the windows is
+                                            // snapshotted here first, so animation ticks, client commits and input
+                                            // may change the windows meanwhile.  Each workspace waits for the batch
+                                            // before it touches its engine or tree again (Workspace::setLayoutJob).
+                                            m_retileJobs.resize(dirty.size());
+                                            const QRect area = workArea();
+                                            for (int i = 0; i < dirty.size(); ++i) {
+                                                m_retileJobs[i].ws = dirty[i];
+                                                dirty[i]->snapshotTiles(area, m_retileJobs[i].snap);
+                                            }
+
+                                            m_retileBatch = QtConcurrent::map(m_retileJobs, [](RetileJob& job) {
+                                                job.ws->computeTileChanges(job.snap, job.changed);
+                                            });
+                                            for (Workspace* ws : dirty) ws->setLayoutJob(m_retileBatch);
+                                            m_retileInFlight = true;
+                                            m_retileWatcher.setFuture(m_retileBatch);
+                                        }
+
+                                        void WMCompositor::applyRetileBatch() {
+                                            m_retileInFlight = false;
+                                            for (RetileJob& job : m_retileJobs) {
+                                                ++m_retileStats.passes;
+                                                // Laid out from the snapshot: a window closed since has no business
+                                                // being placed.  One that changed since is caught by its own retile.
+                                                Workspace* ws = job.ws;
+                                                job.changed.removeIf([ws](const TileResult& t) { return !ws->contains(t.window); });
+                                                applyTiles(ws, job.changed);
                                             }
                                             emit tiledWindowsChanged();
                                         }
 
+                                        void WMCompositor::applyTiles(Workspace* ws, const QList<TileResult>& changed) {
+                                            // Hidden workspaces are not drawn — snap their windows into place so a
+                                            // later switch shows the final layout instead of replaying the move.
+                                            const bool visible = ws->id() == m_activeWorkspaceId;
+
+                                            // Only windows whose target moved come back, so a retile that leaves
+                                            // most tiles in place doesn't touch (or restart animations on) them.
+                                            // A changed target retargets a running animation from where it is.
+                                            for (const auto& t : changed) {
+                                                if (m_pendingOpen.remove(t.window) && visible) {
+                                                    m_animEngine.animateWindowOpen(t.window, t.targetGeometry);
+                                                    continue;
+                                                }
+                                                if (t.window->geometry()       == t.targetGeometry &&
+                                                    t.window->visualGeometry() == t.targetGeometry) continue;
+                                                if (visible) {
+                                                    // A pure move commits its geometry on landing, so until then it
+                                                    // reads as drift; don't restart one already heading there.
+                                                    if (m_animEngine.targetOf(t.window) == t.targetGeometry) continue;
+                                                    // Start from where the window is drawn, which differs
+                                                    // from geometry() while a move is still in flight.
+                                                    m_animEngine.animateWindowMove(
+                                                        t.window, t.window->visualGeometry(), t.targetGeometry);
+                                                } else {
+                                                    m_animEngine.cancelAnimation(t.window);
+                                                    t.window->setGeometry(t.targetGeometry);
+                                                }
+                                            }
+                                        }
+
                                         // ─────────────────────────────────────────────────────────────────────────────
                                         // Lookups / accessors
                                         // ─────────────────────────────────────────────────────────────────────────────
@@ -337,6 +494,8 @@ void WMCompositor::onXdgToplevelCreated(QWaylandXdgToplevel* toplevel,
                                             if (id == m_activeWorkspaceId) return;
                                             if (!workspace(id)) return;
 
+                                            emit workspaceAboutToSwitch(m_activeWorkspaceId, id);
+
                                             auto* oldWs = activeWorkspace();
                                             auto* newWs = workspace(id);
 
@@ -349,10 +508,11 @@ void WMCompositor::onXdgToplevelCreated(QWaylandXdgToplevel* toplevel,
                                             m_activeWorkspaceId = id;
                                             newWs->setActive(true);
 
+                                            // Minimized windows stay hidden until restored
                                             for (auto* w : newWs->windows())
-                                                w->setVisible(true);
+                                                w->setVisible(!w->isMinimized());
 
-                                            retileWorkspace(newWs);
+                                            scheduleRetile(newWs);
                                             emit activeWorkspaceChanged(id);
 
                                             if (!newWs->activeWindow() && !newWs->windows().isEmpty())
@@ -368,14 +528,14 @@ void WMCompositor::onXdgToplevelCreated(QWaylandXdgToplevel* toplevel,
                                             for (auto* fromWs : m_workspaces) {
                                                 if (fromWs->contains(w)) {
                                                     fromWs->removeWindow(w);
-                                                    retileWorkspace(fromWs);
+                                                    scheduleRetile(fromWs);
                                                     break;
                                                 }
                                             }
 
                                             ws->addWindow(w);
-                                            w->setVisible(workspaceId == m_activeWorkspaceId);
-                                            retileWorkspace(ws);
+                                            w->setVisible(workspaceId == m_activeWorkspaceId && !w->isMinimized());
+                                            scheduleRetile(ws);
                                         }
 
                                         // ─────────────────────────────────────────────────────────────────────────────
@@ -398,17 +558,21 @@ void WMCompositor::onXdgToplevelCreated(QWaylandXdgToplevel* toplevel,
                                             emit activeWindowChanged(w);
                                         }
 
-                                        void WMCompositor::focusDirection(const QString& dir) {
+                                        void WMCompositor::focusDirection(ActionDir dir) {
                                             auto* ws = activeWorkspace();
                                             if (!ws) return;
-                                            if (dir == "next" || dir == "right" || dir == "down")
-                                                ws->focusNext();
-                                            else
-                                                ws->focusPrev();
+                                            switch (dir) {
+                                                case ActionDir::Left:  ws->focusDirection(FocusDirection::Left);  break;
+                                                case ActionDir::Right: ws->focusDirection(FocusDirection::Right); break;
+                                                case ActionDir::Up:    ws->focusDirection(FocusDirection::Up);    break;
+                                                case ActionDir::Down:  ws->focusDirection(FocusDirection::Down);  break;
+                                                case ActionDir::Next:  ws->focusNext();                           break;
+                                                case ActionDir::Prev:  ws->focusPrev();                           break;
+                                            }
                                             emit activeWindowChanged(ws->activeWindow());
                                         }
 
-                                        void WMCompositor::moveWindowDirection(const QString& dir) {
+                                        void WMCompositor::moveWindowDirection(ActionDir dir) {
                                             auto* ws = activeWorkspace();
                                             if (!ws || !ws->activeWindow()) return;
 
@@ -416,14 +580,14 @@ void WMCompositor::onXdgToplevelCreated(QWaylandXdgToplevel* toplevel,
                                             const int idx    = windows.indexOf(ws->activeWindow());
                                             int       newIdx = idx;
 
-                                            if (dir == "right" || dir == "down")
+                                            if (dir == ActionDir::Right || dir == ActionDir::Down)
                                                 newIdx = qMin(idx + 1, windows.size() - 1);
                                             else
                                                 newIdx = qMax(idx - 1, 0);
 
                                             if (newIdx != idx) {
                                                 windows.swapItemsAt(idx, newIdx);
-                                                retileWorkspace(ws);
+                                                scheduleRetile(ws);
                                             }
                                         }
 
@@ -432,14 +596,14 @@ void WMCompositor::onXdgToplevelCreated(QWaylandXdgToplevel* toplevel,
                                             if (!ws) return;
                                             const int l = ((int)ws->layout() + 1) % 6;
                                             ws->setLayout((TilingLayout)l);
-                                            retileWorkspace(ws);
+                                            scheduleRetile(ws);
                                         }
 
                                         void WMCompositor::setLayout(TilingLayout l) {
                                             auto* ws = activeWorkspace();
                                             if (!ws) return;
                                             ws->setLayout(l);
-                                            retileWorkspace(ws);
+                                            scheduleRetile(ws);
                                         }
 
                                         void WMCompositor::toggleFloat(Window* w) {
@@ -474,8 +638,8 @@ void WMCompositor::onXdgToplevelCreated(QWaylandXdgToplevel* toplevel,
                                         }
 
                                         void WMCompositor::reloadConfig() {
+                                            // configReloaded schedules a relayout of every workspace
                                             Config::instance().load(QString());
-                                            retileCurrentWorkspace();
                                             emit tiledWindowsChanged();
                                         }
 
@@ -497,6 +661,43 @@ void WMCompositor::onXdgToplevelCreated(QWaylandXdgToplevel* toplevel,
                                             }
                                         }
 
+                                        void WMCompositor::dispatch(const Action& a) {
+                                            switch (a.op) {
+                                                case ActionOp::None:            break;
+                                                case ActionOp::Exec:            launchApp(a.str);                          break;
+                                                case ActionOp::Workspace:       switchWorkspace(a.arg);                    break;
+                                                case ActionOp::WorkspaceNext:
+                                                    if (m_workspaces.isEmpty()) break;
+                                                    switchWorkspace(m_activeWorkspaceId % workspaceCount() + 1);
+                                                    break;
+                                                case ActionOp::WorkspacePrev:
+                                                    if (m_workspaces.isEmpty()) break;
+                                                    switchWorkspace((m_activeWorkspaceId + workspaceCount() - 2) % workspaceCount() + 1);
+                                                    break;
+                                                case ActionOp::MoveToWorkspace:
+                                                    if (auto* w = activeWindow()) moveWindowToWorkspace(w, a.arg);
+                                                    break;
+                                                case ActionOp::Focus:           focusDirection(a.dir());                   break;
+                                                case ActionOp::Move:            moveWindowDirection(a.dir());              break;
+                                                case ActionOp::Layout:          setLayout(TilingLayout(a.arg));            break;
+                                                case ActionOp::LayoutCycle:     cycleLayout();                             break;
+                                                case ActionOp::Close:           closeWindow(activeWindow());               break;
+                                                case ActionOp::Fullscreen:      toggleFullscreen();                        break;
+                                                case ActionOp::Float:           toggleFloat();                             break;
+                                                case ActionOp::Maximize:        toggleMaximize();                          break;
+                                                case ActionOp::Reload:          reloadConfig();                            break;
+                                                case ActionOp::Lock:            lockScreen();                              break;
+                                                case ActionOp::Launcher:        showLauncher();                            break;
+                                                case ActionOp::Quit:            QGuiApplication::quit();                   break;
+                                            }
+                                        }
+
                                         void WMCompositor::dispatchAction(const QString& action) {
-                                            handleKeybind(action);
+                                            QString error;
+                                            const Action a = Action::parse(action, &error);
+                                            if (!a.isValid()) {
+                                                qWarning() << "[WMCompositor] Ignoring action" << action << "-" << error;
+                                                return;
+                                            }
+                                            dispatch(a);
                                         }
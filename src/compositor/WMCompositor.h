@@ -6,11 +6,15 @@
 #include <QWaylandXdgShell>
 #include <QList>
 #include <QHash>
+#include <QSet>
+#include <QFuture>
+#include <QFutureWatcher>
 #include <memory>
 
 #include "core/TilingEngine.h"
 #include "core/AnimationEngine.h"
 #include "core/Config.h"
+#include "core/Action.h"
 
 class Window;
 class Workspace;
@@ -20,6 +24,8 @@ class BarWidget;
 class AppLauncher;
 class LockScreen;
 class NotificationOverlay;
+class InputHandler;
+class ScreencastManager;
 
 class WMCompositor : public QWaylandCompositor {
     Q_OBJECT
@@ -35,9 +41,11 @@ public:
     // ── Workspace management ──────────────────────────────────────────────
     Workspace* workspace(int id) const;
     Workspace* activeWorkspace() const;
+    int        activeWorkspaceId() const { return m_activeWorkspaceId; }
     void switchWorkspace(int id);
     void moveWindowToWorkspace(Window* w, int workspaceId);
     int  workspaceCount() const { return m_workspaces.size(); }
+    const QList<Workspace*>& workspaces() const { return m_workspaces; }
 
     // ── Window management ─────────────────────────────────────────────────
     Window*        activeWindow() const;
@@ -46,8 +54,8 @@ public:
     QList<Window*> allWindows() const;
 
     // ── Actions ───────────────────────────────────────────────────────────
-    void focusDirection(const QString& dir);
-    void moveWindowDirection(const QString& dir);
+    void focusDirection(ActionDir dir);
+    void moveWindowDirection(ActionDir dir);
     void cycleLayout();
     void setLayout(TilingLayout l);
     void toggleFloat(Window* w = nullptr);
@@ -63,18 +71,52 @@ public:
     WMOutput* primaryOutput() const { return m_primaryOutput; }
 
     // ── Accessors for UI ──────────────────────────────────────────────────
-    AnimationEngine* animEngine() { return &m_animEngine; }
-    BarWidget*       bar()        { return m_bar; }
+    AnimationEngine* animEngine()   { return &m_animEngine; }
+    BarWidget*       bar()          { return m_bar; }
+    InputHandler*    inputHandler() { return m_input; }
+    ScreencastManager* screencast() { return m_screencast; }
+
+    // ── Retile scheduling ─────────────────────────────────────────────────
+    /// Mark \p ws for relayout.  Any number of requests before the next
+    /// frame collapse into a single layout pass in flushRetiles().
+    void scheduleRetile(Workspace* ws);
+
+    /// Mark every workspace for relayout — config reload, output resize or
+    /// hotplug.  The flush computes them in parallel.
+    void scheduleRetileAll();
+
+    /// Run one layout pass per dirty workspace.  Called by WMOutput at the
+    /// start of each render tick.  With more than one workspace dirty the
+    /// layouts are computed on the thread pool and applied by the first
+    /// flush after they finish (see retileBatch()).
+    void flushRetiles();
+
+    /// Running counts since startup; logged on every flush under the
+    /// hackerlandwm.tiling category at debug level.
+    struct RetileStats {
+        quint64 requests = 0;   ///< scheduleRetile() calls
+        quint64 passes   = 0;   ///< layout passes actually run
+        quint64 merged() const { return requests > passes ? requests - passes : 0; }
+    };
+    const RetileStats& retileStats() const { return m_retileStats; }
 
 signals:
     void windowAdded           (Window* w);
     void windowRemoved         (Window* w);
+    /// Emitted synchronously before the switch, while \p fromId is still
+    /// shown — the last chance to capture it (WMOutput snapshots it here).
+    void workspaceAboutToSwitch(int fromId, int toId);
     void activeWorkspaceChanged(int id);
     void activeWindowChanged   (Window* w);
     void tiledWindowsChanged   ();
 
 public slots:
-    /// Public entry point for external action dispatch (IPC, gamepad, etc.)
+    /// Execute a pre-parsed action — keybinds, gamepad buttons and IPC
+    /// commands all end up here.
+    void dispatch(const Action& action);
+
+    /// Parse \p action and dispatch it.  For callers that only have a
+    /// string; anything on a hot path should parse once and keep the Action.
     void dispatchAction(const QString& action);
 
     void onXdgToplevelCreated(QWaylandXdgToplevel* toplevel,
@@ -94,15 +136,18 @@ private:
     void setupOutputs();
     void setupShell();
     void setupBar();
+    void setupInput();
 
     // ── Internal window lifecycle ─────────────────────────────────────────
     void addWindowToSystem    (Window* w);
     void removeWindowFromSystem(Window* w);
 
     // ── Helpers ───────────────────────────────────────────────────────────
-    void     retileWorkspace(Workspace* ws);
+    void     retileWorkspace(Workspace* ws);   ///< Immediate pass — use scheduleRetile()
+    void     retileBatch(const QList<Workspace*>& dirty);
+    void     applyRetileBatch();
+    void     applyTiles(Workspace* ws, const QList<TileResult>& changed);
     Window*  windowFromToplevel(QWaylandXdgToplevel* toplevel) const;
-    void     handleKeybind(const QString& action);
     void     applyWindowRules(Window* w);
 
     // ── Protocol objects ──────────────────────────────────────────────────
@@ -122,6 +167,24 @@ private:
     AppLauncher*         m_launcher      = nullptr;
     LockScreen*          m_lockScreen    = nullptr;
     NotificationOverlay* m_notif         = nullptr;
+    InputHandler*        m_input         = nullptr;
+    ScreencastManager*   m_screencast    = nullptr;
+
+    // ── Retile scheduler ──────────────────────────────────────────────────
+    QList<Workspace*> m_retileDirty;    ///< Pending, in request order.
+    QSet<Window*>     m_pendingOpen;    ///< Open animation on next pass.
+    RetileStats       m_retileStats;
+    QList<TileResult> m_tileScratch;    ///< Reused by retileWorkspace().
+
+    struct RetileJob {
+        Workspace*             ws = nullptr;
+        TilingEngine::Snapshot snap;
+        QList<TileResult>      changed;
+    };
+    QList<RetileJob>     m_retileJobs;  ///< Reused by retileBatch().
+    QFuture<void>        m_retileBatch; ///< Layouts of m_retileJobs on the pool.
+    QFutureWatcher<void> m_retileWatcher;
+    bool                 m_retileInFlight = false;
 
     AnimationEngine m_animEngine;
     bool            m_initialized = false;
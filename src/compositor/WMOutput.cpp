@@ -16,6 +16,8 @@
 #include "core/Config.h"
 #include "core/TilingEngine.h"
 #include "core/InputHandler.h"
+#include "core/LatencyTracer.h"
+#include "compositor/WMSurface.h"
 #include "ui/GLBlurRenderer.h"
 
 #include <QPainter>
@@ -34,11 +36,14 @@
 #include <QImageReader>
 #include <QFileInfo>
 #include <QOpenGLFunctions_3_3_Core>
+#include <QOpenGLFramebufferObject>
+#include <QOpenGLPaintDevice>
 
 #ifdef QT_SVG_LIB
 #  include <QSvgRenderer>
 #endif
 
+#include <algorithm>
 #include <cstdlib>
 #include <ctime>
 
@@ -209,10 +214,27 @@ WMOutput::WMOutput(WMCompositor* compositor, QScreen* screen, QObject* parent)
     connect(compositor, &WMCompositor::windowRemoved,           this, dirty);
     connect(compositor, &WMCompositor::activeWindowChanged,     this, dirty);
     connect(compositor, &WMCompositor::activeWorkspaceChanged,  this, dirty);
+    connect(compositor->animEngine(), &AnimationEngine::frameReady, this, dirty);
+
+    // A client commit is new content to show — and for a pending client
+    // echo sample, the event it is waiting on
+    connect(compositor, &WMCompositor::windowAdded, this, [this](Window* w) {
+        connect(w, &Window::contentChanged, this, [this, w] {
+            if (w->isVisible()) m_needsRedraw = true;
+        });
+    });
+    connect(compositor, &WMCompositor::workspaceAboutToSwitch,
+            this, &WMOutput::onWorkspaceAboutToSwitch);
+
+    // Closes input → photon latency samples (see LatencyTracer)
+    connect(this, &QOpenGLWidget::frameSwapped, this, [] {
+        LatencyTracer::instance().framePresented();
+    });
 
     connect(&Config::instance(), &Config::themeChanged, this, [this] {
         loadWallpaper();
         invalidateAllBlurCaches();
+        m_snapshots.clear();
         m_needsRedraw = true;
     });
 }
@@ -319,6 +341,35 @@ void WMOutput::resizeGL(int w, int h)
 // ─────────────────────────────────────────────────────────────────────────────
 void WMOutput::onRenderTick()
 {
+    emit frameStarted();
+
+    // Pointer motion since the last frame — drag / resize geometry lands
+    // here once, ahead of the layout pass it may trigger
+    if (m_inputHandler) {
+        m_inputHandler->flushPointerMotion();
+        // Native motion moves the cursor without a Qt mouse event
+        if (m_inputHandler->nativeInput() && m_inputHandler->cursorPos() != m_cursorPos) {
+            m_cursorPos   = m_inputHandler->cursorPos();
+            m_needsRedraw = true;
+        }
+    }
+
+    // Coalesced layout passes run before anything is drawn this frame
+    m_compositor->flushRetiles();
+
+    // A switch waits for the arriving workspace's layout (flushed above)
+    // before it is captured.
+    if (m_slide.pending) startWorkspaceSlide();
+
+    // Every animation advances here, on the same clock as the frame, sampled
+    // at when this frame should reach the screen (one tick from now).
+    auto* anim = m_compositor->animEngine();
+    anim->tick(anim->now() + m_renderTimer->interval());
+
+    // Idle frames keep the workspace pictures current, so a switch starts
+    // without rendering anything
+    if (!m_slide.active && anim->activeCount() == 0) refreshSnapshots();
+
     m_glowPulse += kGlowPulseSpeed * m_glowDir;
     if (m_glowPulse >= 1.0f) { m_glowPulse = 1.0f; m_glowDir = -1.0f; }
     if (m_glowPulse <= 0.3f) { m_glowPulse = 0.3f; m_glowDir =  1.0f; }
@@ -337,6 +388,18 @@ void WMOutput::onRenderTick()
         }
 }
 
+void WMOutput::setInputHandler(InputHandler* h)
+{
+    if (m_inputHandler) disconnect(m_inputHandler, nullptr, this, nullptr);
+    m_inputHandler = h;
+    if (!h) return;
+
+    // Every action gets a frame, even one that changes nothing on screen
+    // (exec), so its keybind latency sample closes on the next swap
+    // instead of whenever something else happens to redraw.
+    connect(h, &InputHandler::actionTriggered, this, [this] { m_needsRedraw = true; });
+}
+
 // ─────────────────────────────────────────────────────────────────────────────
 // paintGL
 // ─────────────────────────────────────────────────────────────────────────────
@@ -400,6 +463,7 @@ void WMOutput::resizeEvent(QResizeEvent* e)
     rescaleWallpaper();
     m_blurCache = QPixmap();
     invalidateAllBlurCaches();
+    m_snapshots.clear();
 }
 
 // ─────────────────────────────────────────────────────────────────────────────
@@ -436,14 +500,32 @@ void WMOutput::drawWallpaper(QPainter& p)
 
 void WMOutput::drawWindows(QPainter& p)
 {
+    if (m_slide.active) {
+        // Two blits per frame, whatever is open on either workspace
+        const int   w   = width();
+        const qreal off = qreal(m_slide.t) * w * m_slide.direction;
+        const QImage from = m_snapshots.value(m_slide.fromId).image;
+        if (!from.isNull()) p.drawImage(QPointF(-off, 0), from);
+        if (!m_slide.pending) {
+            const QImage to = m_snapshots.value(m_slide.toId).image;
+            if (!to.isNull()) p.drawImage(QPointF(m_slide.direction * w - off, 0), to);
+        }
+        return;
+    }
+
     auto* ws = m_compositor->activeWorkspace();
-    if (!ws) return;
+    if (ws) drawWorkspace(p, ws);
+}
 
-    const QList<Window*> wins = ws->visibleWindows();
+void WMOutput::drawWorkspace(QPainter& p, Workspace* ws)
+{
     Window* const active = ws->activeWindow();
 
+    // Not visibleWindows(): snapshots are taken of workspaces that are
+    // not on screen, whose windows are all hidden.
     QList<Window*> tiled, floating;
-    for (auto* w : wins) {
+    for (auto* w : ws->windows()) {
+        if (w->isMinimized()) continue;
         if (w->isFloating()) floating.append(w);
         else                 tiled.append(w);
     }
@@ -469,11 +551,23 @@ void WMOutput::drawWindow(QPainter& p, Window* w, bool active)
 
     p.save();
     p.setOpacity(qBound(0.f, w->opacity(), 1.f));
+
+    // Mid-animation the window is drawn as a transform of its committed
+    // state: everything below (blur slice, chrome, title) stays at
+    // geometry() and its caches stay valid.
+    if (w->hasVisualTransform()) {
+        const QRect vis = w->visualGeometry();
+        p.translate(vis.topLeft());
+        p.scale(qreal(vis.width())  / geom.width(),
+                qreal(vis.height()) / geom.height());
+        p.translate(-geom.topLeft());
+    }
+
     drawWindowShadow        (p, geom, active);
     drawWindowBlurBackground(p, w, geom);
     drawWindowGlassOverlay  (p, geom, active);
     drawWindowBorder        (p, geom, active);
-    drawWindowContent       (p, w);
+    drawWindowContent       (p, w, geom);
     p.restore();
 }
 
@@ -600,10 +694,9 @@ void WMOutput::drawWindowBorder(QPainter& p, const QRect& rect, bool active)
     p.strokePath(border, QPen(QBrush(bg), theme.borderWidth));
 }
 
-void WMOutput::drawWindowContent(QPainter& p, Window* w)
+void WMOutput::drawWindowContent(QPainter& p, Window* w, const QRect& geom)
 {
     const auto& theme    = Config::instance().theme;
-    const QRect geom     = w->geometry();
     const bool  isActive = w->isActive();
     const int   r        = theme.borderRadius;
 
@@ -666,6 +759,224 @@ void WMOutput::drawWindowContent(QPainter& p, Window* w)
     }
 }
 
+// ─────────────────────────────────────────────────────────────────────────────
+// Workspace switch
+//
+// Each side of a switch is rendered once into an image; the slide itself is
+// two blits per frame instead of full chrome + blur for every window on both
+// workspaces.  Live rendering resumes when the slide ends.
+// ─────────────────────────────────────────────────────────────────────────────
+void WMOutput::onWorkspaceAboutToSwitch(int fromId, int toId)
+{
+    if (!isVisible() || !Config::instance().animationsEnabled() ||
+        !m_compositor->animEngine()->isEnabled()) {
+        return;
+    }
+    Workspace* ws = m_compositor->workspace(fromId);
+    if (!ws) return;
+
+    // Still showing fromId, so its picture must match what is on screen.
+    // refreshSnapshots() skips the active workspace; only a switch during
+    // a slide, which restarts from here, finds one already current.
+    if (!hasSnapshot(ws) ||
+        m_snapshots.value(fromId).contentRevision != ws->contentRevision()) {
+        snapshotWorkspace(ws);
+    }
+
+    m_slide           = {};
+    m_slide.active    = true;
+    m_slide.pending   = true;
+    m_slide.fromId    = fromId;
+    m_slide.toId      = toId;
+    m_slide.direction = toId > fromId ? 1 : -1;
+    m_needsRedraw     = true;
+}
+
+void WMOutput::startWorkspaceSlide()
+{
+    m_slide.pending = false;
+
+    Workspace* ws = m_compositor->workspace(m_slide.toId);
+    if (!ws) {
+        m_slide.active = false;
+        return;
+    }
+
+    // Rendered ahead of time unless something moved just before the switch
+    if (!hasSnapshot(ws)) snapshotWorkspace(ws);
+
+    m_compositor->animEngine()->animateWorkspaceSwitch(
+        [this](float t) { m_slide.t = t; },
+        [this] {
+            m_slide.active = false;
+            m_needsRedraw  = true;
+        });
+}
+
+void WMOutput::refreshSnapshots()
+{
+    if (!isVisible() || size().isEmpty() ||
+        !Config::instance().animationsEnabled() ||
+        !m_compositor->animEngine()->isEnabled()) {
+        return;
+    }
+
+    // One render per tick at most, and none while the last one is recent:
+    // a snapshot is a full software raster of the workspace on this thread.
+    const qint64 now = m_frameTimer.elapsed();
+    if (m_lastSnapshotMs >= 0 && now - m_lastSnapshotMs < kSnapshotGapMs) return;
+
+    // Round-robin from the one after the last rendered, so a workspace
+    // that keeps settling and changing cannot starve the others.
+    const QList<Workspace*> all = m_compositor->workspaces();
+    const int activeId = m_compositor->activeWorkspaceId();
+    for (int i = 0; i < all.size(); ++i) {
+        Workspace* ws = all.at((m_snapshotCursor + i) % all.size());
+
+        // The active workspace is drawn live; a switch away from it takes
+        // its picture right then (onWorkspaceAboutToSwitch).
+        if (ws->id() == activeId) continue;
+
+        WorkspaceSnapshot& snap = m_snapshots[ws->id()];
+
+        // Wait for a quiet spell: a window being dragged or a layout
+        // animation settling would otherwise be rendered every tick.
+        const quint64 seen = ws->revision() + ws->contentRevision();
+        if (seen != snap.seenRevision) {
+            snap.seenRevision = seen;
+            snap.seenAtMs     = now;
+        }
+
+        // Only dirty pictures, and only once their workspace has gone quiet.
+        // A client that never stops committing (video, a game) keeps its
+        // last settled picture; the slide shows that and the live frame
+        // takes over when it ends.
+        const bool stale  = !hasSnapshot(ws);
+        const bool behind = snap.contentRevision != ws->contentRevision();
+        if (!stale && !behind) continue;
+        if (now - snap.seenAtMs < kSnapshotSettleMs) continue;
+
+        snapshotWorkspace(ws);
+        m_lastSnapshotMs = now;
+        m_snapshotCursor = (m_snapshotCursor + i + 1) % all.size();
+        return;
+    }
+}
+
+bool WMOutput::hasSnapshot(Workspace* ws) const
+{
+    const auto it = m_snapshots.constFind(ws->id());
+    return it != m_snapshots.cend() &&
+           it->size         == size() &&
+           it->revision     == ws->revision() &&
+           it->wallpaperGen == m_wallpaperGen;
+}
+
+void WMOutput::snapshotWorkspace(Workspace* ws)
+{
+    const QList<Window*> wins = ws->windows();
+    const bool empty = std::all_of(wins.cbegin(), wins.cend(),
+                                   [](Window* w) { return w->isMinimized(); });
+
+    WorkspaceSnapshot& snap = m_snapshots[ws->id()];
+    snap.image           = empty ? QImage() : renderWorkspace(ws);
+    snap.size            = size();
+    snap.revision        = ws->revision();
+    snap.contentRevision = ws->contentRevision();
+    snap.wallpaperGen    = m_wallpaperGen;
+}
+
+QImage WMOutput::renderWorkspace(Workspace* ws)
+{
+    // Raster target: painted outside paintGL(), and the GL paint engine
+    // uploads the result once and reuses the texture (keyed on cacheKey).
+    QImage out(size(), QImage::Format_ARGB32_Premultiplied);
+    out.fill(Qt::transparent);
+
+    QPainter p(&out);
+    p.setRenderHints(QPainter::Antialiasing |
+                     QPainter::SmoothPixmapTransform |
+                     QPainter::TextAntialiasing);
+    drawWorkspace(p, ws);
+    return out;
+}
+
+QImage WMOutput::workspaceSnapshot(int id) const
+{
+    Workspace* ws = m_compositor->workspace(id);
+    if (!ws || !hasSnapshot(ws)) return {};
+    return m_snapshots.value(id).image;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Per-window capture
+// ─────────────────────────────────────────────────────────────────────────────
+QImage WMOutput::grabWindow(Window* w, bool withDecorations)
+{
+    if (!w || !w->surface()) return {};
+
+    // grabBuffer() needs a current context for texture-backed clients.
+    const bool haveGL = context() != nullptr;
+    if (haveGL) makeCurrent();
+
+    const QImage content = w->surface()->grabBuffer();
+    if (content.isNull() || !withDecorations) {
+        if (haveGL) doneCurrent();
+        return content;
+    }
+
+    // Chrome is drawn at the window's logical size; the client buffer goes
+    // below the title bar exactly as it would on the output.
+    const QSize  chrome(qMax(w->geometry().width(),  content.width()),
+                        qMax(w->geometry().height(), content.height() + kTitleBarHeight));
+    const QRect  local(QPoint(0, 0), chrome);
+
+    auto paintChrome = [&](QPainter& p) {
+        p.setRenderHints(QPainter::Antialiasing |
+                         QPainter::SmoothPixmapTransform |
+                         QPainter::TextAntialiasing);
+        // Every pass lays out against the capture's own rect, so the title
+        // and buttons match the chrome even when it differs from geometry()
+        drawWindowGlassOverlay(p, local, w->isActive());
+        p.drawImage(QPoint(0, kTitleBarHeight), content);
+        drawWindowBorder (p, local, w->isActive());
+        drawWindowContent(p, w, local);
+    };
+
+    QImage out;
+    if (haveGL && m_glAvailable) {
+        QOpenGLFramebufferObjectFormat fmt;
+        fmt.setAttachment(QOpenGLFramebufferObject::CombinedDepthStencil);
+        fmt.setSamples(4);
+        QOpenGLFramebufferObject fbo(chrome, fmt);
+        if (fbo.isValid()) {
+            fbo.bind();
+            m_gl->glViewport(0, 0, chrome.width(), chrome.height());
+            m_gl->glClearColor(0.f, 0.f, 0.f, 0.f);
+            m_gl->glClear(GL_COLOR_BUFFER_BIT);
+            {
+                QOpenGLPaintDevice dev(chrome);
+                QPainter p(&dev);
+                paintChrome(p);
+            }
+            fbo.release();
+            out = fbo.toImage();
+            m_gl->glViewport(0, 0, width(), height());
+        }
+    }
+
+    // No GL (linuxfb) or FBO allocation failed — raster fallback.
+    if (out.isNull()) {
+        out = QImage(local.size(), QImage::Format_ARGB32_Premultiplied);
+        out.fill(Qt::transparent);
+        QPainter p(&out);
+        paintChrome(p);
+    }
+
+    if (haveGL) doneCurrent();
+    return out;
+}
+
 void WMOutput::drawCursor(QPainter& p)
 {
     p.save();
@@ -686,6 +997,7 @@ void WMOutput::drawCursor(QPainter& p)
 void WMOutput::loadWallpaper()
 {
     const QString path = Config::instance().theme.wallpaperPath;
+    ++m_wallpaperGen;   // Blurred glass in the snapshots samples it
 
     if (m_wallpaperMovie) {
         m_wallpaperMovie->stop();
@@ -757,6 +1069,7 @@ void WMOutput::loadWallpaper()
 void WMOutput::rescaleWallpaper()
 {
     if (m_wallpaper.isNull() || size().isEmpty()) return;
+    ++m_wallpaperGen;
     m_wallpaperScaled = m_wallpaper.scaled(
         size(), Qt::KeepAspectRatioByExpanding, Qt::SmoothTransformation);
 }
@@ -783,20 +1096,28 @@ void WMOutput::invalidateAllBlurCaches()
 // ─────────────────────────────────────────────────────────────────────────────
 // Input events
 // ─────────────────────────────────────────────────────────────────────────────
+bool WMOutput::nativeInput() const
+{
+    return m_inputHandler && m_inputHandler->nativeInput();
+}
+
 void WMOutput::keyPressEvent(QKeyEvent* e)
 {
+    if (nativeInput()) return;   // LibinputBackend delivers these
     if (m_inputHandler && m_inputHandler->handleKeyPress(e)) return;
     QOpenGLWidget::keyPressEvent(e);
 }
 
 void WMOutput::keyReleaseEvent(QKeyEvent* e)
 {
+    if (nativeInput()) return;
     if (m_inputHandler && m_inputHandler->handleKeyRelease(e)) return;
     QOpenGLWidget::keyReleaseEvent(e);
 }
 
 void WMOutput::mousePressEvent(QMouseEvent* e)
 {
+    if (nativeInput()) return;
     if (m_inputHandler) {
         m_cursorPos = e->pos();
         m_inputHandler->handleMousePress(e->pos(), e->button(), e->modifiers());
@@ -808,6 +1129,7 @@ void WMOutput::mousePressEvent(QMouseEvent* e)
 
 void WMOutput::mouseReleaseEvent(QMouseEvent* e)
 {
+    if (nativeInput()) return;
     if (m_inputHandler) {
         m_inputHandler->handleMouseRelease(e->pos(), e->button(), e->modifiers());
         m_needsRedraw = true;
@@ -818,6 +1140,7 @@ void WMOutput::mouseReleaseEvent(QMouseEvent* e)
 
 void WMOutput::mouseMoveEvent(QMouseEvent* e)
 {
+    if (nativeInput()) return;
     if (m_inputHandler) {
         m_cursorPos = e->pos();
         m_inputHandler->handleMouseMove(e->pos(), e->buttons());
@@ -829,6 +1152,7 @@ void WMOutput::mouseMoveEvent(QMouseEvent* e)
 
 void WMOutput::wheelEvent(QWheelEvent* e)
 {
+    if (nativeInput()) return;
     if (m_inputHandler) {
         m_inputHandler->handleWheel(e->position().toPoint(),
                                     e->angleDelta(),
@@ -841,43 +1165,6 @@ void WMOutput::wheelEvent(QWheelEvent* e)
 void WMOutput::enterEvent(QEnterEvent* e) { QOpenGLWidget::enterEvent(e); }
 void WMOutput::leaveEvent(QEvent*      e) { QOpenGLWidget::leaveEvent(e); }
 
-// ─────────────────────────────────────────────────────────────────────────────
-// Action dispatch
-// ─────────────────────────────────────────────────────────────────────────────
-void WMOutput::handleAction(const QString& action)
-{
-    if      (action.startsWith("exec:"))
-        m_compositor->launchApp(action.mid(5));
-    else if (action.startsWith("workspace:"))
-        m_compositor->switchWorkspace(action.mid(10).toInt());
-    else if (action.startsWith("movetoworkspace:")) {
-        if (auto* w = m_compositor->activeWindow()) {
-            m_compositor->moveWindowToWorkspace(w, action.mid(16).toInt());
-        }
-    }
-    else if (action.startsWith("focus:"))
-        m_compositor->focusDirection(action.mid(6));
-    else if (action.startsWith("move:"))
-        m_compositor->moveWindowDirection(action.mid(5));
-    else if (action.startsWith("layout:"))
-        m_compositor->setLayout(
-            TilingEngine::layoutFromString(action.mid(7)));
-        else if (action == "close") {
-            if (auto* w = m_compositor->activeWindow()) {
-                m_compositor->closeWindow(w);
-            }
-        }
-        else if (action == "fullscreen") m_compositor->toggleFullscreen();
-        else if (action == "float")      m_compositor->toggleFloat();
-        else if (action == "maximize")   m_compositor->toggleMaximize();
-        else if (action == "reload")     m_compositor->reloadConfig();
-        else if (action == "lock")       m_compositor->lockScreen();
-        else if (action == "launcher")   m_compositor->showLauncher();
-        else if (action == "quit")       QCoreApplication::quit();
-
-        m_needsRedraw = true;
-}
-
 void WMOutput::dispatchKeybind(QKeyEvent* e) { keyPressEvent(e); }
 
 // ─────────────────────────────────────────────────────────────────────────────
@@ -886,15 +1173,7 @@ void WMOutput::dispatchKeybind(QKeyEvent* e) { keyPressEvent(e); }
 Window* WMOutput::windowAt(const QPoint& pos) const
 {
     auto* ws = m_compositor->activeWorkspace();
-    if (!ws) return nullptr;
-
-    const auto wins = ws->visibleWindows();
-    for (int i = wins.size()-1; i >= 0; --i) {
-        if (wins[i]->isVisible() && wins[i]->geometry().contains(pos)) {
-            return wins[i];
-        }
-    }
-    return nullptr;
+    return ws ? ws->windowAt(pos) : nullptr;
 }
 
 ResizeEdge WMOutput::resizeEdgeAt(const QPoint& pos, Window* w) const
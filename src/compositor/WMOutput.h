@@ -28,6 +28,7 @@ class WMCompositor;
 class GLBlurRenderer;
 class InputHandler;
 class Window;
+class Workspace;
 
 // ─────────────────────────────────────────────────────────────────────────────
 // CursorShape
@@ -74,14 +75,38 @@ public:
 
     void show();
     void hide();
+    /// True while the render tick runs (between show() and hide()).
+    bool isTicking() const { return m_renderTimer && m_renderTimer->isActive(); }
 
     bool    isDragging()    const { return m_dragging; }
     bool    isResizing()    const { return m_resizing; }
     Window* hoveredWindow() const { return m_hoveredWindow; }
 
+    /// Route this output's key / pointer events through \p h.
+    void setInputHandler(InputHandler* h);
+
+    /// Capture a single window from its own buffer, independent of what is
+    /// on screen (works for occluded windows and other workspaces).
+    /// With \p withDecorations the glass chrome and title bar are rendered
+    /// around the content into a private FBO.  Returns a null QImage if the
+    /// window has no committed buffer.
+    QImage grabWindow(Window* w, bool withDecorations = false);
+
+    /// Last offscreen picture of workspace \p id (windows only, on a
+    /// transparent output-sized image), or a null QImage if none was taken
+    /// or windows have been added, moved or hidden since.  Refreshed while
+    /// the output is idle and never for the active workspace, so it may lag
+    /// client content by a moment, or longer for a client that never goes
+    /// quiet.
+    QImage workspaceSnapshot(int id) const;
+
 signals:
     void actionTriggered(const QString& action);
 
+    /// Top of every render tick, before the layout pass — per-frame work
+    /// (the IPC command queue) hooks in here and lands in this frame.
+    void frameStarted();
+
 protected:
     void initializeGL()                   override;
     void resizeGL(int w, int h)           override;
@@ -98,6 +123,9 @@ protected:
     void enterEvent       (QEnterEvent*  event) override;
     void leaveEvent       (QEvent*       event) override;
 
+    /// LibinputBackend feeds m_inputHandler directly; Qt's events are dropped.
+    bool nativeInput() const;
+
 private slots:
     void onRenderTick();   // ← slot declaration (was missing)
 
@@ -107,6 +135,7 @@ private:
     void drawWallpaper          (QPainter& p);
     void drawVignette           (QPainter& p);
     void drawWindows            (QPainter& p);
+    void drawWorkspace          (QPainter& p, Workspace* ws);
     void drawWindow             (QPainter& p, Window* w, bool isActive);
     void drawWindowShadow       (QPainter& p, const QRect& rect, bool active);
     void drawWindowBlurBackground(QPainter& p, Window* w, const QRect& rect);
@@ -114,7 +143,7 @@ private:
     void drawWindowBorder       (QPainter& p, const QRect& rect, bool active);
     void drawTitleBar           (QPainter& p, Window* w, bool active);
     void drawTitleBarSeparator  (QPainter& p, const QRect& windowRect, bool active);
-    void drawWindowContent      (QPainter& p, Window* w);   // ← was missing
+    void drawWindowContent      (QPainter& p, Window* w, const QRect& rect);
     void drawCursor             (QPainter& p);
 
     // ── Wallpaper helpers ─────────────────────────────────────────────────
@@ -128,7 +157,6 @@ private:
 
     // ── Input helpers ─────────────────────────────────────────────────────
     void       dispatchKeybind(QKeyEvent* e);
-    void       handleAction(const QString& action);
     Window*    windowAt(const QPoint& pos) const;
     ResizeEdge resizeEdgeAt(const QPoint& pos, Window* w) const;
     void       updateCursorShape();
@@ -140,6 +168,14 @@ private:
     QRect maximizeButtonRect(const QRect& windowRect) const;
     QRect minimizeButtonRect(const QRect& windowRect) const;
 
+    // ── Workspace switch ──────────────────────────────────────────────────
+    void   onWorkspaceAboutToSwitch(int fromId, int toId);
+    void   startWorkspaceSlide();
+    void   refreshSnapshots();
+    void   snapshotWorkspace(Workspace* ws);
+    bool   hasSnapshot(Workspace* ws) const;
+    QImage renderWorkspace(Workspace* ws);
+
     // ── Render state cache ────────────────────────────────────────────────
     WindowRenderState& renderStateFor(Window* w);
     void invalidateAllBlurCaches();
@@ -181,6 +217,36 @@ private:
 
     QHash<Window*, WindowRenderState> m_renderStates;
 
+    // Offscreen workspace pictures, keyed by workspace id.  Re-rendered
+    // one at a time while nothing is animating (refreshSnapshots), so a
+    // switch normally starts with both pictures already in hand.  The
+    // active workspace is only captured when a switch leaves it.
+    struct WorkspaceSnapshot {
+        QImage  image;                ///< Null for a workspace with no windows
+        QSize   size;                 ///< Output size when rendered
+        quint64 revision        = 0;  ///< Workspace::revision() when rendered
+        quint64 contentRevision = 0;  ///< Workspace::contentRevision() when rendered
+        quint64 wallpaperGen    = 0;  ///< m_wallpaperGen when rendered
+        quint64 seenRevision    = 0;  ///< Last revision sum refreshSnapshots() saw …
+        qint64  seenAtMs        = 0;  ///< … and when it first saw it
+    };
+    QHash<int, WorkspaceSnapshot> m_snapshots;
+    qint64  m_lastSnapshotMs  = -1;   ///< m_frameTimer time of the last background render
+    int     m_snapshotCursor  = 0;    ///< Where refreshSnapshots() starts looking next
+    quint64 m_wallpaperGen = 0;       ///< Bumped whenever m_wallpaperScaled changes
+
+    // In-flight switch: the two snapshots slide over the live wallpaper
+    // and nothing else is drawn until it ends.
+    struct WorkspaceSlide {
+        bool  active    = false;
+        bool  pending   = false;  ///< Arriving snapshot not taken yet
+        int   fromId    = 0;
+        int   toId      = 0;
+        int   direction = 1;      ///< +1: arriving workspace enters from the right
+        float t         = 0.f;
+    };
+    WorkspaceSlide m_slide;
+
     float         m_glowPulse     = 0.0f;
     float         m_glowDir       = 1.0f;
 
@@ -208,4 +274,6 @@ private:
     static constexpr int   kDotRightMargin    = 12;
     static constexpr float kBlurRadius        = 14.0f;
     static constexpr float kGlowPulseSpeed    = 0.012f;
+    static constexpr int   kSnapshotSettleMs  = 250;  ///< Revision quiet time before re-rendering
+    static constexpr int   kSnapshotGapMs     = 100;  ///< Minimum time between background renders
 };
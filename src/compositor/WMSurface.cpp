@@ -1,6 +1,7 @@
 #include "WMSurface.h"
 #include "WMCompositor.h"
 #include "core/Window.h"
+#include "core/LatencyTracer.h"
 
 #include <QWaylandSurface>
 #include <QWaylandView>
@@ -11,6 +12,11 @@
 #include <QPixmap>
 #include <QDebug>
 #include <QRegion>
+#include <QOpenGLContext>
+#include <QOpenGLFunctions>
+#include <QOpenGLFramebufferObject>
+#include <QOpenGLTexture>
+#include <QOpenGLTextureBlitter>
 
 // ─────────────────────────────────────────────────────────────────────────────
 // Construction / destruction
@@ -148,6 +154,52 @@ QPixmap WMSurface::toPixmap() const {
     return QPixmap::fromImage(img);
 }
 
+QImage WMSurface::grabBuffer() const {
+    if (!m_view) return {};
+
+    QWaylandBufferRef buf = m_view->currentBuffer();
+    if (!buf.hasBuffer()) return {};
+
+    // SHM: the image aliases client memory, detach it before returning.
+    const QImage shm = buf.image();
+    if (!shm.isNull()) return shm.copy();
+
+    // Texture-backed buffer: blit the client texture into an FBO we own and
+    // read that back.  Never touches the output framebuffer, so occluded or
+    // off-workspace windows capture just as well as visible ones.
+    QOpenGLContext* ctx = QOpenGLContext::currentContext();
+    if (!ctx) return {};
+
+    QOpenGLTexture* tex = buf.toOpenGLTexture();
+    if (!tex) return {};
+
+    const QSize sz = buf.size();
+    if (sz.isEmpty()) return {};
+
+    QOpenGLFramebufferObject fbo(sz);
+    if (!fbo.isValid()) return {};
+
+    QOpenGLTextureBlitter blitter;
+    if (!blitter.create()) return {};
+
+    const auto origin = buf.origin() == QWaylandSurface::OriginTopLeft
+    ? QOpenGLTextureBlitter::OriginTopLeft
+    : QOpenGLTextureBlitter::OriginBottomLeft;
+
+    fbo.bind();
+    ctx->functions()->glViewport(0, 0, sz.width(), sz.height());
+    ctx->functions()->glClearColor(0.f, 0.f, 0.f, 0.f);
+    ctx->functions()->glClear(GL_COLOR_BUFFER_BIT);
+    blitter.bind(tex->target());
+    blitter.blit(tex->textureId(), QOpenGLTextureBlitter::targetTransform(
+        QRectF(QPointF(0, 0), sz), QRect(QPoint(0, 0), sz)), origin);
+    blitter.release();
+    fbo.release();
+    blitter.destroy();
+
+    return fbo.toImage();
+}
+
 // ─────────────────────────────────────────────────────────────────────────────
 // Buffer scale
 // ─────────────────────────────────────────────────────────────────────────────
@@ -277,6 +329,7 @@ void WMSurface::onRedraw() {
     }
 
     m_contentPending = true;
+    if (m_window) LatencyTracer::instance().clientCommitted(m_window);
     emit contentChanged(m_damage);
 }
 
@@ -108,6 +108,12 @@ public:
     /// Slightly more expensive (copies into GPU-friendly storage).
     QPixmap toPixmap() const;
 
+    /// Detached copy of the committed buffer, safe to keep past this frame.
+    /// SHM buffers are copied directly; texture-backed buffers (wl_drm /
+    /// DMA-BUF) are read back through a private FBO, which requires a
+    /// current GL context — returns a null QImage without one.
+    QImage grabBuffer() const;
+
     // ── Damage tracking ───────────────────────────────────────────────────
     /// Accumulated damage region since the last markContentPresented() call.
     QRegion accumulatedDamage() const { return m_damage; }
@@ -0,0 +1,170 @@
+#include "Action.h"
+#include "TilingEngine.h"
+
+#include <QDebug>
+
+#include <iterator>
+
+namespace {
+
+struct OpName {
+    const char* name;
+    ActionOp    op;
+};
+
+// Verb before the ':'.  workspace / focus / layout with a keyword argument
+// are resolved in parse().
+constexpr OpName kOps[] = {
+    { "exec",            ActionOp::Exec            },
+    { "workspace",       ActionOp::Workspace       },
+    { "movetoworkspace", ActionOp::MoveToWorkspace },
+    { "focus",           ActionOp::Focus           },
+    { "move",            ActionOp::Move            },
+    { "layout",          ActionOp::Layout          },
+    { "close",           ActionOp::Close           },
+    { "fullscreen",      ActionOp::Fullscreen      },
+    { "float",           ActionOp::Float           },
+    { "maximize",        ActionOp::Maximize        },
+    { "reload",          ActionOp::Reload          },
+    { "lock",            ActionOp::Lock            },
+    { "launcher",        ActionOp::Launcher        },
+    { "quit",            ActionOp::Quit            },
+};
+
+constexpr const char* kDirNames[] = { "left", "right", "up", "down", "next", "prev" };
+
+int dirFromName(const QString& s) {
+    for (int i = 0; i < int(std::size(kDirNames)); ++i) {
+        if (s == QLatin1String(kDirNames[i])) return i;
+    }
+    return -1;
+}
+
+bool takesArgument(ActionOp op) {
+    switch (op) {
+        case ActionOp::Exec:
+        case ActionOp::Workspace:
+        case ActionOp::MoveToWorkspace:
+        case ActionOp::Focus:
+        case ActionOp::Move:
+        case ActionOp::Layout:
+            return true;
+        default:
+            return false;
+    }
+}
+
+Action fail(QString* error, const QString& why) {
+    if (error) *error = why;
+    return {};
+}
+
+} // namespace
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Parsing
+// ─────────────────────────────────────────────────────────────────────────────
+
+Action Action::parse(const QString& spec, QString* error) {
+    const int     colon = spec.indexOf(QLatin1Char(':'));
+    const QString verb  = (colon < 0 ? spec : spec.left(colon)).trimmed().toLower();
+    const QString arg   = colon < 0 ? QString() : spec.mid(colon + 1).trimmed();
+
+    ActionOp op = ActionOp::None;
+    for (const auto& o : kOps) {
+        if (verb == QLatin1String(o.name)) { op = o.op; break; }
+    }
+    if (op == ActionOp::None)
+        return fail(error, QStringLiteral("unknown action: %1").arg(verb));
+
+    if (!takesArgument(op)) {
+        if (!arg.isEmpty())
+            return fail(error, QStringLiteral("%1 takes no argument").arg(verb));
+        return Action(op);
+    }
+    if (arg.isEmpty())
+        return fail(error, QStringLiteral("%1 needs an argument").arg(verb));
+
+    switch (op) {
+        case ActionOp::Exec: {
+            Action a(op);
+            a.str = arg;
+            return a;
+        }
+
+        case ActionOp::Workspace:
+            if (arg == QLatin1String("next")) return Action(ActionOp::WorkspaceNext);
+            if (arg == QLatin1String("prev")) return Action(ActionOp::WorkspacePrev);
+            Q_FALLTHROUGH();
+        case ActionOp::MoveToWorkspace: {
+            bool ok = false;
+            const int n = arg.toInt(&ok);
+            if (!ok || n < 1)
+                return fail(error, QStringLiteral("invalid workspace number: %1").arg(arg));
+            return Action(op, n);
+        }
+
+        case ActionOp::Focus:
+        case ActionOp::Move: {
+            const int d = dirFromName(arg.toLower());
+            const int last = op == ActionOp::Focus ? int(ActionDir::Prev)
+                                                   : int(ActionDir::Down);
+            if (d < 0 || d > last)
+                return fail(error, QStringLiteral("invalid direction for %1: %2").arg(verb, arg));
+            return Action(op, d);
+        }
+
+        case ActionOp::Layout: {
+            const QString name = arg.toLower();
+            if (name == QLatin1String("cycle")) return Action(ActionOp::LayoutCycle);
+            // Spellings from older default configs, which silently fell back
+            // to spiral; map them to what they were meant to do
+            if (name == QLatin1String("tiling")) {
+                qWarning() << "[Action] layout:tiling is deprecated, use layout:spiral";
+                return Action(op, int(TilingLayout::Spiral));
+            }
+            if (name == QLatin1String("float")) {
+                qWarning() << "[Action] layout:float is deprecated, use float";
+                return Action(ActionOp::Float);
+            }
+            // layoutFromString() falls back to spiral; only accept real names
+            const TilingLayout l = TilingEngine::layoutFromString(name);
+            if (TilingEngine::layoutToString(l) != name)
+                return fail(error, QStringLiteral("unknown layout: %1").arg(arg));
+            return Action(op, int(l));
+        }
+
+        default:
+            break;
+    }
+    return fail(error, QStringLiteral("unknown action: %1").arg(verb));
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Formatting
+// ─────────────────────────────────────────────────────────────────────────────
+
+QString Action::toString() const {
+    switch (op) {
+        case ActionOp::None:          return {};
+        case ActionOp::Exec:          return QStringLiteral("exec:") + str;
+        case ActionOp::Workspace:     return QStringLiteral("workspace:%1").arg(arg);
+        case ActionOp::WorkspaceNext: return QStringLiteral("workspace:next");
+        case ActionOp::WorkspacePrev: return QStringLiteral("workspace:prev");
+        case ActionOp::MoveToWorkspace:
+            return QStringLiteral("movetoworkspace:%1").arg(arg);
+        case ActionOp::Focus:
+        case ActionOp::Move:
+            return QLatin1String(op == ActionOp::Focus ? "focus:" : "move:")
+                 + QLatin1String(kDirNames[qBound(0, arg, int(std::size(kDirNames)) - 1)]);
+        case ActionOp::Layout:
+            return QStringLiteral("layout:") + TilingEngine::layoutToString(TilingLayout(arg));
+        case ActionOp::LayoutCycle:   return QStringLiteral("layout:cycle");
+        default:
+            break;
+    }
+    for (const auto& o : kOps) {
+        if (o.op == op) return QLatin1String(o.name);
+    }
+    return {};
+}
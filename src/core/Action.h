@@ -0,0 +1,79 @@
+#pragma once
+
+#include <QString>
+#include <QMetaType>
+
+// ─────────────────────────────────────────────────────────────────────────────
+// ActionOp
+//
+// Everything a keybind, gamepad button or IPC command can ask the compositor
+// to do.  WMCompositor::dispatch() switches on this — it is the only place
+// actions are executed.
+// ─────────────────────────────────────────────────────────────────────────────
+enum class ActionOp : quint8 {
+    None,            ///< Invalid / unparsed
+    Exec,            ///< str = command line
+    Workspace,       ///< arg = workspace id
+    WorkspaceNext,
+    WorkspacePrev,
+    MoveToWorkspace, ///< arg = workspace id
+    Focus,           ///< arg = ActionDir
+    Move,            ///< arg = ActionDir (Left / Right / Up / Down)
+    Layout,          ///< arg = TilingLayout
+    LayoutCycle,
+    Close,
+    Fullscreen,
+    Float,
+    Maximize,
+    Reload,
+    Lock,
+    Launcher,
+    Quit
+};
+
+/// Direction argument of Focus / Move.
+enum class ActionDir : qint8 { Left, Right, Up, Down, Next, Prev };
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Action
+//
+// A parsed action string.  Bindings, the gamepad map and IPC commands are
+// parsed once, where they are loaded; afterwards an action travels as this
+// small value and is never re-parsed.  The string argument (Exec only) is
+// implicitly shared, so copying an Action does not allocate.
+//
+// Syntax — the keybind format used by the config:
+//   exec:<command>            workspace:<n|next|prev>   movetoworkspace:<n>
+//   focus:<left|right|up|down|next|prev>      move:<left|right|up|down>
+//   layout:<name|cycle>       close  fullscreen  float  maximize
+//   reload  lock  launcher  quit
+//
+// Deprecated spellings still accepted (with a warning): layout:tiling is
+// layout:spiral, layout:float is float.
+// ─────────────────────────────────────────────────────────────────────────────
+struct Action {
+    ActionOp op  = ActionOp::None;
+    int      arg = 0;
+    QString  str;
+
+    Action() = default;
+    Action(ActionOp o, int a = 0) : op(o), arg(a) {}
+    Action(ActionOp o, ActionDir d) : op(o), arg(int(d)) {}
+
+    bool isValid() const { return op != ActionOp::None; }
+
+    ActionDir dir() const { return ActionDir(arg); }
+
+    /// Parse \p spec.  On failure returns an invalid Action and, if \p error
+    /// is given, a one-line reason suitable for a config / IPC error report.
+    static Action parse(const QString& spec, QString* error = nullptr);
+
+    /// Back to the canonical string form (logging, IPC replies).
+    QString toString() const;
+
+    bool operator==(const Action& o) const {
+        return op == o.op && arg == o.arg && str == o.str;
+    }
+};
+
+Q_DECLARE_METATYPE(Action)
@@ -1,57 +1,244 @@
 #include "AnimationEngine.h"
 #include "Window.h"
 #include "Config.h"
-#include <QVariantAnimation>
-#include <QtMath>
+#include <QTimer>
 #include <QDebug>
 
-AnimationEngine::AnimationEngine(QObject* parent) : QObject(parent) {}
+AnimationEngine::AnimationEngine(QObject* parent) : QObject(parent) {
+    m_clock.start();
 
-AnimationEngine::~AnimationEngine() {
-    qDeleteAll(m_animations);
+    m_fallback = new QTimer(this);
+    m_fallback->setTimerType(Qt::PreciseTimer);
+    m_fallback->setInterval(kFallbackIntervalMs);
+    connect(m_fallback, &QTimer::timeout, this, &AnimationEngine::onFallbackTick);
+
+    onConfigReloaded();
+    connect(&Config::instance(), &Config::configReloaded,
+            this, &AnimationEngine::onConfigReloaded);
+}
+
+AnimationEngine::~AnimationEngine() = default;
+
+// ─────────────────────────────────────────────────────────────────────────────
+// AnimationTable
+// ─────────────────────────────────────────────────────────────────────────────
+
+int AnimationTable::append(Window* w, AnimationType t, qint64 start, int duration,
+                           const EasingLUT* c) {
+    window.append(w);
+    type.append(t);
+    startMs.append(start);
+    durationMs.append(qMax(1, duration));
+    curve.append(c);
+    fromRect.append(QRect());
+    toRect.append(QRect());
+    fromOpacity.append(1.0f);
+    toOpacity.append(1.0f);
+    commitRect.append(QRect());
+    ticker.append(nullptr);
+    onFinished.append(nullptr);
+    return window.size() - 1;
+}
+
+void AnimationTable::removeAt(int row) {
+    const int last = window.size() - 1;
+    if (row != last) {
+        window[row]      = window[last];
+        type[row]        = type[last];
+        startMs[row]     = startMs[last];
+        durationMs[row]  = durationMs[last];
+        curve[row]       = curve[last];
+        fromRect[row]    = fromRect[last];
+        toRect[row]      = toRect[last];
+        fromOpacity[row] = fromOpacity[last];
+        toOpacity[row]   = toOpacity[last];
+        commitRect[row]  = commitRect[last];
+        ticker[row]      = std::move(ticker[last]);
+        onFinished[row]  = std::move(onFinished[last]);
+    }
+    window.removeLast();
+    type.removeLast();
+    startMs.removeLast();
+    durationMs.removeLast();
+    curve.removeLast();
+    fromRect.removeLast();
+    toRect.removeLast();
+    fromOpacity.removeLast();
+    toOpacity.removeLast();
+    commitRect.removeLast();
+    ticker.removeLast();
+    onFinished.removeLast();
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Easing
+// ─────────────────────────────────────────────────────────────────────────────
+
+void AnimationEngine::onConfigReloaded() {
+    const auto& anim = Config::instance().anim;
+
+    if (!EasingLUT::fromString(anim.openEasing, m_openCurve)) {
+        qWarning() << "[AnimationEngine] cannot parse openEasing" << anim.openEasing
+                   << "- using spring";
+        m_openCurve = EasingLUT::builtin(EasingCurve::Spring);
+    }
+    if (!EasingLUT::fromString(anim.closeEasing, m_closeCurve)) {
+        qWarning() << "[AnimationEngine] cannot parse closeEasing" << anim.closeEasing
+                   << "- using ease-in-cubic";
+        m_closeCurve = EasingLUT::builtin(EasingCurve::EaseInCubic);
+    }
+}
+
+EasingCurve AnimationEngine::easingFromString(const QString& s) {
+    EasingCurve c = EasingCurve::EaseOutCubic;
+    EasingLUT::curveFromString(s, c);
+    return c;
+}
+
+QString AnimationEngine::easingToString(EasingCurve e) {
+    return EasingLUT::curveToString(e);
 }
 
 // ─────────────────────────────────────────────────────────────────────────────
-// Easing functions — declared static in header, so NO const qualifier here
+// Interpolation helpers
 // ─────────────────────────────────────────────────────────────────────────────
 
-float AnimationEngine::easeOutBack(float t) {
-    const float c1 = 1.70158f;
-    const float c3 = c1 + 1.0f;
-    return 1.0f + c3 * qPow(t - 1.0f, 3) + c1 * qPow(t - 1.0f, 2);
+QRect AnimationEngine::lerpRect(const QRect& a, const QRect& b, float t) {
+    return QRect((int)(a.x()      * (1-t) + b.x()      * t),
+                 (int)(a.y()      * (1-t) + b.y()      * t),
+                 (int)(a.width()  * (1-t) + b.width()  * t),
+                 (int)(a.height() * (1-t) + b.height() * t));
 }
 
-float AnimationEngine::easeInCubic(float t) {
-    return t * t * t;
+float AnimationEngine::lerpFloat(float a, float b, float t) {
+    return qBound(0.0f, a + (b - a) * t, 1.0f);
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Frame clock
+// ─────────────────────────────────────────────────────────────────────────────
+
+void AnimationEngine::tick(qint64 presentMs) {
+    m_lastTickMs = now();
+    if (m_table.size() == 0) {
+        m_fallback->stop();
+        return;
+    }
+
+    // One pass over the table; rows are retired in place (the last row is
+    // moved into the hole, so the index is re-examined).
+    for (int i = 0; i < m_table.size(); ) {
+        const float raw = qBound(0.0f,
+            float(presentMs - m_table.startMs[i]) / m_table.durationMs[i], 1.0f);
+        applyRow(i, m_table.curve[i]->sample(raw));
+
+        if (raw < 1.0f) { ++i; continue; }
+
+        m_finished.append({m_table.window[i], m_table.type[i],
+                           m_table.commitRect[i],
+                           std::move(m_table.onFinished[i])});
+        removeRow(i);
+    }
+
+    // Callbacks may start new animations or cancel others — run them with
+    // the table in a consistent state.  Committing geometry emits
+    // geometryChanged(), which counts as a callback here.
+    for (auto& f : m_finished) {
+        if (f.commitRect.isValid()) f.window->setGeometry(f.commitRect);
+        if (f.onFinished) f.onFinished();
+        emit animationFinished(f.window, f.type);
+    }
+    m_finished.clear();
+
+    if (m_table.size() == 0) m_fallback->stop();
+    emit frameReady();
 }
 
-float AnimationEngine::easeOutCubic(float t) {
-    const float t2 = t - 1.0f;
-    return 1.0f + t2 * t2 * t2;
+void AnimationEngine::onFallbackTick() {
+    // An output ticking us recently owns the clock; stay out of its way.
+    if (m_lastTickMs >= 0 && now() - m_lastTickMs < 2 * kFallbackIntervalMs)
+        return;
+    tick(now());
 }
 
-float AnimationEngine::spring(float t) {
-    constexpr float zeta  = 0.55f;
-    constexpr float omega = 2.0f * M_PI * 1.5f;
-    if (t >= 1.0f) return 1.0f;
-    return 1.0f - qExp(-zeta * omega * t)
-    * qCos(omega * qSqrt(1.0f - zeta * zeta) * t);
+void AnimationEngine::applyRow(int row, float t) {
+    Window* w = m_table.window[row];
+    switch (m_table.type[row]) {
+        case AnimationType::WindowOpen:
+            w->setVisualGeometry(lerpRect(m_table.fromRect[row], m_table.toRect[row], t));
+            w->setOpacity(lerpFloat(m_table.fromOpacity[row], m_table.toOpacity[row],
+                                    qMin(t * 2.0f, 1.0f)));
+            w->setAnimProgress(t);
+            break;
+
+        case AnimationType::WindowClose:
+            w->setVisualGeometry(lerpRect(m_table.fromRect[row], m_table.toRect[row], t));
+            w->setOpacity(lerpFloat(m_table.fromOpacity[row], m_table.toOpacity[row], t));
+            w->setAnimProgress(1.0f - t);
+            break;
+
+        case AnimationType::WindowMove:
+        case AnimationType::WindowResize:
+            w->setVisualGeometry(lerpRect(m_table.fromRect[row], m_table.toRect[row], t));
+            break;
+
+        case AnimationType::FadeIn:
+        case AnimationType::FadeOut:
+            w->setOpacity(lerpFloat(m_table.fromOpacity[row], m_table.toOpacity[row], t));
+            break;
+
+        case AnimationType::WorkspaceSwitch:
+        case AnimationType::Custom:
+            if (m_table.ticker[row]) m_table.ticker[row](t);
+            break;
+    }
 }
 
 // ─────────────────────────────────────────────────────────────────────────────
-// Cancel / query
+// Row management / cancel / query
 // ─────────────────────────────────────────────────────────────────────────────
 
+int AnimationEngine::startAnimation(Window* w, AnimationType type, int durationMs,
+                                    const EasingLUT& curve) {
+    cancelAnimation(w);
+    const int row = m_table.append(w, type, now(), durationMs, &curve);
+    m_rows.insert(w, row);
+    if (!m_fallback->isActive()) m_fallback->start();
+    return row;
+}
+
+void AnimationEngine::removeRow(int row) {
+    const int last = m_table.size() - 1;
+    if (Window* w = m_table.window[row]) w->clearVisualGeometry();
+    m_rows.remove(m_table.window[row]);
+    m_table.removeAt(row);
+    if (row != last) m_rows[m_table.window[row]] = row;
+}
+
 void AnimationEngine::cancelAnimation(Window* w) {
-    auto* existing = m_animations.take(w);
-    if (existing) {
-        if (existing->anim) existing->anim->stop();
-        delete existing;
+    const auto it = m_rows.constFind(w);
+    if (it != m_rows.cend()) removeRow(it.value());
+}
+
+void AnimationEngine::cancelAll() {
+    for (Window* w : std::as_const(m_table.window)) {
+        if (w) w->clearVisualGeometry();
     }
+    m_table = AnimationTable();
+    m_rows.clear();
+    m_fallback->stop();
 }
 
 bool AnimationEngine::isAnimating(Window* w) const {
-    return m_animations.contains(w);
+    return m_rows.contains(w);
+}
+
+QRect AnimationEngine::targetOf(Window* w) const {
+    const int row = m_rows.value(w, -1);
+    if (row < 0) return QRect();
+    const AnimationType type = m_table.type[row];
+    if (type != AnimationType::WindowMove && type != AnimationType::WindowOpen) return QRect();
+    return m_table.toRect[row];
 }
 
 // ─────────────────────────────────────────────────────────────────────────────
@@ -66,55 +253,23 @@ void AnimationEngine::animateWindowOpen(Window* w, const QRect& targetGeom) {
         return;
     }
 
-    cancelAnimation(w);
-
-    auto* wa = new WindowAnimation();
-    wa->fromGeometry = QRect(
+    const int row = startAnimation(w, AnimationType::WindowOpen,
+                                   Config::instance().anim.windowOpenMs,
+                                   m_openCurve);
+    m_table.fromRect[row] = QRect(
         targetGeom.x() + targetGeom.width()  / 2 - 10,
                              targetGeom.y() + targetGeom.height() / 2 - 10,
                              20, 20
     );
-    wa->toGeometry  = targetGeom;
-    wa->fromOpacity = 0.0f;
-    wa->toOpacity   = 1.0f;
-    wa->fromScale   = Config::instance().anim.scaleFactor;
-    wa->toScale     = 1.0f;
-    wa->durationMs  = Config::instance().anim.windowOpenMs;   // ← durationMs
-
-    wa->anim = std::make_unique<QVariantAnimation>();
-    wa->anim->setStartValue(0.0f);
-    wa->anim->setEndValue(1.0f);
-    wa->anim->setDuration(wa->durationMs);                    // ← durationMs
-
-    connect(wa->anim.get(), &QVariantAnimation::valueChanged,
-            this, [this, wa, w, targetGeom](const QVariant& v) {
-                const float raw = v.toFloat();
-                const float t   = spring(raw);
-
-                QRect cur;
-                cur.setX(     (int)(wa->fromGeometry.x()      * (1-t) + wa->toGeometry.x()      * t));
-                cur.setY(     (int)(wa->fromGeometry.y()      * (1-t) + wa->toGeometry.y()      * t));
-                cur.setWidth( (int)(wa->fromGeometry.width()  * (1-t) + wa->toGeometry.width()  * t));
-                cur.setHeight((int)(wa->fromGeometry.height() * (1-t) + wa->toGeometry.height() * t));
-
-                const float op = wa->fromOpacity
-                + (wa->toOpacity - wa->fromOpacity) * qMin(t * 2.0f, 1.0f);
-                w->setGeometry(cur);
-                w->setOpacity(op);
-                w->setAnimProgress(t);
-            });
-
-    connect(wa->anim.get(), &QVariantAnimation::finished,
-            this, [this, w, targetGeom]() {
-                w->setGeometry(targetGeom);
-                w->setOpacity(1.0f);
-                w->setAnimProgress(1.0f);
-                cancelAnimation(w);
-                emit animationFinished(w, AnimationType::WindowOpen);
-            });
-
-    m_animations.insert(w, wa);
-    wa->anim->start();
+    m_table.toRect[row]      = targetGeom;
+    m_table.fromOpacity[row] = 0.0f;
+    m_table.toOpacity[row]   = 1.0f;
+
+    // The client is configured once, at its final size; the growth from
+    // the centre is a scale of whatever it draws.
+    w->setGeometry(targetGeom);
+    w->setVisualGeometry(m_table.fromRect[row]);
+    w->setOpacity(0.0f);
 }
 
 // ─────────────────────────────────────────────────────────────────────────────
@@ -127,46 +282,20 @@ void AnimationEngine::animateWindowClose(Window* w, std::function<void()> onDone
         return;
     }
 
-    cancelAnimation(w);
-
-    auto* wa = new WindowAnimation();
-    wa->fromGeometry = w->geometry();
-    wa->toGeometry   = QRect(
+    const int row = startAnimation(w, AnimationType::WindowClose,
+                                   Config::instance().anim.windowCloseMs,
+                                   m_closeCurve);
+    m_table.fromRect[row] = w->geometry();
+    m_table.toRect[row]   = QRect(
         w->geometry().x() + w->geometry().width()  / 2 - 20,
                              w->geometry().y() + w->geometry().height() / 2 - 20,
                              40, 40
     );
-    wa->fromOpacity = w->opacity();
-    wa->toOpacity   = 0.0f;
-    wa->durationMs  = Config::instance().anim.windowCloseMs;  // ← durationMs
-
-    wa->anim = std::make_unique<QVariantAnimation>();
-    wa->anim->setStartValue(0.0f);
-    wa->anim->setEndValue(1.0f);
-    wa->anim->setDuration(wa->durationMs);                    // ← durationMs
-
-    connect(wa->anim.get(), &QVariantAnimation::valueChanged,
-            this, [wa, w](const QVariant& v) {
-                const float t  = AnimationEngine::easeInCubic(v.toFloat());
-                QRect cur;
-                cur.setX(     (int)(wa->fromGeometry.x()      * (1-t) + wa->toGeometry.x()      * t));
-                cur.setY(     (int)(wa->fromGeometry.y()      * (1-t) + wa->toGeometry.y()      * t));
-                cur.setWidth( (int)(wa->fromGeometry.width()  * (1-t) + wa->toGeometry.width()  * t));
-                cur.setHeight((int)(wa->fromGeometry.height() * (1-t) + wa->toGeometry.height() * t));
-                w->setGeometry(cur);
-                w->setOpacity(wa->fromOpacity + (wa->toOpacity - wa->fromOpacity) * t);
-                w->setAnimProgress(1.0f - t);
-            });
-
-    connect(wa->anim.get(), &QVariantAnimation::finished,
-            this, [this, w, onDone]() {
-                cancelAnimation(w);
-                if (onDone) onDone();
-                emit animationFinished(w, AnimationType::WindowClose);
-            });
-
-    m_animations.insert(w, wa);
-    wa->anim->start();
+    m_table.fromOpacity[row] = w->opacity();
+    m_table.toOpacity[row]   = 0.0f;
+    m_table.onFinished[row]  = std::move(onDone);
+    // Geometry is never touched: the client is going away and must not be
+    // asked to shrink to 40×40 on its way out.
 }
 
 // ─────────────────────────────────────────────────────────────────────────────
@@ -179,66 +308,64 @@ void AnimationEngine::animateWindowMove(Window* w, const QRect& from, const QRec
         return;
     }
 
-    cancelAnimation(w);
-
-    auto* wa = new WindowAnimation();
-    wa->fromGeometry = from;
-    wa->toGeometry   = to;
-    wa->durationMs   = Config::instance().anim.tileRearrangeMs; // ← durationMs
-
-    wa->anim = std::make_unique<QVariantAnimation>();
-    wa->anim->setStartValue(0.0f);
-    wa->anim->setEndValue(1.0f);
-    wa->anim->setDuration(wa->durationMs);                      // ← durationMs
+    const int row = startAnimation(w, AnimationType::WindowMove,
+                                   Config::instance().anim.tileRearrangeMs,
+                                   EasingLUT::builtin(EasingCurve::EaseOutCubic));
+    m_table.fromRect[row] = from;
+    m_table.toRect[row]   = to;
+
+    // Resize: configure now so the client redraws at the new size while its
+    // frame is stretched into place.  Pure move: nothing for the client to
+    // redraw, so the real geometry lands when the animation ends.
+    if (from.size() != to.size()) w->setGeometry(to);
+    else                          m_table.commitRect[row] = to;
+    w->setVisualGeometry(from);
+}
 
-    connect(wa->anim.get(), &QVariantAnimation::valueChanged,
-            this, [w, from, to](const QVariant& v) {
-                const float t = AnimationEngine::easeOutCubic(v.toFloat());
-                QRect cur;
-                cur.setX(     (int)(from.x()      * (1-t) + to.x()      * t));
-                cur.setY(     (int)(from.y()      * (1-t) + to.y()      * t));
-                cur.setWidth( (int)(from.width()  * (1-t) + to.width()  * t));
-                cur.setHeight((int)(from.height() * (1-t) + to.height() * t));
-                w->setGeometry(cur);
-            });
+// ─────────────────────────────────────────────────────────────────────────────
+// Workspace switch
+// ─────────────────────────────────────────────────────────────────────────────
 
-    connect(wa->anim.get(), &QVariantAnimation::finished,
-            this, [this, w, to]() {
-                w->setGeometry(to);
-                cancelAnimation(w);
-                emit animationFinished(w, AnimationType::WindowMove);
-            });
+void AnimationEngine::animateWorkspaceSwitch(std::function<void(float t)> ticker,
+                                             std::function<void()>        onDone) {
+    if (!m_enabled || !Config::instance().animationsEnabled()) {
+        if (ticker) ticker(1.0f);
+        if (onDone) onDone();
+        return;
+    }
 
-    m_animations.insert(w, wa);
-    wa->anim->start();
+    const int row = startAnimation(nullptr, AnimationType::WorkspaceSwitch,
+                                   Config::instance().anim.workspaceSwitchMs,
+                                   EasingLUT::builtin(EasingCurve::EaseOutQuint));
+    m_table.ticker[row]     = std::move(ticker);
+    m_table.onFinished[row] = std::move(onDone);
 }
 
 // ─────────────────────────────────────────────────────────────────────────────
-// Opacity
+// Opacity / custom
 // ─────────────────────────────────────────────────────────────────────────────
 
-// Header declares: void animateOpacity(Window*, float, float, int, EasingCurve)
 void AnimationEngine::animateOpacity(Window* w, float from, float to, int ms,
                                      EasingCurve curve) {
-    auto* anim = new QVariantAnimation(this);
-    anim->setStartValue(from);
-    anim->setEndValue(to);
-    anim->setDuration(ms);
-
-    connect(anim, &QVariantAnimation::valueChanged,
-            this, [w, curve, from, to](const QVariant& v) {
-                float raw = v.toFloat();
-                float t   = raw;
-                switch (curve) {
-                    case EasingCurve::EaseOutCubic: t = AnimationEngine::easeOutCubic(raw); break;
-                    case EasingCurve::EaseInCubic:  t = AnimationEngine::easeInCubic(raw);  break;
-                    case EasingCurve::EaseOutBack:  t = AnimationEngine::easeOutBack(raw);  break;
-                    case EasingCurve::Spring:       t = AnimationEngine::spring(raw);       break;
-                    default: break;
-                }
-                w->setOpacity(from + (to - from) * t);
-            });
-
-    connect(anim, &QVariantAnimation::finished, anim, &QObject::deleteLater);
-    anim->start();
-                                     }
+    if (!m_enabled || !Config::instance().animationsEnabled()) {
+        w->setOpacity(to);
+        return;
+    }
+
+    const int row = startAnimation(w, to >= from ? AnimationType::FadeIn
+                                                 : AnimationType::FadeOut,
+                                   ms, EasingLUT::builtin(curve));
+    m_table.fromOpacity[row] = from;
+    m_table.toOpacity[row]   = to;
+}
+
+void AnimationEngine::animateCustom(Window*                      w,
+                                    int                          durationMs,
+                                    EasingCurve                  easing,
+                                    std::function<void(float t)> ticker,
+                                    std::function<void()>        onDone) {
+    const int row = startAnimation(w, AnimationType::Custom, durationMs,
+                                   EasingLUT::builtin(easing));
+    m_table.ticker[row]     = std::move(ticker);
+    m_table.onFinished[row] = std::move(onDone);
+}
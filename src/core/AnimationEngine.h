@@ -6,9 +6,10 @@
 #include <QList>
 #include <QElapsedTimer>
 #include <functional>
-#include <memory>
 
-class QVariantAnimation;
+#include "Easing.h"
+
+class QTimer;
 class Window;
 
 // ─────────────────────────────────────────────────────────────────────────────
@@ -30,60 +31,45 @@ enum class AnimationType {
 };
 
 // ─────────────────────────────────────────────────────────────────────────────
-// EasingCurve
+// AnimationTable
 //
-// Named easing functions available to callers.  The engine maps these to the
-// actual mathematical functions in AnimationEngine::evaluate().
+// Structure-of-arrays store for every in-flight animation.  Row i of each
+// column belongs to the same animation.  Rows are removed by moving the last
+// row into the hole, so the columns stay dense and AnimationEngine::tick()
+// walks them in one linear pass.  Owned exclusively by AnimationEngine.
 // ─────────────────────────────────────────────────────────────────────────────
-enum class EasingCurve {
-    Linear,         ///< f(t) = t
-    EaseInCubic,    ///< f(t) = t³  — starts slow, accelerates
-    EaseOutCubic,   ///< f(t) = 1-(1-t)³  — decelerates into target
-    EaseInOutCubic, ///< Symmetric S-curve
-    EaseOutBack,    ///< Overshoots slightly, then settles
-    Spring,         ///< Damped oscillation — the HackerLand WM signature feel
-    EaseOutQuint,   ///< Very fast deceleration (workspace switch)
-    EaseInQuart     ///< Fast acceleration (window close)
-};
-
-// ─────────────────────────────────────────────────────────────────────────────
-// WindowAnimation
-//
-// All state needed to drive a single per-window animation.
-// Owned exclusively by AnimationEngine via the m_animations hash.
-// ─────────────────────────────────────────────────────────────────────────────
-struct WindowAnimation {
+struct AnimationTable {
     // ── What is being animated ────────────────────────────────────────────
-    AnimationType type    = AnimationType::WindowMove;
-
-    // ── Geometry interpolation ────────────────────────────────────────────
-    QRect  fromGeometry;
-    QRect  toGeometry;
+    QList<Window*>       window;
+    QList<AnimationType> type;
 
-    // ── Opacity interpolation ─────────────────────────────────────────────
-    float  fromOpacity    = 1.0f;
-    float  toOpacity      = 1.0f;
+    // ── Timing (engine clock, ms) ─────────────────────────────────────────
+    QList<qint64>        startMs;
+    QList<int>           durationMs;
+    QList<const EasingLUT*> curve;    ///< Built-in or config-baked table
 
-    // ── Scale interpolation (for open / close) ────────────────────────────
-    float  fromScale      = 1.0f;
-    float  toScale        = 1.0f;
+    // ── Interpolated properties ───────────────────────────────────────────
+    QList<QRect>         fromRect;
+    QList<QRect>         toRect;
+    QList<float>         fromOpacity;
+    QList<float>         toOpacity;
 
-    // ── Timing ────────────────────────────────────────────────────────────
-    int    durationMs     = 250;
-    EasingCurve easing    = EasingCurve::EaseOutCubic;
+    /// Geometry to commit when the row finishes; invalid if the real
+    /// geometry was already set when the animation started.
+    QList<QRect>         commitRect;
 
-    // ── Qt animation driver ───────────────────────────────────────────────
-    std::unique_ptr<QVariantAnimation> anim;
+    // ── Callbacks (empty for most rows) ───────────────────────────────────
+    QList<std::function<void(float)>> ticker;       ///< Custom rows only
+    QList<std::function<void()>>      onFinished;
 
-    // ── Completion callback ───────────────────────────────────────────────
-    std::function<void()> onFinished;
+    int  size() const { return window.size(); }
 
-    WindowAnimation() = default;
-    ~WindowAnimation() = default;
+    /// Append a row with neutral values; returns its index.
+    int  append(Window* w, AnimationType t, qint64 start, int duration,
+                const EasingLUT* curve);
 
-    // Non-copyable — unique_ptr member prevents it anyway.
-    WindowAnimation(const WindowAnimation&)            = delete;
-    WindowAnimation& operator=(const WindowAnimation&) = delete;
+    /// Remove \p row by moving the last row into its place.
+    void removeAt(int row);
 };
 
 // ─────────────────────────────────────────────────────────────────────────────
@@ -92,31 +78,35 @@ struct WindowAnimation {
 // Drives all window and workspace animations in HackerLand WM.
 //
 // Design
-//   • One QVariantAnimation per animated window, stored in m_animations.
-//   • Each animation runs a t ∈ [0,1] progress value through the configured
-//     easing function, then applies the resulting interpolated geometry and
-//     opacity to the Window model.
-//   • WMOutput reads Window::geometry() and Window::opacity() every frame —
-//     it does not need to know about animations at all.
-//   • cancelAnimation() is always safe to call; it stops and deletes any
-//     in-flight animation for the given window.
-//   • A new animation on a window that is already animating cancels the
-//     previous one first (no queuing).
-//
-// Spring physics
-//   The signature "spring" easing used for WindowOpen and most tiling
-//   rearrangements is a critically-under-damped oscillator:
-//
-//       f(t) = 1 − e^(−ζωt) · cos(ω√(1−ζ²) · t)
+//   • Every running animation is a row in one AnimationTable, keyed by
+//     window through m_rows (the workspace switch row uses nullptr).  No QObject or timer per animation.
+//   • tick(presentMs) is driven by the output's frame clock: it samples
+//     every row at the time the frame will be presented, applies the
+//     interpolated opacity and visual rect to the Window model, retires
+//     finished rows and emits frameReady() once.
+//   • Geometry animations are visual only: a frame sets
+//     Window::setVisualGeometry(), never setGeometry(), so there is no
+//     geometryChanged(), no hit-test update, no blur re-bake and no client
+//     configure per frame.  The real geometry is set once — at the start
+//     when the size changes (the client gets one configure and draws at the
+//     final size while its frame is scaled into place), otherwise at the
+//     end.  WMOutput draws geometry() mapped onto visualGeometry().
+//   • Without an output driving tick() (headless, output hidden) a single
+//     fallback timer keeps animations — and their completion callbacks —
+//     moving.
+//   • cancelAnimation() is always safe to call; it drops the window's row.
+//   • A new animation on a window that is already animating replaces the
+//     previous one (no queuing).
 //
-//   with ζ = 0.55 (damping ratio) and ω = 2π × 1.5 (natural frequency).
-//   This produces a gentle overshoot followed by quick settle — the same
-//   feel used by niri, Hyprland, and macOS Genie.
+// Easing
+//   Every curve is an EasingLUT: built-ins are baked at compile time, and
+//   AnimConfig::openEasing / closeEasing (CSS cubic-bezier() or a curve
+//   name) are baked when the config loads.  The default open curve is the
+//   signature spring-like overshoot; an unparsable value falls back to the
+//   built-in Spring / EaseInCubic.
 //
 // Thread safety
 //   All methods must be called on the compositor (main GUI) thread.
-//   QVariantAnimation internally uses the Qt timer system and emits signals
-//   on the thread it was started on.
 // ─────────────────────────────────────────────────────────────────────────────
 class AnimationEngine : public QObject {
     Q_OBJECT
@@ -130,11 +120,12 @@ public:
 
     /// Animate a window appearing for the first time.
     /// Scales from Config::anim.scaleFactor → 1.0 and fades from 0 → 1
-    /// using a spring easing over Config::anim.windowOpenMs milliseconds.
+    /// along Config::anim.openEasing over Config::anim.windowOpenMs
+    /// milliseconds.
     void animateWindowOpen(Window* w, const QRect& targetGeom);
 
     /// Animate a window being removed.
-    /// Scales toward its centre and fades out using an easeInCubic curve
+    /// Scales toward its centre and fades out along Config::anim.closeEasing
     /// over Config::anim.windowCloseMs milliseconds.
     /// \p onDone is called once the animation completes (use it to call
     /// WMCompositor::removeWindowFromModel()).
@@ -142,21 +133,20 @@ public:
                             std::function<void()> onDone = nullptr);
 
     /// Animate a window moving and/or resizing during a tiling rearrangement.
-    /// Interpolates geometry from \p from → \p to using easeOutCubic over
-    /// Config::anim.tileRearrangeMs milliseconds.
+    /// Interpolates the visual rect from \p from → \p to using easeOutCubic
+    /// over Config::anim.tileRearrangeMs milliseconds.  Pass the window's
+    /// visualGeometry() as \p from to retarget a running animation smoothly.
     void animateWindowMove(Window* w,
                            const QRect& from,
                            const QRect& to);
 
-    /// Animate a workspace switch.
-    /// All windows on the departing workspace slide out in \p direction
-    /// while windows on the arriving workspace slide in from the opposite
-    /// side over Config::anim.workspaceSwitchMs milliseconds.
-    /// \p direction: "left", "right", "up", "down"
-    void animateWorkspaceSwitch(const QList<Window*>& departing,
-                                const QList<Window*>& arriving,
-                                const QString&        direction,
-                                const QRect&          outputRect);
+    /// Drive a workspace switch over Config::anim.workspaceSwitchMs
+    /// milliseconds (easeOutQuint).  The engine only supplies progress —
+    /// \p ticker moves the output's two offscreen workspace snapshots, so
+    /// no window is touched per frame.  Not tied to a window: a new switch
+    /// replaces a running one, and cancelAll() drops it.
+    void animateWorkspaceSwitch(std::function<void(float t)> ticker,
+                                std::function<void()>        onDone = nullptr);
 
     /// Animate opacity from \p from → \p to over \p ms milliseconds using
     /// the given easing curve.  Useful for focus / unfocus transitions.
@@ -188,8 +178,22 @@ public:
     /// True if \p w has an in-flight animation.
     bool isAnimating(Window* w) const;
 
+    /// Where \p w's in-flight open or move animation ends, or a null QRect
+    /// if it has none.
+    QRect targetOf(Window* w) const;
+
     /// Number of currently active animations.
-    int  activeCount() const { return m_animations.size(); }
+    int  activeCount() const { return m_table.size(); }
+
+    // ── Frame clock ───────────────────────────────────────────────────────
+
+    /// Milliseconds on the engine clock; animation start times use it.
+    qint64 now() const { return m_clock.elapsed(); }
+
+    /// Advance every animation to \p presentMs (engine clock) — the time the
+    /// frame being prepared will reach the screen.  Called by the output at
+    /// the top of each render tick; emits frameReady() if anything moved.
+    void tick(qint64 presentMs);
 
     // ── Global enable / disable ───────────────────────────────────────────
 
@@ -198,11 +202,15 @@ public:
 
     // ── Easing evaluation (public for use by WMOutput render effects) ─────
 
-    /// Evaluate easing function \p curve at normalised time \p t ∈ [0, 1].
-    /// Returns a value in approximately [0, 1] (some curves overshoot slightly).
-    static float evaluate(EasingCurve curve, float t);
+    /// Evaluate built-in curve \p curve at normalised time \p t ∈ [0, 1].
+    /// Table lookup — returns a value in approximately [0, 1] (some curves
+    /// overshoot slightly).
+    static float evaluate(EasingCurve curve, float t) {
+        return EasingLUT::builtin(curve).sample(t);
+    }
 
     // ── String ↔ enum helpers ─────────────────────────────────────────────
+    /// Unknown names map to EaseOutCubic.
     static EasingCurve easingFromString(const QString& s);
     static QString     easingToString(EasingCurve e);
 
@@ -214,33 +222,25 @@ signals:
     /// WMOutput connects to this to trigger a repaint without polling.
     void frameReady();
 
+private slots:
+    void onFallbackTick();
+    void onConfigReloaded();
+
 private:
     // ── Internal animation builder ────────────────────────────────────────
 
-    /// Construct and start a WindowAnimation for \p w.
-    /// Any existing animation for \p w is cancelled first.
-    WindowAnimation* startAnimation(Window*       w,
-                                    AnimationType type,
-                                    int           durationMs,
-                                    EasingCurve   easing);
+    /// Add a row for \p w starting now, replacing any existing row for it.
+    /// Also makes sure the fallback clock is running.  Returns the row.
+    int  startAnimation(Window*          w,
+                        AnimationType    type,
+                        int              durationMs,
+                        const EasingLUT& curve);
 
-    // ── Per-frame tick (called by QVariantAnimation::valueChanged) ────────
+    /// Drop row \p row and fix up m_rows for the row moved into its place.
+    void removeRow(int row);
 
-    /// Apply interpolated geometry + opacity to \p w for raw progress \p raw.
-    void applyFrame(Window* w, WindowAnimation* wa, float raw);
-
-    // ── Easing implementations ────────────────────────────────────────────
-    // These are the raw mathematical functions; prefer evaluate() from
-    // outside the class.
-
-    static float linear       (float t);
-    static float easeInCubic  (float t);
-    static float easeOutCubic (float t);
-    static float easeInOutCubic(float t);
-    static float easeOutBack  (float t);
-    static float spring       (float t);
-    static float easeOutQuint (float t);
-    static float easeInQuart  (float t);
+    /// Apply row \p row's properties to its window for eased progress \p t.
+    void applyRow(int row, float t);
 
     // ── Geometry / opacity interpolation helpers ──────────────────────────
 
@@ -252,19 +252,30 @@ private:
 
     // ── Members ───────────────────────────────────────────────────────────
 
-    /// Active animations keyed by Window*.
-    /// WindowAnimation is heap-allocated so its address is stable while
-    /// lambdas captured in QVariantAnimation::valueChanged hold a raw pointer.
-    QHash<Window*, WindowAnimation*> m_animations;
+    AnimationTable        m_table;
+    QHash<Window*, int>   m_rows;       ///< Window → row in m_table.
+
+    QElapsedTimer         m_clock;
+    qint64                m_lastTickMs = -1;  ///< Engine time of the last tick().
+    QTimer*               m_fallback   = nullptr;
+
+    // Finished rows are collected during tick() and their callbacks run
+    // after the loop, since a callback may start another animation.
+    struct Finished {
+        Window*               window;
+        AnimationType         type;
+        QRect                 commitRect;
+        std::function<void()> onFinished;
+    };
+    QList<Finished>       m_finished;
 
     bool m_enabled = true;
 
-    // ── Spring physics constants ──────────────────────────────────────────
-    static constexpr float kSpringZeta  = 0.55f;  ///< Damping ratio  ζ
-    static constexpr float kSpringOmega = 9.42f;  ///< Natural freq   ω = 2π·1.5
-    // kSpringOmega = 2 * M_PI * 1.5 ≈ 9.4248
+    // AnimConfig curves, re-baked on config reload.  Rows point at these,
+    // so an in-flight animation picks up the new curve on its next tick.
+    EasingLUT m_openCurve  = EasingLUT::builtin(EasingCurve::Spring);
+    EasingLUT m_closeCurve = EasingLUT::builtin(EasingCurve::EaseInCubic);
 
-    // ── easeOutBack overshoot constant ───────────────────────────────────
-    static constexpr float kBackC1 = 1.70158f;
-    static constexpr float kBackC3 = kBackC1 + 1.0f; // = 2.70158
+    /// Fallback clock period when no output is ticking (~60 Hz).
+    static constexpr int kFallbackIntervalMs = 16;
 };
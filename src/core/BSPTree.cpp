@@ -0,0 +1,333 @@
+#include "BSPTree.h"
+#include "Window.h"
+
+#include <QSet>
+#include <QDebug>
+#include <utility>
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Construction / destruction
+// ─────────────────────────────────────────────────────────────────────────────
+
+BSPTree::~BSPTree() {
+    delete m_root;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Membership
+// ─────────────────────────────────────────────────────────────────────────────
+
+void BSPTree::insert(Window* w, Window* at) {
+    if (!w || m_leaves.contains(w)) return;
+
+    auto* leaf   = new BSPNode();
+    leaf->window = w;
+    leaf->live   = 1;
+    m_leaves.insert(w, leaf);
+    ++m_generation;
+
+    if (!m_root) {
+        m_root       = leaf;
+        m_root->rect = m_area;
+        markDirty(m_root);
+        return;
+    }
+
+    BSPNode* target = m_leaves.value(at, nullptr);
+    if (!target || target == leaf) target = rightmostLeaf();
+
+    // The target leaf keeps its node (and its m_leaves entry); a new split
+    // node takes its place in the tree with target on the left and the new
+    // window on the right.
+    auto* split   = new BSPNode();
+    split->isLeaf = false;
+    split->split  = splitFor(target);
+    split->ratio  = 0.5f;
+    split->rect   = target->rect;
+    split->parent = target->parent;
+    split->live   = target->live;
+
+    replaceChild(target->parent, target, split);
+    split->left    = target;
+    split->right   = leaf;
+    target->parent = split;
+    leaf->parent   = split;
+    addLive(split, 1);
+
+    // A split of a parked leaf brings a collapsed side back to life
+    markDirty(target->live == 0 ? reflowRoot(split) : split);
+}
+
+void BSPTree::remove(Window* w) {
+    BSPNode* leaf = m_leaves.take(w);
+    if (!leaf) return;
+    ++m_generation;
+
+    forget(leaf);
+
+    if (leaf == m_root) {
+        delete m_root;
+        m_root = nullptr;
+        return;
+    }
+
+    BSPNode* parent  = leaf->parent;
+    BSPNode* sibling = (parent->left == leaf) ? parent->right : parent->left;
+
+    // Sibling inherits the parent's slot and rect
+    sibling->parent = parent->parent;
+    sibling->rect   = parent->rect;
+    replaceChild(parent->parent, parent, sibling);
+    addLive(sibling->parent, -leaf->live);
+
+    forget(parent);
+    parent->left = parent->right = nullptr;
+    delete parent;
+    delete leaf;
+
+    // Removing the last live leaf of a subtree collapses a split above it
+    markDirty(sibling->live == 0 ? reflowRoot(sibling) : sibling);
+}
+
+void BSPTree::swap(Window* a, Window* b) {
+    if (a == b) return;
+    BSPNode* na = m_leaves.value(a, nullptr);
+    BSPNode* nb = m_leaves.value(b, nullptr);
+    if (!na || !nb) return;
+
+    const bool parkedA = na->parked;
+    const bool parkedB = nb->parked;
+
+    na->window = b;
+    nb->window = a;
+    m_leaves.insert(a, nb);
+    m_leaves.insert(b, na);
+    ++m_generation;
+
+    // The parked state belongs to the window, so it moves with it
+    park(na, parkedB);
+    park(nb, parkedA);
+}
+
+bool BSPTree::setParked(Window* w, bool parked) {
+    BSPNode* leaf = m_leaves.value(w, nullptr);
+    if (!leaf || leaf->parked == parked) return false;
+    park(leaf, parked);
+    ++m_generation;
+    return true;
+}
+
+bool BSPTree::sync(const QList<Window*>& windows, Window* focus) {
+    bool changed = false;
+
+    // Common case: every window already has a leaf and there are no extras.
+    // Checked without building a set so steady-state layouts don't allocate.
+    int present = 0;
+    for (Window* w : windows) {
+        if (m_leaves.contains(w)) ++present;
+    }
+
+    if (present != m_leaves.size()) {
+        const QSet<Window*> wanted(windows.cbegin(), windows.cend());
+
+        QList<Window*> stale;
+        for (auto it = m_leaves.cbegin(); it != m_leaves.cend(); ++it) {
+            if (!wanted.contains(it.key())) stale.append(it.key());
+        }
+        for (Window* w : stale) remove(w);
+        changed = !stale.isEmpty();
+    }
+
+    if (present == windows.size()) return changed;
+
+    for (Window* w : windows) {
+        if (m_leaves.contains(w)) continue;
+        insert(w, focus);
+        changed = true;
+    }
+    return changed;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Splits
+// ─────────────────────────────────────────────────────────────────────────────
+
+bool BSPTree::moveSplit(Window* w, Qt::Edge edge, int pos) {
+    BSPNode* child = m_leaves.value(w, nullptr);
+    if (!child) return false;
+
+    const BSPNode::Split axis =
+        (edge == Qt::LeftEdge || edge == Qt::RightEdge)
+        ? BSPNode::Split::Horizontal
+        : BSPNode::Split::Vertical;
+
+    // Right / bottom edge: the window sits in the left child of the split.
+    const bool wantLeft = (edge == Qt::RightEdge || edge == Qt::BottomEdge);
+
+    BSPNode* node = child->parent;
+    while (node) {
+        if (node->split == axis && (node->left == child) == wantLeft) break;
+        child = node;
+        node  = node->parent;
+    }
+    if (!node || node->rect.isEmpty()) return false;
+
+    const float extent = (axis == BSPNode::Split::Horizontal)
+        ? node->rect.width() : node->rect.height();
+    const float offset = (axis == BSPNode::Split::Horizontal)
+        ? pos - node->rect.x() : pos - node->rect.y();
+
+    const float ratio = qBound(0.1f, offset / extent, 0.9f);
+    if (qFuzzyCompare(ratio, node->ratio)) return false;
+
+    node->ratio = ratio;
+    markDirty(node);
+    ++m_generation;
+    return true;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Layout
+// ─────────────────────────────────────────────────────────────────────────────
+
+int BSPTree::layout(const QRect& area) {
+    if (area != m_area) {
+        m_area = area;
+        if (m_root) {
+            m_root->rect = area;
+            markDirty(m_root);
+        }
+    }
+
+    int updated = 0;
+    // An ancestor laid out before one of its descendants clears the
+    // descendant's dirty flag, so nested entries are visited only once.
+    // layoutSubtree() never marks nodes dirty, so m_dirty is stable here
+    // and clear() keeps its capacity for the next pointer event.
+    for (BSPNode* node : std::as_const(m_dirty)) {
+        if (node->dirty) layoutSubtree(node, updated);
+    }
+    m_dirty.clear();
+    return updated;
+}
+
+void BSPTree::layoutSubtree(BSPNode* node, int& updated) {
+    node->dirty = false;
+    if (node->isLeaf) {
+        ++updated;
+        return;
+    }
+
+    const QRect& r = node->rect;
+    if (node->left->live == 0 || node->right->live == 0) {
+        // One side holds only parked leaves: the other gets the whole rect
+        node->left->rect = node->right->rect = r;
+    } else if (node->split == BSPNode::Split::Horizontal) {
+        const int w = (int)(r.width() * node->ratio);
+        node->left->rect  = QRect(r.x(),     r.y(), w,             r.height());
+        node->right->rect = QRect(r.x() + w, r.y(), r.width() - w, r.height());
+    } else {
+        const int h = (int)(r.height() * node->ratio);
+        node->left->rect  = QRect(r.x(), r.y(),     r.width(), h);
+        node->right->rect = QRect(r.x(), r.y() + h, r.width(), r.height() - h);
+    }
+
+    layoutSubtree(node->left,  updated);
+    layoutSubtree(node->right, updated);
+}
+
+QList<const BSPNode*> BSPTree::leaves() const {
+    QList<const BSPNode*> out;
+    leaves(out);
+    return out;
+}
+
+void BSPTree::leaves(QList<const BSPNode*>& out) const {
+    out.clear();
+    out.reserve(m_leaves.size());
+    collectLeaves(m_root, out);
+}
+
+QRect BSPTree::rectFor(Window* w) const {
+    const BSPNode* leaf = m_leaves.value(w, nullptr);
+    return leaf ? leaf->rect : QRect();
+}
+
+Window* BSPTree::firstWindow() const {
+    const BSPNode* n = m_root;
+    while (n && !n->isLeaf) n = n->left;
+    return n ? n->window : nullptr;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Private helpers
+// ─────────────────────────────────────────────────────────────────────────────
+
+void BSPTree::markDirty(BSPNode* node) {
+    if (!node || node->dirty) return;
+    node->dirty = true;
+    m_dirty.append(node);
+}
+
+void BSPTree::park(BSPNode* leaf, bool parked) {
+    if (leaf->parked == parked) return;
+    leaf->parked = parked;
+    addLive(leaf, parked ? -1 : 1);
+    markDirty(reflowRoot(leaf));
+}
+
+BSPNode* BSPTree::reflowRoot(BSPNode* node) const {
+    // \p node just gained its first or lost its last live leaf.  Climb while
+    // the sibling has none either: the split above the highest such node is
+    // the one whose children change size.
+    while (node->parent) {
+        const BSPNode* p       = node->parent;
+        const BSPNode* sibling = (p->left == node) ? p->right : p->left;
+        if (sibling->live != 0) return node->parent;
+        node = node->parent;
+    }
+    return node;
+}
+
+void BSPTree::addLive(BSPNode* node, int delta) {
+    for (; node; node = node->parent) node->live += delta;
+}
+
+void BSPTree::forget(BSPNode* node) {
+    if (node->dirty) m_dirty.removeOne(node);
+}
+
+void BSPTree::replaceChild(BSPNode* parent, BSPNode* from, BSPNode* to) {
+    if (!parent)                   m_root        = to;
+    else if (parent->left == from) parent->left  = to;
+    else                           parent->right = to;
+}
+
+BSPNode* BSPTree::rightmostLeaf() const {
+    BSPNode* n = m_root;
+    while (n && !n->isLeaf) n = n->right;
+    return n;
+}
+
+void BSPTree::collectLeaves(const BSPNode* node, QList<const BSPNode*>& out) {
+    if (!node) return;
+    if (node->isLeaf) {
+        out.append(node);
+        return;
+    }
+    collectLeaves(node->left,  out);
+    collectLeaves(node->right, out);
+}
+
+BSPNode::Split BSPTree::splitFor(const BSPNode* leaf) {
+    // Split along the longer side; before the first layout the leaf has no
+    // rect yet, so alternate with the parent's direction instead.
+    if (!leaf->rect.isEmpty()) {
+        return leaf->rect.width() >= leaf->rect.height()
+            ? BSPNode::Split::Horizontal
+            : BSPNode::Split::Vertical;
+    }
+    if (leaf->parent && leaf->parent->split == BSPNode::Split::Horizontal)
+        return BSPNode::Split::Vertical;
+    return BSPNode::Split::Horizontal;
+}
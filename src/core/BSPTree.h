@@ -0,0 +1,115 @@
+#pragma once
+
+#include <QRect>
+#include <QList>
+#include <QHash>
+#include <Qt>
+
+#include "TilingEngine.h"
+
+class Window;
+
+// ─────────────────────────────────────────────────────────────────────────────
+// BSPTree
+//
+// Persistent binary-space partition owned by a Workspace.  Unlike the
+// stateless balanced split in TilingEngine::layoutBSPRange(), this one
+// survives between tile() calls, so:
+//
+//   • insert() splits the focused leaf in place — O(depth), and only the new
+//     split's subtree needs new rects.
+//   • remove() promotes the sibling into the parent's slot; only the
+//     sibling's subtree is re-laid out.
+//   • Per-split ratios (changed by moveSplit(), e.g. an interactive resize)
+//     are kept across retiles and window churn.
+//   • A minimized window's leaf is parked rather than removed: its sibling
+//     takes the whole parent rect, and restoring it puts the window back in
+//     the same slot.
+//
+// Mutations mark the topmost affected node dirty; layout() recomputes just
+// those subtrees (or everything if the area changed).  Leaves whose rect did
+// not change keep exactly the same QRect, so the compositor neither
+// re-configures nor re-animates them.
+//
+// The tree stores raw partition rects — gaps are applied by TilingEngine.
+// ─────────────────────────────────────────────────────────────────────────────
+class BSPTree {
+public:
+    BSPTree() = default;
+    ~BSPTree();
+
+    BSPTree(const BSPTree&)            = delete;
+    BSPTree& operator=(const BSPTree&) = delete;
+
+    // ── Membership ────────────────────────────────────────────────────────
+    bool isEmpty()             const { return m_leaves.isEmpty(); }
+    int  size()                const { return m_leaves.size(); }
+    bool contains(Window* w)   const { return m_leaves.contains(w); }
+
+    /// Insert \p w by splitting the leaf that holds \p at.  If \p at is not
+    /// in the tree the right-most leaf is split instead.  No-op if \p w is
+    /// already present.
+    void insert(Window* w, Window* at = nullptr);
+
+    /// Remove \p w; its sibling takes over the parent's rect.
+    void remove(Window* w);
+
+    /// Exchange the slots of two windows.  Rects stay with the slots.
+    void swap(Window* a, Window* b);
+
+    /// Park (\p parked true) or unpark the leaf holding \p w.  A parked leaf
+    /// keeps its place in the tree but gets no share of the area.  Returns
+    /// true if the state changed.
+    bool setParked(Window* w, bool parked);
+
+    /// Bring the leaf set in line with \p windows: leaves not in the list are
+    /// removed, missing windows are inserted at \p focus.  Returns true if
+    /// anything changed.
+    bool sync(const QList<Window*>& windows, Window* focus);
+
+    // ── Splits ────────────────────────────────────────────────────────────
+    /// Move the split bordering \p w on \p edge so that the dividing line
+    /// lands at \p pos (compositor coordinates, x for Left/Right, y for
+    /// Top/Bottom).  Only that split's subtree is marked dirty.  Returns
+    /// false if \p w has no neighbour on that edge or the ratio is unchanged.
+    bool moveSplit(Window* w, Qt::Edge edge, int pos);
+
+    // ── Layout ────────────────────────────────────────────────────────────
+    /// Recompute rects for dirty subtrees inside \p area.  A changed area
+    /// re-lays out the whole tree.  Returns the number of leaves updated.
+    int layout(const QRect& area);
+
+    /// Leaves in left-to-right (in-order) traversal, parked ones included.
+    QList<const BSPNode*> leaves() const;
+    /// Same, into a caller-owned buffer (cleared first, capacity kept).
+    void leaves(QList<const BSPNode*>& out) const;
+
+    /// Partition rect last assigned to \p w (null rect if not in the tree).
+    QRect rectFor(Window* w) const;
+
+    Window* firstWindow() const;
+
+    /// Bumped by every change to the leaf set, slot order, parked state or
+    /// split ratios.
+    /// Part of TilingEngine's layout-cache key.
+    quint64 generation() const { return m_generation; }
+
+private:
+    void     markDirty(BSPNode* node);
+    void     park(BSPNode* leaf, bool parked);
+    void     addLive(BSPNode* node, int delta);
+    BSPNode* reflowRoot(BSPNode* node) const;
+    void     forget(BSPNode* node);
+    void     layoutSubtree(BSPNode* node, int& updated);
+    void     replaceChild(BSPNode* parent, BSPNode* from, BSPNode* to);
+    BSPNode* rightmostLeaf() const;
+
+    static void collectLeaves(const BSPNode* node, QList<const BSPNode*>& out);
+    static BSPNode::Split splitFor(const BSPNode* leaf);
+
+    BSPNode*                  m_root = nullptr;
+    QHash<Window*, BSPNode*>  m_leaves;
+    QList<BSPNode*>           m_dirty;   ///< Roots of subtrees awaiting layout.
+    QRect                     m_area;
+    quint64                   m_generation = 0;
+};
@@ -263,6 +263,19 @@ bool Config::parseTOML(const QString& text) {
         tiling.centerSingleScale= tFloat(s,"center_single_scale", tiling.centerSingleScale);
     }
 
+    // ── [input] ───────────────────────────────────────────────────────────
+    if (doc.contains("input")) {
+        const auto& s      = doc["input"];
+        input.pointerAccel  = tFloat(s, "pointer_accel", input.pointerAccel);
+    }
+
+    // ── [remap] ───────────────────────────────────────────────────────────
+    if (doc.contains("remap")) {
+        const auto& s = doc["remap"];
+        for (auto it = s.constBegin(); it != s.constEnd(); ++it)
+            keys.remaps[it.key()] = it->raw;
+    }
+
     // ── [keybinds] ────────────────────────────────────────────────────────
     if (doc.contains("keybinds")) {
         const auto& s = doc["keybinds"];
@@ -369,6 +382,19 @@ QString Config::serializeTOML() const {
     << "center_single       = "   << (tiling.centerSingle  ? "true":"false") << "\n"
     << "center_single_scale = "   << tiling.centerSingleScale << "\n\n";
 
+    // ── [input] ───────────────────────────────────────────────────────────
+    s << "[input]\n"
+    << "# libinput pointer speed, -1 (slowest) to 1 (fastest); 0 = device default\n"
+    << "pointer_accel = " << input.pointerAccel << "\n\n";
+
+    // ── [remap] ───────────────────────────────────────────────────────────
+    s << "[remap]\n"
+    << "# e.g. CapsLock = \"Super_L\"\n";
+    for (auto it = keys.remaps.constBegin(); it != keys.remaps.constEnd(); ++it) {
+        s << it.key() << " = \"" << it.value() << "\"\n";
+    }
+    s << "\n";
+
     // ── [keybinds] ────────────────────────────────────────────────────────
     s << "[keybinds]\n"
     << "# modifier: Super | Alt | Ctrl\n"
@@ -415,6 +441,7 @@ void Config::setDefaults() {
     anim      = AnimConfig{};
     tiling    = TilingConfig{};
     keys      = KeybindConfig{};
+    input     = InputConfig{};
     m_workspaceCount = 9;
 }
 
@@ -452,8 +479,8 @@ void Config::loadDefaultKeybinds() {
 
     // Layout cycling
     keys.bindings["Space"]        = "layout:cycle";
-    keys.bindings["t"]            = "layout:tiling";
-    keys.bindings["Shift+Space"]  = "layout:float";
+    keys.bindings["t"]            = "layout:spiral";
+    keys.bindings["Shift+Space"]  = "float";
 
     // Workspaces 1–9
     for (int i = 1; i <= 9; ++i) {
@@ -75,12 +75,41 @@ struct KeybindConfig {
     QString modifier          = "Super"; // Super, Alt, Ctrl
     // Actions mapped by key combo string
     QMap<QString, QString> bindings;
+    // Key remaps by name, e.g. "CapsLock" → "Super_L"
+    QMap<QString, QString> remaps;
+};
+
+struct InputConfig {
+    float  pointerAccel       = 0.0f; // libinput pointer speed, -1 … 1; 0 = device default
+};
+
+enum class CompositorMode { Tiling, Cage, Gamescope };
+
+struct CageConfig {
+    QString exec              = "";   // single fullscreen client
+    bool   exitOnClose        = true;
+    bool   allowVt            = true; // Ctrl+Alt+Fn still switches VT
+};
+
+struct GamescopeConfig {
+    QString exec              = "";
+    int    renderW            = 1280;
+    int    renderH            = 720;
+    int    outputW            = 1920;
+    int    outputH            = 1080;
+    int    fpsLimit           = 60;
+    bool   integerScale       = false;
+    bool   fullscreen         = true;
+    bool   borderless         = true;
+    QString filter            = "linear"; // linear, nearest, fsr
+    bool   exitOnClose        = true;
 };
 
 class Config : public QObject {
     Q_OBJECT
 public:
     static Config& instance();
+    static QString defaultConfigPath();
 
     bool load(const QString& path = QString());
     bool reload();
@@ -91,6 +120,11 @@ public:
     AnimConfig    anim;
     TilingConfig  tiling;
     KeybindConfig keys;
+    InputConfig   input;
+
+    CompositorMode  mode = CompositorMode::Tiling;
+    CageConfig      cage;
+    GamescopeConfig gamescope;
 
     int  workspaceCount() const { return m_workspaceCount; }
     bool animationsEnabled() const { return anim.enabled; }
@@ -103,6 +137,8 @@ signals:
 private:
     Config();
     void loadDefaultKeybinds();
+    bool parseTOML(const QString& text);
+    QString serializeTOML() const;
 
     int m_workspaceCount = 9;
     QString m_loadedPath;
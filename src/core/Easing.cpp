@@ -0,0 +1,143 @@
+#include "Easing.h"
+
+#include <QStringList>
+#include <QtMath>
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Built-in tables — computed by the compiler
+// ─────────────────────────────────────────────────────────────────────────────
+
+namespace {
+
+constexpr std::array<EasingLUT, kEasingCurveCount> bakeBuiltins() {
+    std::array<EasingLUT, kEasingCurveCount> out{};
+    for (int c = 0; c < kEasingCurveCount; ++c) {
+        out[c] = EasingLUT::tabulate([c](double t) {
+            return Easing::analytic(EasingCurve(c), t);
+        });
+    }
+    return out;
+}
+
+constexpr std::array<EasingLUT, kEasingCurveCount> kBuiltin = bakeBuiltins();
+
+struct CurveName {
+    const char* name;
+    EasingCurve curve;
+};
+
+constexpr CurveName kCurveNames[] = {
+    { "linear",            EasingCurve::Linear         },
+    { "ease-in-cubic",     EasingCurve::EaseInCubic    },
+    { "ease-out-cubic",    EasingCurve::EaseOutCubic   },
+    { "ease-in-out-cubic", EasingCurve::EaseInOutCubic },
+    { "ease-out-back",     EasingCurve::EaseOutBack    },
+    { "spring",            EasingCurve::Spring         },
+    { "ease-out-quint",    EasingCurve::EaseOutQuint   },
+    { "ease-in-quart",     EasingCurve::EaseInQuart    },
+};
+
+// One coordinate of a cubic Bézier with P0 = 0 and P3 = 1
+double bezier(double s, double p1, double p2) {
+    const double u = 1.0 - s;
+    return 3.0 * u * u * s * p1 + 3.0 * u * s * s * p2 + s * s * s;
+}
+
+double bezierSlope(double s, double p1, double p2) {
+    const double u = 1.0 - s;
+    return 3.0 * u * u * p1 + 6.0 * u * s * (p2 - p1) + 3.0 * s * s * (1.0 - p2);
+}
+
+// Parameter s with x(s) == x.  x(s) is monotonic for x1, x2 ∈ [0, 1].
+double solveForX(double x, double x1, double x2) {
+    double s = x;
+    for (int i = 0; i < 8; ++i) {
+        const double err = bezier(s, x1, x2) - x;
+        if (qAbs(err) < 1e-7) return s;
+        const double d = bezierSlope(s, x1, x2);
+        if (qAbs(d) < 1e-6) break;
+        s -= err / d;
+    }
+
+    // Flat spot — bisect instead
+    double lo = 0.0, hi = 1.0;
+    s = x;
+    for (int i = 0; i < 40; ++i) {
+        const double v = bezier(s, x1, x2);
+        if (qAbs(v - x) < 1e-7) break;
+        (v < x ? lo : hi) = s;
+        s = 0.5 * (lo + hi);
+    }
+    return s;
+}
+
+} // namespace
+
+// ─────────────────────────────────────────────────────────────────────────────
+// EasingLUT
+// ─────────────────────────────────────────────────────────────────────────────
+
+const EasingLUT& EasingLUT::builtin(EasingCurve c) {
+    const int i = int(c);
+    return kBuiltin[(i >= 0 && i < kEasingCurveCount) ? i : 0];
+}
+
+EasingLUT EasingLUT::cubicBezier(float x1, float y1, float x2, float y2) {
+    x1 = qBound(0.0f, x1, 1.0f);
+    x2 = qBound(0.0f, x2, 1.0f);
+
+    EasingLUT lut;
+    for (int i = 0; i <= kSize; ++i) {
+        const double s = solveForX(double(i) / kSize, x1, x2);
+        lut.m_v[i] = float(bezier(s, y1, y2));
+    }
+    lut.m_v[0]     = 0.0f;
+    lut.m_v[kSize] = 1.0f;
+    return lut;
+}
+
+bool EasingLUT::fromString(const QString& spec, EasingLUT& out) {
+    const QString s = spec.trimmed().toLower();
+
+    if (s.startsWith(QLatin1String("cubic-bezier(")) && s.endsWith(QLatin1Char(')'))) {
+        const QStringList parts = s.mid(13, s.size() - 14).split(QLatin1Char(','));
+        if (parts.size() != 4) return false;
+        float v[4];
+        for (int i = 0; i < 4; ++i) {
+            bool ok = false;
+            v[i] = parts[i].trimmed().toFloat(&ok);
+            if (!ok) return false;
+        }
+        out = cubicBezier(v[0], v[1], v[2], v[3]);
+        return true;
+    }
+
+    // CSS keywords
+    if (s == QLatin1String("ease"))        { out = cubicBezier(0.25f, 0.1f, 0.25f, 1.0f); return true; }
+    if (s == QLatin1String("ease-in"))     { out = cubicBezier(0.42f, 0.0f, 1.0f,  1.0f); return true; }
+    if (s == QLatin1String("ease-out"))    { out = cubicBezier(0.0f,  0.0f, 0.58f, 1.0f); return true; }
+    if (s == QLatin1String("ease-in-out")) { out = cubicBezier(0.42f, 0.0f, 0.58f, 1.0f); return true; }
+
+    EasingCurve c;
+    if (!curveFromString(s, c)) return false;
+    out = builtin(c);
+    return true;
+}
+
+bool EasingLUT::curveFromString(const QString& s, EasingCurve& out) {
+    const QString key = s.trimmed().toLower();
+    for (const auto& n : kCurveNames) {
+        if (key == QLatin1String(n.name)) {
+            out = n.curve;
+            return true;
+        }
+    }
+    return false;
+}
+
+QString EasingLUT::curveToString(EasingCurve c) {
+    for (const auto& n : kCurveNames) {
+        if (n.curve == c) return QString::fromLatin1(n.name);
+    }
+    return QStringLiteral("linear");
+}
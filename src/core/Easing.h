@@ -0,0 +1,167 @@
+#pragma once
+
+#include <QString>
+#include <array>
+
+// ─────────────────────────────────────────────────────────────────────────────
+// EasingCurve
+//
+// Named easing functions available to callers.  Each one has a lookup table
+// baked at compile time (EasingLUT::builtin()); the analytic definitions live
+// in the Easing namespace below and serve only to fill those tables.
+// ─────────────────────────────────────────────────────────────────────────────
+enum class EasingCurve {
+    Linear,         ///< f(t) = t
+    EaseInCubic,    ///< f(t) = t³  — starts slow, accelerates
+    EaseOutCubic,   ///< f(t) = 1-(1-t)³  — decelerates into target
+    EaseInOutCubic, ///< Symmetric S-curve
+    EaseOutBack,    ///< Overshoots slightly, then settles
+    Spring,         ///< Damped oscillation — the HackerLand WM signature feel
+    EaseOutQuint,   ///< Very fast deceleration (workspace switch)
+    EaseInQuart     ///< Fast acceleration (window close)
+};
+
+constexpr int kEasingCurveCount = int(EasingCurve::EaseInQuart) + 1;
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Easing — analytic curve definitions
+//
+// constexpr so the built-in tables are computed by the compiler.  std::exp /
+// std::cos are not constexpr in C++20, hence the small series helpers; they
+// are accurate to ~1e-7 over the ranges the curves use.
+// ─────────────────────────────────────────────────────────────────────────────
+namespace Easing {
+
+constexpr double kPi = 3.14159265358979323846;
+
+constexpr double cexp(double x) {
+    // Halve until |x| ≤ 0.5, Taylor-expand, then square back up
+    int halvings = 0;
+    while (x > 0.5 || x < -0.5) { x *= 0.5; ++halvings; }
+    double term = 1.0, sum = 1.0;
+    for (int n = 1; n < 16; ++n) { term *= x / n; sum += term; }
+    while (halvings-- > 0) sum *= sum;
+    return sum;
+}
+
+constexpr double ccos(double x) {
+    while (x >  kPi) x -= 2.0 * kPi;
+    while (x < -kPi) x += 2.0 * kPi;
+    const double x2 = x * x;
+    double term = 1.0, sum = 1.0;
+    for (int n = 1; n < 14; ++n) {
+        term *= -x2 / ((2 * n - 1) * (2 * n));
+        sum  += term;
+    }
+    return sum;
+}
+
+constexpr double csqrt(double x) {
+    double r = x > 1.0 ? x : 1.0;
+    for (int i = 0; i < 32; ++i) r = 0.5 * (r + x / r);
+    return r;
+}
+
+// ── Spring physics constants ──────────────────────────────────────────────
+constexpr double kSpringZeta  = 0.55;                 ///< Damping ratio  ζ
+constexpr double kSpringOmega = 2.0 * kPi * 1.5;      ///< Natural freq   ω
+
+// ── easeOutBack overshoot constant ───────────────────────────────────────
+constexpr double kBackC1 = 1.70158;
+constexpr double kBackC3 = kBackC1 + 1.0;
+
+constexpr double linear(double t)       { return t; }
+constexpr double easeInCubic(double t)  { return t * t * t; }
+constexpr double easeOutCubic(double t) { const double u = t - 1.0; return 1.0 + u * u * u; }
+constexpr double easeInOutCubic(double t) {
+    if (t < 0.5) return 4.0 * t * t * t;
+    const double u = -2.0 * t + 2.0;
+    return 1.0 - u * u * u / 2.0;
+}
+constexpr double easeOutBack(double t) {
+    const double u = t - 1.0;
+    return 1.0 + kBackC3 * u * u * u + kBackC1 * u * u;
+}
+constexpr double spring(double t) {
+    // f(t) = 1 − e^(−ζωt) · cos(ω√(1−ζ²) · t)
+    if (t >= 1.0) return 1.0;
+    return 1.0 - cexp(-kSpringZeta * kSpringOmega * t)
+               * ccos(kSpringOmega * csqrt(1.0 - kSpringZeta * kSpringZeta) * t);
+}
+constexpr double easeOutQuint(double t) { const double u = 1.0 - t; return 1.0 - u * u * u * u * u; }
+constexpr double easeInQuart(double t)  { return t * t * t * t; }
+
+constexpr double analytic(EasingCurve c, double t) {
+    switch (c) {
+        case EasingCurve::Linear:         return linear(t);
+        case EasingCurve::EaseInCubic:    return easeInCubic(t);
+        case EasingCurve::EaseOutCubic:   return easeOutCubic(t);
+        case EasingCurve::EaseInOutCubic: return easeInOutCubic(t);
+        case EasingCurve::EaseOutBack:    return easeOutBack(t);
+        case EasingCurve::Spring:         return spring(t);
+        case EasingCurve::EaseOutQuint:   return easeOutQuint(t);
+        case EasingCurve::EaseInQuart:    return easeInQuart(t);
+    }
+    return t;
+}
+
+} // namespace Easing
+
+// ─────────────────────────────────────────────────────────────────────────────
+// EasingLUT
+//
+// A curve sampled at kSize + 1 evenly spaced points over t ∈ [0, 1].
+// sample() is a clamp, one multiply and a linear interpolation between two
+// neighbouring entries — no transcendental calls and no branch on the curve
+// kind, so the animation tick costs the same whatever the user configured.
+//
+// Built-in curves are baked at compile time.  CSS cubic-bezier() curves from
+// the config are baked once at load time (Newton's method on x(s) per entry).
+// ─────────────────────────────────────────────────────────────────────────────
+class EasingLUT {
+public:
+    static constexpr int kSize = 512;
+
+    constexpr EasingLUT() {
+        for (int i = 0; i <= kSize; ++i) m_v[i] = float(i) / kSize;
+    }
+
+    /// Eased value at \p t, clamped to [0, 1] first.
+    float sample(float t) const {
+        t = t < 0.0f ? 0.0f : (t > 1.0f ? 1.0f : t);
+        const float x = t * kSize;
+        int         i = int(x);
+        if (i >= kSize) i = kSize - 1;
+        const float f = x - float(i);
+        return m_v[i] + (m_v[i + 1] - m_v[i]) * f;
+    }
+
+    /// Table for one of the built-in curves (compile-time constant).
+    static const EasingLUT& builtin(EasingCurve c);
+
+    /// CSS cubic-bezier(x1, y1, x2, y2).  x1 / x2 are clamped to [0, 1] as
+    /// the CSS spec requires; y may overshoot.
+    static EasingLUT cubicBezier(float x1, float y1, float x2, float y2);
+
+    /// Parse "cubic-bezier(a, b, c, d)", a CSS keyword (linear, ease,
+    /// ease-in, ease-out, ease-in-out) or a built-in curve name (see
+    /// curveFromString()).  Returns false and leaves \p out untouched if
+    /// \p spec is not understood.
+    static bool fromString(const QString& spec, EasingLUT& out);
+
+    // ── Built-in curve names ("spring", "ease-out-back", …) ──────────────
+    static bool    curveFromString(const QString& s, EasingCurve& out);
+    static QString curveToString(EasingCurve c);
+
+    /// Tabulate an arbitrary constexpr curve.
+    template <typename F>
+    static constexpr EasingLUT tabulate(F f) {
+        EasingLUT lut;
+        for (int i = 0; i <= kSize; ++i)
+            lut.m_v[i] = float(f(double(i) / kSize));
+        return lut;
+    }
+
+private:
+    std::array<float, kSize + 1> m_v{};
+};
@@ -1,84 +1,327 @@
 #include "GamepadHandler.h"
 
+#include <QSocketNotifier>
+#include <QDir>
 #include <QDebug>
+
+#include <cerrno>
+#include <cstring>
 #include <fcntl.h>
 #include <unistd.h>
-#include <linux/joystick.h>
-
-// Standard Linux joystick button map (PS/Xbox layout)
-// BTN 0=A/Cross  1=B/Circle  2=X/Square  3=Y/Tri
-// BTN 4=L1  5=R1  6=L2  7=R2  8=Select  9=Start
-const QHash<int,QString> GamepadHandler::s_buttonMap = {
-    {4, "workspace:prev"},  // L1
-    {5, "workspace:next"},  // R1
-    {8, "close"},           // Select
-    {9, "exec:alacritty"},  // Start → terminal
-    {0, "focus:right"},     // A
-    {3, "focus:left"},      // Y
-    {1, "focus:down"},      // B
-    {2, "focus:up"},        // X
+#include <sys/ioctl.h>
+#include <linux/input.h>
+#include <libudev.h>
+
+// Standard evdev gamepad codes (Linux gamepad spec — PS/Xbox layout)
+// BTN_SOUTH=A/Cross  BTN_EAST=B/Circle  BTN_WEST=X/Square  BTN_NORTH=Y/Tri
+const QHash<int,Action> GamepadHandler::s_buttonMap = {
+    {BTN_TL,     Action(ActionOp::WorkspacePrev)},            // L1
+    {BTN_TR,     Action(ActionOp::WorkspaceNext)},            // R1
+    {BTN_START,  Action::parse("exec:alacritty")},            // Start → terminal
+    {BTN_SOUTH,  Action(ActionOp::Focus, ActionDir::Right)},  // A
+    {BTN_NORTH,  Action(ActionOp::Focus, ActionDir::Left)},   // Y
+    {BTN_EAST,   Action(ActionOp::Focus, ActionDir::Down)},   // B
+    {BTN_WEST,   Action(ActionOp::Focus, ActionDir::Up)},     // X
 };
 
-GamepadHandler::GamepadHandler(QObject* parent) : QObject(parent) {
-    m_timer = new QTimer(this);
-    m_timer->setInterval(16); // poll at ~60Hz
-    connect(m_timer, &QTimer::timeout, this, &GamepadHandler::readEvents);
+namespace {
+
+bool testBit(const unsigned long* bits, int bit) {
+    constexpr int kLongBits = int(sizeof(unsigned long) * 8);
+    return bits[bit / kLongBits] & (1UL << (bit % kLongBits));
+}
+
+// Without udev we cannot read ID_INPUT_JOYSTICK; ask the device instead
+bool looksLikeGamepad(int fd) {
+    unsigned long keys[KEY_MAX / (sizeof(unsigned long) * 8) + 1] = {};
+    if (::ioctl(fd, EVIOCGBIT(EV_KEY, sizeof(keys)), keys) < 0) return false;
+    return testBit(keys, BTN_GAMEPAD) || testBit(keys, BTN_JOYSTICK);
 }
 
+bool isEventNode(const QString& node) {
+    return node.startsWith(QLatin1String("/dev/input/event"));
+}
+
+} // namespace
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Pad — one open device
+// ─────────────────────────────────────────────────────────────────────────────
+
+struct GamepadHandler::Pad {
+    int              fd       = -1;
+    QString          node;
+    QString          name;
+    QSocketNotifier* notifier = nullptr;
+    QTimer*          repeat   = nullptr;
+
+    // read() may stop mid-record; the tail waits here for the rest
+    alignas(input_event) char buf[64 * sizeof(input_event)];
+    int   buffered = 0;
+
+    bool  selectHeld = false;
+
+    // Direction inputs — the d-pad wins over the stick
+    int   hatX = 0, hatY = 0;          ///< -1 / 0 / 1 (hat axes or BTN_DPAD_*)
+    bool  dpadLeft = false, dpadRight = false, dpadUp = false, dpadDown = false;
+    float stickX = 0.f, stickY = 0.f;  ///< Left stick, -1 … 1
+    bool  dirty  = false;              ///< Direction input changed since SYN_REPORT
+
+    struct Range { int min = -32768; int max = 32767; } rangeX, rangeY;
+
+    int   held = -1;                   ///< ActionDir being repeated, -1 = none
+
+    ~Pad() {
+        // Either may be the sender we are being removed from — defer
+        if (notifier) { notifier->setEnabled(false); notifier->deleteLater(); }
+        if (repeat)   { repeat->stop();              repeat->deleteLater();   }
+        if (fd >= 0) ::close(fd);
+    }
+
+    static float normalise(int v, const Range& r) {
+        if (r.max <= r.min) return 0.f;
+        return 2.f * float(v - r.min) / float(r.max - r.min) - 1.f;
+    }
+};
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Lifetime
+// ─────────────────────────────────────────────────────────────────────────────
+
+GamepadHandler::GamepadHandler(QObject* parent) : QObject(parent) {}
+
 GamepadHandler::~GamepadHandler() { stop(); }
 
 bool GamepadHandler::start() {
-    // Try js0 through js3
-    for (int i = 0; i < 4; ++i) {
-        const QString path = QString("/dev/input/js%1").arg(i);
-        m_fd = ::open(path.toLocal8Bit().constData(), O_RDONLY | O_NONBLOCK);
-        if (m_fd >= 0) {
-            qInfo() << "[Gamepad] opened" << path;
-            m_timer->start();
-            return true;
-        }
+    m_udev = udev_new();
+    if (!m_udev) {
+        // No udev — take what is plugged in now, no hotplug
+        qWarning() << "[Gamepad] udev unavailable, hotplug disabled";
+        const auto nodes = QDir("/dev/input").entryList({"event*"}, QDir::System);
+        for (const QString& n : nodes) openDevice("/dev/input/" + n);
+        return !m_pads.empty();
+    }
+
+    // ── Monitor first, so nothing plugged in during enumeration is missed ─
+    m_monitor = udev_monitor_new_from_netlink(m_udev, "udev");
+    if (m_monitor) {
+        udev_monitor_filter_add_match_subsystem_devtype(m_monitor, "input", nullptr);
+        udev_monitor_enable_receiving(m_monitor);
+        m_udevNotifier = new QSocketNotifier(udev_monitor_get_fd(m_monitor),
+                                             QSocketNotifier::Read, this);
+        connect(m_udevNotifier, &QSocketNotifier::activated,
+                this, &GamepadHandler::onUdevEvent);
     }
-    qDebug() << "[Gamepad] no joystick device found";
-    return false;
+
+    // ── Pads already connected ────────────────────────────────────────────
+    udev_enumerate* en = udev_enumerate_new(m_udev);
+    udev_enumerate_add_match_subsystem(en, "input");
+    udev_enumerate_add_match_property(en, "ID_INPUT_JOYSTICK", "1");
+    udev_enumerate_scan_devices(en);
+
+    udev_list_entry* entry;
+    udev_list_entry_foreach(entry, udev_enumerate_get_list_entry(en)) {
+        udev_device* dev = udev_device_new_from_syspath(m_udev,
+                                                        udev_list_entry_get_name(entry));
+        if (!dev) continue;
+        if (const char* node = udev_device_get_devnode(dev))
+            openDevice(QString::fromLocal8Bit(node));
+        udev_device_unref(dev);
+    }
+    udev_enumerate_unref(en);
+
+    qInfo() << "[Gamepad]" << m_pads.size() << "pad(s),"
+            << (m_monitor ? "watching for hotplug" : "hotplug unavailable");
+    return m_monitor || !m_pads.empty();
 }
 
 void GamepadHandler::stop() {
-    m_timer->stop();
-    if (m_fd >= 0) { ::close(m_fd); m_fd = -1; }
+    m_pads.clear();
+
+    delete m_udevNotifier;
+    m_udevNotifier = nullptr;
+    if (m_monitor) { udev_monitor_unref(m_monitor); m_monitor = nullptr; }
+    if (m_udev)    { udev_unref(m_udev);            m_udev    = nullptr; }
 }
 
-void GamepadHandler::readEvents() {
-    if (m_fd < 0) return;
-    struct js_event ev;
-    while (::read(m_fd, &ev, sizeof(ev)) == sizeof(ev)) {
-        const int type = ev.type & ~JS_EVENT_INIT;
-        if (type == JS_EVENT_BUTTON) handleButton(ev.number, ev.value != 0);
-        if (type == JS_EVENT_AXIS)   handleAxis(ev.number,   ev.value);
+// ─────────────────────────────────────────────────────────────────────────────
+// Devices
+// ─────────────────────────────────────────────────────────────────────────────
+
+void GamepadHandler::openDevice(const QString& node) {
+    if (!isEventNode(node)) return;   // skip legacy js* nodes of the same pad
+    for (const auto& p : m_pads) {
+        if (p->node == node) return;
+    }
+
+    const int fd = ::open(node.toLocal8Bit().constData(),
+                          O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) {
+        qWarning() << "[Gamepad] cannot open" << node << ":" << strerror(errno);
+        return;
+    }
+    if (!m_udev && !looksLikeGamepad(fd)) { ::close(fd); return; }
+
+    char name[256] = {};
+    if (::ioctl(fd, EVIOCGNAME(sizeof(name) - 1), name) < 0) name[0] = '\0';
+    addDevice(fd, node, QString::fromLocal8Bit(name));
+}
+
+void GamepadHandler::addDevice(int fd, const QString& node, const QString& name) {
+    auto pad  = std::make_unique<Pad>();
+    pad->fd   = fd;
+    pad->node = node;
+    pad->name = name.isEmpty() ? node : name;
+
+    // Stick ranges — a pipe has none and keeps the defaults
+    input_absinfo abs{};
+    if (::ioctl(fd, EVIOCGABS(ABS_X), &abs) == 0) pad->rangeX = { abs.minimum, abs.maximum };
+    if (::ioctl(fd, EVIOCGABS(ABS_Y), &abs) == 0) pad->rangeY = { abs.minimum, abs.maximum };
+
+    Pad* p = pad.get();
+    p->notifier = new QSocketNotifier(fd, QSocketNotifier::Read, this);
+    connect(p->notifier, &QSocketNotifier::activated, this, [this, p] { readEvents(p); });
+
+    p->repeat = new QTimer(this);
+    p->repeat->setSingleShot(true);
+    connect(p->repeat, &QTimer::timeout, this, [this, p] {
+        if (p->held < 0) return;
+        emit actionTriggered(Action(ActionOp::Focus, ActionDir(p->held)));
+        p->repeat->start(kRepeatIntervalMs);
+    });
+
+    m_pads.push_back(std::move(pad));
+    qInfo() << "[Gamepad] added" << p->name << "(" << node << ")";
+    emit padAdded(node, p->name);
+}
+
+void GamepadHandler::removeDevice(const QString& node) {
+    for (auto it = m_pads.begin(); it != m_pads.end(); ++it) {
+        if ((*it)->node != node) continue;
+        qInfo() << "[Gamepad] removed" << (*it)->name;
+        m_pads.erase(it);
+        emit padRemoved(node);
+        return;
+    }
+}
+
+void GamepadHandler::onUdevEvent() {
+    udev_device* dev = udev_monitor_receive_device(m_monitor);
+    if (!dev) return;
+
+    const char* action = udev_device_get_action(dev);
+    const char* node   = udev_device_get_devnode(dev);
+    const char* joy    = udev_device_get_property_value(dev, "ID_INPUT_JOYSTICK");
+
+    if (action && node) {
+        const QString n = QString::fromLocal8Bit(node);
+        if (qstrcmp(action, "add") == 0 && joy && qstrcmp(joy, "1") == 0)
+            openDevice(n);
+        else if (qstrcmp(action, "remove") == 0)
+            removeDevice(n);
+    }
+    udev_device_unref(dev);
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Events
+// ─────────────────────────────────────────────────────────────────────────────
+
+void GamepadHandler::readEvents(Pad* pad) {
+    for (;;) {
+        const ssize_t n = ::read(pad->fd, pad->buf + pad->buffered,
+                                 sizeof(pad->buf) - pad->buffered);
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && errno == EAGAIN) return;
+        if (n <= 0) {
+            // ENODEV on unplug (udev usually tells us first), EOF on a pipe
+            removeDevice(pad->node);
+            return;
+        }
+
+        const int total = pad->buffered + int(n);
+        const int count = total / int(sizeof(input_event));
+        const auto* ev  = reinterpret_cast<const input_event*>(pad->buf);
+        for (int i = 0; i < count; ++i) {
+            const input_event& e = ev[i];
+            switch (e.type) {
+                case EV_KEY: handleButton(pad, e.code, e.value != 0); break;  // 2 = autorepeat
+                case EV_ABS: handleAxis  (pad, e.code, e.value);      break;
+                case EV_SYN:
+                    if (e.code == SYN_REPORT && pad->dirty) updateDirection(pad);
+                    break;
+                default: break;
+            }
+        }
+
+        // Keep a partial record for the next read
+        pad->buffered = total - count * int(sizeof(input_event));
+        if (pad->buffered)
+            std::memmove(pad->buf, pad->buf + count * sizeof(input_event), pad->buffered);
     }
 }
 
-void GamepadHandler::handleButton(int button, bool pressed) {
-    if (button == 8) { m_selectHeld = pressed; return; } // Select held
+void GamepadHandler::handleButton(Pad* pad, int code, bool pressed) {
+    bool dpad = true;
+    switch (code) {
+        case BTN_SELECT:     pad->selectHeld = pressed; return;  // Select held
+        case BTN_DPAD_LEFT:  pad->dpadLeft  = pressed; break;
+        case BTN_DPAD_RIGHT: pad->dpadRight = pressed; break;
+        case BTN_DPAD_UP:    pad->dpadUp    = pressed; break;
+        case BTN_DPAD_DOWN:  pad->dpadDown  = pressed; break;
+        default:             dpad = false;             break;
+    }
+    if (dpad) {
+        // Releasing one side leaves the other in effect if it is still held
+        pad->hatX  = int(pad->dpadRight) - int(pad->dpadLeft);
+        pad->hatY  = int(pad->dpadDown)  - int(pad->dpadUp);
+        pad->dirty = true;
+        return;
+    }
 
     if (!pressed) return;
 
     // Select+A = close window
-    if (m_selectHeld && button == 0) {
-        emit actionTriggered("close"); return;
+    if (pad->selectHeld && code == BTN_SOUTH) {
+        emit actionTriggered(Action(ActionOp::Close)); return;
     }
 
-    const QString action = s_buttonMap.value(button);
-    if (!action.isEmpty()) emit actionTriggered(action);
+    const auto it = s_buttonMap.constFind(code);
+    if (it != s_buttonMap.cend()) emit actionTriggered(it.value());
+}
+
+void GamepadHandler::handleAxis(Pad* pad, int code, int value) {
+    switch (code) {
+        case ABS_HAT0X: pad->hatX   = value < 0 ? -1 : (value > 0 ? 1 : 0); break;
+        case ABS_HAT0Y: pad->hatY   = value < 0 ? -1 : (value > 0 ? 1 : 0); break;
+        case ABS_X:     pad->stickX = Pad::normalise(value, pad->rangeX);   break;
+        case ABS_Y:     pad->stickY = Pad::normalise(value, pad->rangeY);   break;
+        default: return;
+    }
+    pad->dirty = true;
 }
 
-void GamepadHandler::handleAxis(int axis, int value) {
-    // D-pad: axis 6 = LR, axis 7 = UD  (value -32767/0/32767)
-    const int thresh = 16000;
-    if (axis == 6) {
-        if (value < -thresh) emit actionTriggered("focus:left");
-        if (value >  thresh) emit actionTriggered("focus:right");
-    } else if (axis == 7) {
-        if (value < -thresh) emit actionTriggered("focus:up");
-        if (value >  thresh) emit actionTriggered("focus:down");
+void GamepadHandler::updateDirection(Pad* pad) {
+    pad->dirty = false;
+
+    int dir = -1;
+    if      (pad->hatX < 0) dir = int(ActionDir::Left);
+    else if (pad->hatX > 0) dir = int(ActionDir::Right);
+    else if (pad->hatY < 0) dir = int(ActionDir::Up);
+    else if (pad->hatY > 0) dir = int(ActionDir::Down);
+    else {
+        // Stick: dominant axis only, outside the deadzone
+        const float ax = qAbs(pad->stickX), ay = qAbs(pad->stickY);
+        if (qMax(ax, ay) > kStickDeadzone) {
+            if (ax >= ay) dir = int(pad->stickX < 0 ? ActionDir::Left : ActionDir::Right);
+            else          dir = int(pad->stickY < 0 ? ActionDir::Up   : ActionDir::Down);
+        }
     }
+
+    if (dir == pad->held) return;
+    pad->held = dir;
+
+    if (dir < 0) { pad->repeat->stop(); return; }
+    emit actionTriggered(Action(ActionOp::Focus, ActionDir(dir)));
+    pad->repeat->start(kRepeatDelayMs);
 }
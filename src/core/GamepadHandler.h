@@ -3,13 +3,30 @@
 #include <QTimer>
 #include <QString>
 #include <QHash>
+#include <memory>
+#include <vector>
+
+#include "Action.h"
+
+class QSocketNotifier;
+struct udev;
+struct udev_monitor;
 
 // ─────────────────────────────────────────────────────────────────────────────
-// GamepadHandler — reads /dev/input/js* or evdev gamepad events
-// and emits actionTriggered() matching WM keybind format.
+// GamepadHandler — evdev gamepads, event driven, hotplugged via udev
+// and emits actionTriggered() for WMCompositor::dispatch().
+//
+// Every pad's /dev/input/event* fd has its own QSocketNotifier, so nothing
+// runs until the kernel has an event for us — no polling timer, no idle
+// wakeups.  A udev monitor adds and removes pads as they are plugged in;
+// any number can be connected at once.
 //
-// Supports: workspace switching (L1/R1), window focus (dpad),
-//           launch terminal (Start), close window (Select+A)
+// Supports: workspace switching (L1/R1), window focus (d-pad, left stick,
+//           face buttons), launch terminal (Start), close window (Select+A)
+//
+// Directions repeat while held (kRepeatDelayMs, then every
+// kRepeatIntervalMs); the stick has a deadzone and only its dominant axis
+// counts.
 // ─────────────────────────────────────────────────────────────────────────────
 class GamepadHandler : public QObject {
     Q_OBJECT
@@ -17,25 +34,50 @@ public:
     explicit GamepadHandler(QObject* parent = nullptr);
     ~GamepadHandler() override;
 
-    bool start();   // opens /dev/input/js0, returns false if not found
+    /// Open every connected gamepad and start watching for hotplug.
+    /// Returns false only if there is no pad and no udev to wait for one.
+    bool start();
     void stop();
-    bool isActive() const { return m_fd >= 0; }
+    bool isActive() const { return !m_pads.empty(); }
+    int  padCount() const { return int(m_pads.size()); }
 
-signals:
-    void actionTriggered(const QString& action);
+    /// Adopt \p fd as a pad.  Anything that yields struct input_event
+    /// records works — start() passes evdev nodes, a test harness can pass
+    /// the read end of a pipe.  Takes ownership of \p fd.
+    void addDevice(int fd, const QString& node, const QString& name);
 
-private slots:
-    void readEvents();
+    /// Close the pad opened from \p node.
+    void removeDevice(const QString& node);
+
+signals:
+    void actionTriggered(const Action& action);
+    void padAdded  (const QString& node, const QString& name);
+    void padRemoved(const QString& node);
 
 private:
-    void handleButton(int button, bool pressed);
-    void handleAxis(int axis, int value);
+    struct Pad;
+
+    void openDevice(const QString& node);
+    void readEvents(Pad* pad);
+    void onUdevEvent();
+
+    void handleButton(Pad* pad, int code, bool pressed);
+    void handleAxis  (Pad* pad, int code, int value);
+
+    /// Recompute \p pad's held direction from d-pad and stick; emits and
+    /// (re)arms repeat on a change.
+    void updateDirection(Pad* pad);
+
+    std::vector<std::unique_ptr<Pad>> m_pads;
 
-    int     m_fd    = -1;
-    QTimer* m_timer = nullptr;
+    udev*            m_udev        = nullptr;
+    udev_monitor*    m_monitor     = nullptr;
+    QSocketNotifier* m_udevNotifier = nullptr;
 
-    bool m_selectHeld = false;
+    // Button → action mapping (evdev BTN_* codes)
+    static const QHash<int,Action> s_buttonMap;
 
-    // Button → action mapping
-    static const QHash<int,QString> s_buttonMap;
+    static constexpr float kStickDeadzone     = 0.5f;  ///< Fraction of half-range
+    static constexpr int   kRepeatDelayMs     = 400;
+    static constexpr int   kRepeatIntervalMs  = 150;
 };
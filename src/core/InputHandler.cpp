@@ -11,8 +11,11 @@
 // ─────────────────────────────────────────────────────────────────────────────
 #include "InputHandler.h"
 #include "Config.h"
+#include "InputRecorder.h"
+#include "LatencyTracer.h"
 #include "Window.h"
 #include "compositor/WMCompositor.h"
+#include "compositor/WMOutput.h"
 #include "compositor/WMSurface.h"
 #include "core/Workspace.h"
 
@@ -31,14 +34,17 @@
 // ─────────────────────────────────────────────────────────────────────────────
 namespace {
 
+    // Bare modifier keys are never the "trigger" key — they are the prefix.
+    bool isModifierKey(int key) {
+        return key == Qt::Key_Shift   || key == Qt::Key_Control ||
+               key == Qt::Key_Alt     || key == Qt::Key_Meta    ||
+               key == Qt::Key_Super_L || key == Qt::Key_Super_R ||
+               key == Qt::Key_Hyper_L || key == Qt::Key_Hyper_R ||
+               key == Qt::Key_AltGr   || key == Qt::Key_CapsLock;
+    }
+
     QString keyName(int key) {
-        // Bare modifier keys are never the "trigger" key — they are the prefix.
-        if (key == Qt::Key_Shift   || key == Qt::Key_Control ||
-            key == Qt::Key_Alt     || key == Qt::Key_Meta    ||
-            key == Qt::Key_Super_L || key == Qt::Key_Super_R ||
-            key == Qt::Key_Hyper_L || key == Qt::Key_Hyper_R ||
-            key == Qt::Key_AltGr   || key == Qt::Key_CapsLock)
-            return {};
+        if (isModifierKey(key)) return {};
 
         switch (key) {
             case Qt::Key_Return:    return "Return";
@@ -71,6 +77,63 @@ namespace {
         return QKeySequence(key).toString();
     }
 
+    // keyName() gives some keys the same name; bindings see them as one.
+    int canonicalKey(int key) {
+        switch (key) {
+            case Qt::Key_Enter:   return Qt::Key_Return;
+            case Qt::Key_Backtab: return Qt::Key_Tab;
+            default:              return key;
+        }
+    }
+
+    // Qt key for a binding's trigger name.  Accepts exactly the names
+    // keyName() produces, so a compiled binding fires for the same presses
+    // it did when bindings were matched as strings.
+    int keyFromName(const QString& name) {
+        static const QHash<QString,int> named = [] {
+            QHash<QString,int> h;
+            const int keys[] = {
+                Qt::Key_Return, Qt::Key_Space,  Qt::Key_Tab,    Qt::Key_Escape,
+                Qt::Key_Backspace, Qt::Key_Delete, Qt::Key_Insert, Qt::Key_Home,
+                Qt::Key_End,    Qt::Key_PageUp, Qt::Key_PageDown, Qt::Key_Left,
+                Qt::Key_Right,  Qt::Key_Up,     Qt::Key_Down,   Qt::Key_Print,
+                Qt::Key_Pause
+            };
+            for (int k : keys)                              h.insert(keyName(k), k);
+            for (int k = Qt::Key_F1; k <= Qt::Key_F35; ++k) h.insert(keyName(k), k);
+            for (int k = Qt::Key_0;  k <= Qt::Key_9;   ++k) h.insert(keyName(k), k);
+            for (int k = Qt::Key_A;  k <= Qt::Key_Z;   ++k) h.insert(keyName(k), k);
+            return h;
+        }();
+
+        const auto it = named.constFind(name);
+        if (it != named.cend()) return it.value();
+
+        const QKeySequence seq = QKeySequence::fromString(name);
+        if (seq.count() != 1) return 0;
+        const int key = seq[0].key();
+        return keyName(key) == name ? key : 0;
+    }
+
+    // Keys that type nothing — Print, Pause, F-keys, media and brightness
+    // keys — are bound on their own; a bare binding for them needs no WM
+    // modifier ("Print" = screenshot).
+    bool isStandaloneKey(int key) {
+        return key == Qt::Key_Print || key == Qt::Key_Pause
+            || (key >= Qt::Key_F1          && key <= Qt::Key_F35)
+            || (key >= Qt::Key_VolumeDown  && key <= Qt::Key_VolumeUp)
+            || (key >= Qt::Key_MediaPlay   && key <= Qt::Key_MediaTogglePlayPause)
+            || key == Qt::Key_MonBrightnessUp || key == Qt::Key_MonBrightnessDown;
+    }
+
+    // Qt modifier bit behind Config::keys.modifier.
+    Qt::KeyboardModifier modifierBit(const QString& mod) {
+        if (mod == "Super" || mod == "Meta")   return Qt::MetaModifier;
+        if (mod == "Alt")                      return Qt::AltModifier;
+        if (mod == "Ctrl"  || mod == "Control") return Qt::ControlModifier;
+        return Qt::NoModifier;
+    }
+
     float pointDist(const QPointF& a, const QPointF& b) {
         const float dx = float(a.x() - b.x()), dy = float(a.y() - b.y());
         return std::sqrt(dx*dx + dy*dy);
@@ -93,6 +156,11 @@ InputHandler::InputHandler(WMCompositor* compositor, QObject* parent)
 {
     reloadBindings();
     reloadKeyRemaps();
+
+    connect(&Config::instance(), &Config::configReloaded, this, [this] {
+        reloadBindings();
+        reloadKeyRemaps();
+    });
 }
 
 InputHandler::~InputHandler() = default;
@@ -102,8 +170,85 @@ InputHandler::~InputHandler() = default;
 // ─────────────────────────────────────────────────────────────────────────────
 
 void InputHandler::reloadBindings() {
-    // Bindings are read live from Config — nothing to cache here
-    qDebug() << "[Input] bindings reloaded";
+    const auto& keys = Config::instance().keys;
+
+    // Modifiers that take part in matching; anything else held (NumLock,
+    // keypad, an unconfigured Super) is ignored, as before.
+    m_chordMods = Qt::ShiftModifier | Qt::ControlModifier | Qt::AltModifier
+                | modifierBit(keys.modifier);
+
+    m_bindings.clear();
+    m_bindings.reserve(keys.bindings.size());
+
+    int skipped = 0;
+    for (auto it = keys.bindings.constBegin(); it != keys.bindings.constEnd(); ++it) {
+        const quint64 chord = parseChord(it.key(), keys.modifier);
+        if (!chord) {
+            ++skipped;
+            qDebug() << "[Input] binding can never match, skipped:" << it.key();
+            continue;
+        }
+        QString error;
+        const Action action = Action::parse(it.value(), &error);
+        if (!action.isValid()) {
+            ++skipped;
+            qWarning() << "[Input] binding" << it.key() << "skipped:" << error;
+            continue;
+        }
+        if (m_bindings.contains(chord)) {
+            ++skipped;
+            qWarning() << "[Input] binding" << it.key() << "is the same chord as another"
+                       << "binding, skipped";
+            continue;
+        }
+        m_bindings.insert(chord, action);
+    }
+
+    qDebug() << "[Input] bindings compiled:" << m_bindings.size()
+             << "skipped:" << skipped;
+}
+
+quint64 InputHandler::parseChord(const QString& binding, const QString& mod) {
+    // The trigger follows the last '+', unless the trigger is '+' itself
+    QString prefix, trigger;
+    if (binding.endsWith(QLatin1String("++"))) {
+        prefix  = binding.chopped(2);
+        trigger = QStringLiteral("+");
+    } else {
+        const int plus = binding.lastIndexOf(QLatin1Char('+'));
+        prefix  = plus < 0 ? QString() : binding.left(plus);
+        trigger = binding.mid(plus + 1);
+    }
+
+    // Letters are written either way round ("d", "Shift+f"); Qt reports
+    // the upper-case key either way
+    if (trigger.size() == 1 && trigger.at(0).isLetter()) trigger = trigger.toUpper();
+
+    const int key = keyFromName(trigger);
+    if (!key) return 0;
+
+    const Qt::KeyboardModifier modBit = modifierBit(mod);
+    Qt::KeyboardModifiers mods;
+    bool explicitMod = false;
+    if (!prefix.isEmpty()) {
+        for (const QString& tok : prefix.split(QLatin1Char('+'))) {
+            if      (tok == mod && modBit)           { mods |= modBit; explicitMod = true; }
+            else if (tok == "Shift")                 mods |= Qt::ShiftModifier;
+            else if (tok == "Ctrl")                  mods |= Qt::ControlModifier;
+            else if (tok == "Alt")                   mods |= Qt::AltModifier;
+            else return 0;
+        }
+    }
+
+    // Bindings are relative to the WM modifier: "Return" is Super+Return,
+    // "Shift+f" is Super+Shift+F.  Naming it explicitly changes nothing.
+    // Keys that type nothing are the exception: "Print" is plain Print,
+    // "Shift+Print" is Shift+Print.
+    if (!explicitMod && !isStandaloneKey(key)) {
+        if (!modBit) return 0;   // no usable modifier configured
+        mods |= modBit;
+    }
+    return chordKey(mods, key);
 }
 
 void InputHandler::reloadKeyRemaps() {
@@ -140,7 +285,11 @@ void InputHandler::reloadKeyRemaps() {
 // Keyboard
 // ─────────────────────────────────────────────────────────────────────────────
 
-bool InputHandler::handleKeyPress(QKeyEvent* event) {
+bool InputHandler::handleKeyPress(QKeyEvent* event, qint64 arrivalNs) {
+    if (auto* rec = InputRecorder::active()) rec->key(event);
+    auto&        tracer  = LatencyTracer::instance();
+    const qint64 arrival = arrivalNs >= 0 ? arrivalNs : tracer.now();
+
     // ── Apply key remap ───────────────────────────────────────────────────
     int key = event->key();
     if (m_keyRemaps.contains(key)) key = m_keyRemaps[key];
@@ -149,22 +298,28 @@ bool InputHandler::handleKeyPress(QKeyEvent* event) {
     m_modifiers = event->modifiers();
     m_pressedKeys.insert(key);
 
-    // ── Build binding string ──────────────────────────────────────────────
-    const QString combo = buildBindingKey(event, key);
-    if (combo.isEmpty()) return false;
+    // Bare modifiers are a prefix, never a trigger
+    if (isModifierKey(key) || key == Qt::Key_unknown) return false;
 
-    const KeybindMatch match = matchBinding(combo);
-    if (match.matched) {
+    // ── Match against the compiled bindings — no strings on this path ────
+    const auto it = m_bindings.constFind(
+        chordKey(m_modifiers & m_chordMods, canonicalKey(key)));
+    if (it != m_bindings.cend()) {
         m_consumedKeys.insert(key);
-        emit actionTriggered(match.action);
+        tracer.begin(LatencyPath::KeybindAction, arrival);
+        emit actionTriggered(it.value());
         return true;
     }
 
-    forwardKeyToSurface(event);
+    // Only text input is expected to come back as a client redraw
+    Window* target = forwardKeyToSurface(event);
+    if (target && !event->text().isEmpty())
+        tracer.begin(LatencyPath::ClientKeyEcho, arrival, target);
     return false;
 }
 
 bool InputHandler::handleKeyRelease(QKeyEvent* event) {
+    if (auto* rec = InputRecorder::active()) rec->key(event);
     m_modifiers = event->modifiers();
     const int key = m_keyRemaps.value(event->key(), event->key());
     const bool consumed = m_consumedKeys.remove(key);
@@ -173,91 +328,84 @@ bool InputHandler::handleKeyRelease(QKeyEvent* event) {
     return consumed;
 }
 
-QString InputHandler::buildBindingKey(QKeyEvent* event, int overrideKey) const {
-    const int key = overrideKey ? overrideKey : event->key();
-    const QString kn = keyName(key);
-    if (kn.isEmpty()) return {};
-
-    const QString& mod = Config::instance().keys.modifier;
-    QString prefix;
-
-    const Qt::KeyboardModifiers mods = event->modifiers();
-
-    // Check configured modifier
-    bool modHeld = false;
-    if      (mod == "Super" || mod == "Meta")
-        modHeld = mods & Qt::MetaModifier;
-    else if (mod == "Alt")
-        modHeld = mods & Qt::AltModifier;
-    else if (mod == "Ctrl" || mod == "Control")
-        modHeld = mods & Qt::ControlModifier;
-
-    if (modHeld)           prefix += mod + "+";
-    if (mods & Qt::ShiftModifier)   prefix += "Shift+";
-    if (mods & Qt::ControlModifier && mod != "Ctrl") prefix += "Ctrl+";
-    if (mods & Qt::AltModifier     && mod != "Alt")  prefix += "Alt+";
-
-    return prefix + kn;
-}
-
-KeybindMatch InputHandler::matchBinding(const QString& key) const {
-    const auto& bindings = Config::instance().keys.bindings;
-    auto it = bindings.find(key);
-    if (it != bindings.end()) return {true, it.value()};
-    return {false, {}};
-}
-
-void InputHandler::forwardKeyToSurface(QKeyEvent* event) const {
+Window* InputHandler::forwardKeyToSurface(QKeyEvent* event) const {
+    if (!m_compositor) return nullptr;   // headless (tests)
     auto* ws = m_compositor->activeWorkspace();
-    if (!ws) return;
+    if (!ws) return nullptr;
     auto* w = ws->activeWindow();
-    if (!w) return;
+    if (!w) return nullptr;
     auto* seat = m_compositor->defaultSeat();
-    if (seat) seat->sendFullKeyEvent(event);
+    if (!seat) return nullptr;
+    seat->sendFullKeyEvent(event);
+    return w;
 }
 
 // ─────────────────────────────────────────────────────────────────────────────
-// Mouse — with libinput-style pointer acceleration
+// Mouse
 // ─────────────────────────────────────────────────────────────────────────────
 
 void InputHandler::handleMouseMove(const QPoint& globalPos, Qt::MouseButtons buttons) {
-    // ── Pointer acceleration ──────────────────────────────────────────────
-    // Apply simple libinput-style acceleration: fast moves are amplified,
-    // slow moves are reduced. This makes fine control easy and fast movement
-    // snappy without libinput dependency.
-    const QPoint rawDelta   = globalPos - m_cursorPos;
-    const float  speed      = std::sqrt(float(rawDelta.x()*rawDelta.x() +
-    rawDelta.y()*rawDelta.y()));
-    const float  accelFactor = Config::instance().input.pointerAccel; // e.g. 0.5
-    const float  gain       = 1.f + accelFactor * (speed / 20.f);
-    const QPoint accelDelta = QPoint(int(rawDelta.x() * gain),
-                                     int(rawDelta.y() * gain));
-    m_cursorPos = (m_cursorPos + accelDelta)
-    .expandedTo(QPoint(0,0)); // clamp ≥ 0
-
-    // ── Drag update ───────────────────────────────────────────────────────
-    if (m_dragging && m_dragWindow) {
-        QRect geom = m_dragWindow->geometry();
-        geom.moveTopLeft(m_cursorPos - m_dragOffset);
-        m_dragWindow->setGeometry(geom);
-        emit dragUpdated(m_dragWindow, geom.topLeft());
-    }
+    if (auto* rec = InputRecorder::active()) rec->mouseMove(globalPos, buttons);
+    const qint64 arrival = LatencyTracer::instance().now();
+
+    // Qt hands over the absolute position, already accelerated by whoever
+    // delivered it; only native deltas (handlePointerDelta) move relatively.
+    m_cursorPos = globalPos;
 
-    // ── Resize update ─────────────────────────────────────────────────────
-    if (m_resizing && m_resizeWindow) {
-        updateResize(m_cursorPos);
+    pointerMoved(arrival);
+    Q_UNUSED(buttons);
+}
+
+void InputHandler::handlePointerDelta(const QPointF& delta, qint64 arrivalNs) {
+    if (auto* rec = InputRecorder::active()) rec->pointerDelta(delta);
+    // Keep the fraction — slow libinput motion is mostly sub-pixel
+    m_cursorRemainder += delta;
+    const QPoint whole = m_cursorRemainder.toPoint();
+    m_cursorRemainder -= whole;
+
+    m_cursorPos = (m_cursorPos + whole).expandedTo(QPoint(0,0));
+    if (auto* out = m_compositor ? m_compositor->primaryOutput() : nullptr)
+        m_cursorPos = m_cursorPos.boundedTo(QPoint(out->width() - 1, out->height() - 1));
+    pointerMoved(arrivalNs);
+}
+
+void InputHandler::pointerMoved(qint64 arrivalNs) {
+    auto& tracer = LatencyTracer::instance();
+
+    // Drag / resize geometry, hover and cursor shape are applied once per
+    // frame in flushPointerMotion() — a 1000 Hz mouse would otherwise
+    // configure the client hundreds of times a second.
+    m_motionPending = true;
+
+    if (m_dragging || m_resizing) {
+        tracer.begin(LatencyPath::Drag, arrivalNs);
+    } else if (Window* w = windowAt(m_cursorPos)) {
+        // ── Client motion ─────────────────────────────────────────────────
+        // Full rate, uncoalesced: drawing tools want every sample.
+        forwardMouseMoveToSurface(w, m_cursorPos);
+
+        // Hover alone rarely makes a client redraw; a held button (a stroke,
+        // a selection) does
+        if (m_heldButtons)
+            tracer.begin(LatencyPath::ClientPointerEcho, arrivalNs, w);
     }
+}
+
+void InputHandler::flushPointerMotion() {
+    if (!m_motionPending) return;
+    m_motionPending = false;
+
+    if (m_dragging)  updateDrag(m_cursorPos);
+    if (m_resizing)  updateResize(m_cursorPos);
 
-    // Update hovered window & cursor shape
     m_hoveredWindow = windowAt(m_cursorPos);
     updateCursorShape(m_cursorPos);
-
-    Q_UNUSED(buttons);
 }
 
 void InputHandler::handleMousePress(const QPoint& globalPos,
                                     Qt::MouseButton button,
                                     Qt::KeyboardModifiers modifiers) {
+    if (auto* rec = InputRecorder::active()) rec->mouseButton(globalPos, button, modifiers, true);
     m_cursorPos = globalPos;
     m_heldButtons |= button;
     m_modifiers   = modifiers;
@@ -291,6 +439,7 @@ void InputHandler::handleMousePress(const QPoint& globalPos,
                                     void InputHandler::handleMouseRelease(const QPoint& globalPos,
                                                                           Qt::MouseButton button,
                                                                           Qt::KeyboardModifiers modifiers) {
+                                        if (auto* rec = InputRecorder::active()) rec->mouseButton(globalPos, button, modifiers, false);
                                         m_cursorPos   = globalPos;
                                         m_heldButtons &= ~button;
                                         m_modifiers   = modifiers;
@@ -305,6 +454,7 @@ void InputHandler::handleMousePress(const QPoint& globalPos,
                                                                           void InputHandler::handleWheel(const QPoint& globalPos,
                                                                                                          const QPointF& angleDelta,
                                                                                                          Qt::KeyboardModifiers modifiers) {
+                                                                              if (auto* rec = InputRecorder::active()) rec->wheel(globalPos, angleDelta, modifiers);
                                                                               // Super+Scroll = workspace switch
                                                                               const QString& mod = Config::instance().keys.modifier;
                                                                               const bool modHeld =
@@ -313,8 +463,8 @@ void InputHandler::handleMousePress(const QPoint& globalPos,
                                                                               (mod=="Ctrl" && modifiers&Qt::ControlModifier);
 
                                                                               if (modHeld) {
-                                                                                  if (angleDelta.y() > 0) emit actionTriggered("workspace:prev");
-                                                                                  if (angleDelta.y() < 0) emit actionTriggered("workspace:next");
+                                                                                  if (angleDelta.y() > 0) emit actionTriggered(Action(ActionOp::WorkspacePrev));
+                                                                                  if (angleDelta.y() < 0) emit actionTriggered(Action(ActionOp::WorkspaceNext));
                                                                                   return;
                                                                               }
 
@@ -334,6 +484,7 @@ void InputHandler::handleMousePress(const QPoint& globalPos,
 
                                                                                                          void InputHandler::handleTouch(QTouchEvent* event) {
                                                                                                              if (!event) return;
+                                                                                                             if (auto* rec = InputRecorder::active()) rec->touch(event);
                                                                                                              const auto& pts = event->points();
 
                                                                                                              switch (event->type()) {
@@ -398,23 +549,14 @@ void InputHandler::handleMousePress(const QPoint& globalPos,
                                                                                                                      ? GestureType::SwipeRight   // fingers move right → prev ws
                                                                                                                      : GestureType::SwipeLeft;
                                                                                                                      m_touch.committed = true;
-                                                                                                                     emit gestureDetected(m_touch.active, ax);
-                                                                                                                     // Immediately trigger workspace action
-                                                                                                                     if (m_touch.active == GestureType::SwipeRight)
-                                                                                                                         emit actionTriggered("workspace:prev");
-                                                                                                                     else
-                                                                                                                         emit actionTriggered("workspace:next");
+                                                                                                                     triggerGesture(m_touch.active, 3, ax);
                                                                                                                  } else if (ay > kSwipeThresholdPx && ay > ax * 1.5f) {
                                                                                                                      // Vertical swipe → focus up/down
                                                                                                                      m_touch.active    = delta.y() > 0
                                                                                                                      ? GestureType::SwipeDown
                                                                                                                      : GestureType::SwipeUp;
                                                                                                                      m_touch.committed = true;
-                                                                                                                     emit gestureDetected(m_touch.active, ay);
-                                                                                                                     if (m_touch.active == GestureType::SwipeUp)
-                                                                                                                         emit actionTriggered("focus:up");
-                                                                                                                     else
-                                                                                                                         emit actionTriggered("focus:down");
+                                                                                                                     triggerGesture(m_touch.active, 3, ay);
                                                                                                                  }
                                                                                                              }
 
@@ -423,23 +565,42 @@ void InputHandler::handleMousePress(const QPoint& globalPos,
                                                                                                                  const QPointF delta = cur - m_touch.startCentroid;
                                                                                                                  if (std::abs(float(delta.y())) > kSwipeThresholdPx * 0.8f) {
                                                                                                                      m_touch.committed = true;
-                                                                                                                     emit actionTriggered("launcher");
+                                                                                                                     emit actionTriggered(Action(ActionOp::Launcher));
                                                                                                                  }
                                                                                                              }
                                                                                                          }
 
+                                                                                                         void InputHandler::handleGesture(GestureType type, int fingers, float magnitude) {
+                                                                                                             if (auto* rec = InputRecorder::active()) rec->gesture(type, fingers, magnitude);
+                                                                                                             triggerGesture(type, fingers, magnitude);
+                                                                                                         }
+
+                                                                                                         void InputHandler::triggerGesture(GestureType type, int fingers, float magnitude) {
+                                                                                                             emit gestureDetected(type, magnitude);
+
+                                                                                                             switch (type) {
+                                                                                                                 // 4+ fingers vertically opens the launcher
+                                                                                                                 case GestureType::SwipeUp:
+                                                                                                                 case GestureType::SwipeDown:
+                                                                                                                     if (fingers >= 4) { emit actionTriggered(Action(ActionOp::Launcher)); return; }
+                                                                                                                     emit actionTriggered(Action(ActionOp::Focus, type == GestureType::SwipeUp
+                                                                                                                                                                  ? ActionDir::Up : ActionDir::Down));
+                                                                                                                     return;
+                                                                                                                 // Fingers move right → previous workspace
+                                                                                                                 case GestureType::SwipeRight: emit actionTriggered(Action(ActionOp::WorkspacePrev)); return;
+                                                                                                                 case GestureType::SwipeLeft:  emit actionTriggered(Action(ActionOp::WorkspaceNext)); return;
+                                                                                                                 default: return;
+                                                                                                             }
+                                                                                                         }
+
                                                                                                          // ─────────────────────────────────────────────────────────────────────────────
                                                                                                          // Hit-testing
                                                                                                          // ─────────────────────────────────────────────────────────────────────────────
 
                                                                                                          Window* InputHandler::windowAt(const QPoint& pos) const {
+                                                                                                             if (!m_compositor) return nullptr;   // headless (tests)
                                                                                                              auto* ws = m_compositor->activeWorkspace();
-                                                                                                             if (!ws) return nullptr;
-                                                                                                             const auto wins = ws->visibleWindows();
-                                                                                                             for (int i = wins.size()-1; i >= 0; --i)
-                                                                                                                 if (wins[i]->isVisible() && wins[i]->geometry().contains(pos))
-                                                                                                                     return wins[i];
-                                                                                                             return nullptr;
+                                                                                                             return ws ? ws->windowAt(pos) : nullptr;
                                                                                                          }
 
                                                                                                          bool InputHandler::inTitleBar(const QPoint& pos, const Window* w) const {
@@ -490,7 +651,7 @@ void InputHandler::handleMousePress(const QPoint& globalPos,
                                                                                                                                                                      // ─────────────────────────────────────────────────────────────────────────────
 
                                                                                                                                                                      void InputHandler::beginDrag(Window* w, const QPoint& cursorPos) {
-                                                                                                                                                                         if (!w->isFloating()) emit actionTriggered("float");
+                                                                                                                                                                         if (!w->isFloating()) emit actionTriggered(Action(ActionOp::Float));
                                                                                                                                                                          m_dragging      = true;
                                                                                                                                                                          m_dragWindow    = w;
                                                                                                                                                                          m_dragOffset    = cursorPos - w->geometry().topLeft();
@@ -508,6 +669,7 @@ void InputHandler::handleMousePress(const QPoint& globalPos,
 
                                                                                                                                                                      void InputHandler::endDrag(const QPoint& cursorPos) {
                                                                                                                                                                          if (!m_dragging) return;
+                                                                                                                                                                         updateDrag(cursorPos);
                                                                                                                                                                          emit dragFinished(m_dragWindow, cursorPos - m_dragOffset);
                                                                                                                                                                          m_dragging   = false;
                                                                                                                                                                          m_dragWindow = nullptr;
@@ -528,6 +690,17 @@ void InputHandler::handleMousePress(const QPoint& globalPos,
 
                                                                                                                                                                      void InputHandler::updateResize(const QPoint& cursorPos) {
                                                                                                                                                                          if (!m_resizing || !m_resizeWindow) return;
+
+                                                                                                                                                                         // Tiled window in a BSP workspace: drag the split, not the window
+                                                                                                                                                                         if (m_resizeWindow->isTiled()) {
+                                                                                                                                                                             auto* ws = m_compositor->workspace(m_resizeWindow->workspaceId());
+                                                                                                                                                                             if (ws && ws->resizeSplit(m_resizeWindow, m_resizeEdges, cursorPos,
+                                                                                                                                                                                                       m_compositor->workArea())) {
+                                                                                                                                                                                 emit resizeUpdated(m_resizeWindow, m_resizeWindow->geometry());
+                                                                                                                                                                                 return;
+                                                                                                                                                                             }
+                                                                                                                                                                         }
+
                                                                                                                                                                          const QPoint delta = cursorPos - m_resizeStartCursor;
                                                                                                                                                                          QRect geom         = m_resizeStartGeom;
 
@@ -601,3 +774,14 @@ void InputHandler::handleMousePress(const QPoint& globalPos,
                                                                                                                                                                          seat->sendMouseButtonEvent(button, pressed
                                                                                                                                                                          ? QWaylandSeat::Pressed : QWaylandSeat::Released);
                                                                                                                                                                                                                     }
+
+                                                                                                                                                                     void InputHandler::forwardMouseMoveToSurface(Window* w, const QPoint& globalPos) {
+                                                                                                                                                                         if (!w) return;
+                                                                                                                                                                         auto* seat = m_compositor->defaultSeat();
+                                                                                                                                                                         if (!seat) return;
+
+                                                                                                                                                                         const QPoint localPos = globalPos - w->geometry().topLeft()
+                                                                                                                                                                         - QPoint(0, kTitleBarHeight);
+                                                                                                                                                                         seat->sendMouseMoveEvent(nullptr,
+                                                                                                                                                                                                  QPointF(localPos.x(), localPos.y()), QPointF(globalPos));
+                                                                                                                                                                     }
@@ -15,6 +15,8 @@
 #include <QTabletEvent>
 #include <QTouchEvent>
 
+#include "Action.h"
+
 class WMCompositor;
 class Window;
 class Workspace;
@@ -33,16 +35,6 @@ enum class PointerButton : uint32_t {
     Extra  = 0x114
 };
 
-// ─────────────────────────────────────────────────────────────────────────────
-// KeybindMatch
-//
-// Result of trying to match a key event against the configured bindings table.
-// ─────────────────────────────────────────────────────────────────────────────
-struct KeybindMatch {
-    bool    matched = false;
-    QString action;          ///< e.g. "exec:alacritty", "workspace:3"
-};
-
 // ─────────────────────────────────────────────────────────────────────────────
 // GestureType
 // ─────────────────────────────────────────────────────────────────────────────
@@ -64,8 +56,9 @@ enum class GestureType {
 //
 // Responsibilities
 //   Keyboard
-//     • Decode raw Qt key events into modifier+key strings.
-//     • Look up the action string in Config::keys.bindings.
+//     • Compile Config::keys.bindings ("Super+Shift+Q") into a hash keyed by
+//       (modifier mask, Qt key) on load / reload, so a key press is one
+//       integer hash lookup — no string building on the press path.
 //     • Emit actionTriggered() for the compositor to dispatch.
 //     • Forward events not matched by a binding to the focused Wayland surface
 //       via QWaylandSeat.
@@ -101,16 +94,38 @@ public:
     /// Process a Qt key-press event.
     /// Returns true if the event was consumed by a keybind, false if it should
     /// be forwarded to the focused Wayland surface.
-    bool handleKeyPress(QKeyEvent* event);
+    /// \p arrivalNs is the event's time on the LatencyTracer clock; by
+    /// default, now.
+    bool handleKeyPress(QKeyEvent* event, qint64 arrivalNs = -1);
 
     /// Process a Qt key-release event.
     /// Returns true if consumed (e.g. the matching press was a keybind).
     bool handleKeyRelease(QKeyEvent* event);
 
-    /// Process pointer movement.  \p globalPos is in compositor coordinates.
+    /// Process pointer movement.  \p globalPos is the absolute position in
+    /// compositor coordinates; it becomes the cursor position as is.
     void handleMouseMove(const QPoint& globalPos,
                          Qt::MouseButtons buttons);
 
+    /// Relative pointer motion from a native backend, already accelerated
+    /// there (LibinputBackend).  Sub-pixel remainders carry over.
+    void handlePointerDelta(const QPointF& delta, qint64 arrivalNs);
+
+    /// Set by LibinputBackend while it feeds this handler.  WMOutput then
+    /// ignores Qt's own key / pointer events, which would otherwise
+    /// deliver everything twice when the QPA reads the same devices.
+    void setNativeInput(bool on) { m_nativeInput = on; }
+    bool nativeInput() const     { return m_nativeInput; }
+
+    /// A recognised touchpad / touchscreen gesture.  Swipes map to
+    /// workspace and focus actions (4+ fingers vertical: launcher).
+    void handleGesture(GestureType type, int fingers, float magnitude);
+
+    /// Apply the pointer motion accumulated since the last call: drag and
+    /// resize geometry, hovered window, cursor shape.  WMOutput calls this
+    /// once per render tick; motion itself reaches the client at full rate.
+    void flushPointerMotion();
+
     /// Process a pointer button press.
     void handleMousePress(const QPoint& globalPos,
                           Qt::MouseButton button,
@@ -129,6 +144,8 @@ public:
     /// Process a touch event (stub for future gesture support).
     void handleTouch(QTouchEvent* event);
 
+    // Every entry point above feeds the active InputRecorder, if any.
+
     // ── State queries ─────────────────────────────────────────────────────
 
     /// Current pointer position in compositor coordinates.
@@ -140,7 +157,7 @@ public:
     /// True while a window edge resize is in progress.
     bool isResizing()          const { return m_resizing;  }
 
-    /// Window under the pointer at the last mouse-move event.
+    /// Window under the pointer as of the last flushPointerMotion().
     Window* hoveredWindow()    const { return m_hoveredWindow; }
 
     /// Window currently being dragged (nullptr if not dragging).
@@ -154,16 +171,17 @@ public:
 
     // ── Configuration reload ──────────────────────────────────────────────
 
-    /// Re-read keybindings from Config::instance().keys after a config reload.
+    /// Recompile keybindings from Config::instance().keys.  Runs on
+    /// construction and on every Config::configReloaded().
     void reloadBindings();
     void reloadKeyRemaps();
 
 signals:
     // ── Keybind actions ───────────────────────────────────────────────────
 
-    /// A keybind was matched and its action string decoded.
-    /// WMCompositor connects to this and dispatches the action.
-    void actionTriggered(const QString& action);
+    /// A keybind, wheel or gesture resolved to \p action (parsed when the
+    /// bindings were loaded).  WMCompositor::dispatch() executes it.
+    void actionTriggered(const Action& action);
 
     // ── Focus change requests ─────────────────────────────────────────────
 
@@ -208,16 +226,21 @@ signals:
 private:
     // ── Keybind helpers ───────────────────────────────────────────────────
 
-    /// Build the canonical binding key string for a Qt key event,
-    /// e.g. "Super+Return", "Super+Shift+Q", "Alt+F4".
-    QString buildBindingKey(QKeyEvent* event, int overrideKey = 0) const;
+    /// Hash key for a chord: modifier bits in the high word, Qt key in the
+    /// low word.
+    static quint64 chordKey(Qt::KeyboardModifiers mods, int key) {
+        return (quint64(mods.toInt()) << 32) | quint32(key);
+    }
 
-    /// Look up \p bindingKey in the bindings table.
-    KeybindMatch matchBinding(const QString& bindingKey) const;
+    /// Compile a binding string such as "Super+Shift+Return" into its
+    /// chordKey().  The configured \p modifier is implied when not named,
+    /// so "Return" and "Shift+f" mean Super+Return and Super+Shift+F.
+    /// Returns 0 if no key press would ever produce it.
+    static quint64 parseChord(const QString& binding, const QString& modifier);
 
     /// Forward a key event to the currently-focused Wayland surface via the
-    /// compositor's default seat.
-    void forwardKeyToSurface(QKeyEvent* event) const;
+    /// compositor's default seat.  Returns the window it went to, if any.
+    Window* forwardKeyToSurface(QKeyEvent* event) const;
 
     // ── Hit-testing ───────────────────────────────────────────────────────
 
@@ -242,6 +265,7 @@ private:
     // ── Wayland event forwarding ──────────────────────────────────────────
     void forwardMouseButtonToSurface(Window* w, const QPoint& globalPos,
                                      Qt::MouseButton button, bool pressed);
+    void forwardMouseMoveToSurface(Window* w, const QPoint& globalPos);
 
     // ── Drag helpers ──────────────────────────────────────────────────────
     void beginDrag(Window* w, const QPoint& cursorPos);
@@ -257,9 +281,17 @@ private:
     void updateCursorShape(const QPoint& pos);
     Qt::CursorShape cursorShapeForEdges(Qt::Edges edges) const;
 
+    // ── Pointer helpers ───────────────────────────────────────────────────
+    /// m_cursorPos changed: forward to the client, queue drag / resize.
+    void pointerMoved(qint64 arrivalNs);
+
     // ── Gesture helpers ───────────────────────────────────────────────────
     void processGestureUpdate();
 
+    /// handleGesture() minus recording — for gestures recognised here,
+    /// whose touch points are already in the recording.
+    void triggerGesture(GestureType type, int fingers, float magnitude);
+
     // ── Members ───────────────────────────────────────────────────────────
 
     WMCompositor*         m_compositor     = nullptr;
@@ -270,10 +302,17 @@ private:
     QSet<int>             m_consumedKeys;  ///< Keys consumed by a keybind
     QHash<int,int>        m_keyRemaps;     ///< Qt::Key → Qt::Key remaps (e.g. CapsLock→Super)
 
+    // Compiled keybindings: chordKey() → parsed action
+    QHash<quint64, Action>  m_bindings;
+    Qt::KeyboardModifiers   m_chordMods;   ///< Modifiers that take part in a chord
+
     // Pointer
     QPoint                m_cursorPos;
+    QPointF               m_cursorRemainder;     ///< Sub-pixel part of native motion
     Window*               m_hoveredWindow  = nullptr;
     Qt::MouseButtons      m_heldButtons    = Qt::NoButton;
+    bool                  m_motionPending  = false; ///< Motion not yet applied by flushPointerMotion()
+    bool                  m_nativeInput    = false; ///< LibinputBackend is the input source
 
     // Drag state
     bool                  m_dragging       = false;
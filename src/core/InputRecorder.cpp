@@ -0,0 +1,322 @@
+#include "InputRecorder.h"
+#include "InputHandler.h"
+#include "LatencyTracer.h"
+#include "compositor/IPCServer.h"
+
+#include <QKeyEvent>
+#include <QTouchEvent>
+#include <QPointingDevice>
+#include <QDebug>
+#include <cmath>
+
+// ─────────────────────────────────────────────────────────────────────────────
+// InputRecord serialisation
+// ─────────────────────────────────────────────────────────────────────────────
+
+QDataStream& operator<<(QDataStream& s, const InputRecord& r) {
+    s << r.timeNs << quint8(r.kind);
+    switch (r.kind) {
+        case InputRecord::KeyPress:
+        case InputRecord::KeyRelease:
+            s << r.code << r.scancode << r.modifiers << r.autoRepeat << r.text;
+            break;
+        case InputRecord::MouseMove:
+            s << r.pos << r.modifiers;
+            break;
+        case InputRecord::PointerDelta:
+            s << r.delta;
+            break;
+        case InputRecord::Wheel:
+            s << r.pos << r.delta << r.modifiers;
+            break;
+        case InputRecord::MousePress:
+        case InputRecord::MouseRelease:
+        case InputRecord::Gesture:
+            s << r.code << r.modifiers << r.pos;
+            break;
+        case InputRecord::Touch:
+            s << r.code << r.modifiers << quint16(r.points.size());
+            for (const auto& p : r.points) s << p.id << p.state << p.pos;
+            break;
+        case InputRecord::Ipc:
+            s << r.text;
+            break;
+    }
+    return s;
+}
+
+QDataStream& operator>>(QDataStream& s, InputRecord& r) {
+    quint8 kind = 0;
+    s >> r.timeNs >> kind;
+    r.kind = InputRecord::Kind(kind);
+    switch (r.kind) {
+        case InputRecord::KeyPress:
+        case InputRecord::KeyRelease:
+            s >> r.code >> r.scancode >> r.modifiers >> r.autoRepeat >> r.text;
+            break;
+        case InputRecord::MouseMove:
+            s >> r.pos >> r.modifiers;
+            break;
+        case InputRecord::PointerDelta:
+            s >> r.delta;
+            break;
+        case InputRecord::Wheel:
+            s >> r.pos >> r.delta >> r.modifiers;
+            break;
+        case InputRecord::MousePress:
+        case InputRecord::MouseRelease:
+        case InputRecord::Gesture:
+            s >> r.code >> r.modifiers >> r.pos;
+            break;
+        case InputRecord::Touch: {
+            quint16 n = 0;
+            s >> r.code >> r.modifiers >> n;
+            r.points.resize(n);
+            for (auto& p : r.points) s >> p.id >> p.state >> p.pos;
+            break;
+        }
+        case InputRecord::Ipc:
+            s >> r.text;
+            break;
+        default:
+            s.setStatus(QDataStream::ReadCorruptData);
+            break;
+    }
+    return s;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// InputRecorder
+// ─────────────────────────────────────────────────────────────────────────────
+
+InputRecorder* InputRecorder::s_active = nullptr;
+
+bool InputRecorder::start(const QString& path) {
+    stop();
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "[InputRecorder] cannot open" << path << m_file.errorString();
+        return false;
+    }
+    m_out.setDevice(&m_file);
+    m_out.setVersion(QDataStream::Qt_6_0);
+    m_out << kMagic << kVersion;
+
+    m_count = 0;
+    m_clock.start();
+    s_active = this;
+    qInfo() << "[InputRecorder] recording to" << path;
+    return true;
+}
+
+void InputRecorder::stop() {
+    if (s_active == this) s_active = nullptr;
+    if (!m_file.isOpen()) return;
+    m_out.setDevice(nullptr);
+    m_file.close();
+    qInfo() << "[InputRecorder] wrote" << m_count << "events to" << m_file.fileName();
+}
+
+void InputRecorder::write(InputRecord& r) {
+    r.timeNs = m_clock.nsecsElapsed();
+    m_out << r;
+    ++m_count;
+}
+
+void InputRecorder::key(const QKeyEvent* event) {
+    InputRecord r;
+    r.kind       = event->type() == QEvent::KeyRelease ? InputRecord::KeyRelease
+                                                       : InputRecord::KeyPress;
+    r.code       = event->key();
+    r.scancode   = event->nativeScanCode();
+    r.modifiers  = event->modifiers().toInt();
+    r.autoRepeat = event->isAutoRepeat();
+    r.text       = event->text();
+    write(r);
+}
+
+void InputRecorder::mouseMove(const QPoint& pos, Qt::MouseButtons buttons) {
+    InputRecord r;
+    r.kind      = InputRecord::MouseMove;
+    r.pos       = pos;
+    r.modifiers = buttons.toInt();
+    write(r);
+}
+
+void InputRecorder::mouseButton(const QPoint& pos, Qt::MouseButton button,
+                                Qt::KeyboardModifiers modifiers, bool pressed) {
+    InputRecord r;
+    r.kind      = pressed ? InputRecord::MousePress : InputRecord::MouseRelease;
+    r.code      = qint32(button);
+    r.modifiers = modifiers.toInt();
+    r.pos       = pos;
+    write(r);
+}
+
+void InputRecorder::wheel(const QPoint& pos, const QPointF& angleDelta,
+                          Qt::KeyboardModifiers modifiers) {
+    InputRecord r;
+    r.kind      = InputRecord::Wheel;
+    r.pos       = pos;
+    r.delta     = angleDelta;
+    r.modifiers = modifiers.toInt();
+    write(r);
+}
+
+void InputRecorder::pointerDelta(const QPointF& delta) {
+    InputRecord r;
+    r.kind  = InputRecord::PointerDelta;
+    r.delta = delta;
+    write(r);
+}
+
+void InputRecorder::gesture(GestureType type, int fingers, float magnitude) {
+    InputRecord r;
+    r.kind      = InputRecord::Gesture;
+    r.code      = qint32(type);
+    r.modifiers = quint32(fingers);
+    r.pos       = QPointF(magnitude, 0);
+    write(r);
+}
+
+void InputRecorder::touch(const QTouchEvent* event) {
+    InputRecord r;
+    r.kind      = InputRecord::Touch;
+    r.code      = qint32(event->type());
+    r.modifiers = event->modifiers().toInt();
+    for (const auto& tp : event->points())
+        r.points.append({ qint32(tp.id()), quint8(tp.state()), tp.position() });
+    write(r);
+}
+
+void InputRecorder::ipc(const QString& command) {
+    InputRecord r;
+    r.kind = InputRecord::Ipc;
+    r.text = command;
+    write(r);
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// InputReplayer
+// ─────────────────────────────────────────────────────────────────────────────
+
+InputReplayer::InputReplayer(InputHandler* input, IPCServer* ipc, QObject* parent)
+: QObject(parent), m_input(input), m_ipc(ipc)
+{
+    m_timer.setSingleShot(true);
+    m_timer.setTimerType(Qt::PreciseTimer);
+    connect(&m_timer, &QTimer::timeout, this, &InputReplayer::step);
+}
+
+bool InputReplayer::load(const QString& path) {
+    QFile f(path);
+    if (!f.open(QIODevice::ReadOnly)) {
+        qWarning() << "[InputReplayer] cannot open" << path << f.errorString();
+        return false;
+    }
+    QDataStream in(&f);
+    in.setVersion(QDataStream::Qt_6_0);
+
+    quint32 magic = 0;
+    quint16 version = 0;
+    in >> magic >> version;
+    if (magic != InputRecorder::kMagic || version != InputRecorder::kVersion) {
+        qWarning() << "[InputReplayer]" << path << "is not a version"
+                   << InputRecorder::kVersion << "recording";
+        return false;
+    }
+
+    m_records.clear();
+    while (!in.atEnd()) {
+        InputRecord r;
+        in >> r;
+        if (in.status() != QDataStream::Ok) {
+            qWarning() << "[InputReplayer] truncated recording — keeping"
+                       << m_records.size() << "events";
+            break;
+        }
+        m_records.append(std::move(r));
+    }
+    qInfo() << "[InputReplayer] loaded" << m_records.size() << "events from" << path;
+    return true;
+}
+
+void InputReplayer::start(double speed) {
+    m_speed = speed > 0.0 ? speed : 1.0;
+    m_next  = 0;
+    LatencyTracer::instance().reset();
+    m_clock.start();
+    step();
+}
+
+void InputReplayer::step() {
+    const qint64 t = qint64(m_clock.nsecsElapsed() * m_speed);
+    while (m_next < m_records.size() && m_records[m_next].timeNs <= t)
+        inject(m_records[m_next++]);
+
+    if (m_next < m_records.size()) {
+        const double waitNs = (m_records[m_next].timeNs - t) / m_speed;
+        m_timer.start(int(std::ceil(waitNs / 1e6)));
+    } else {
+        QTimer::singleShot(kSettleMs, this, &InputReplayer::finish);
+    }
+}
+
+void InputReplayer::inject(const InputRecord& r) {
+    const auto mods = Qt::KeyboardModifiers::fromInt(int(r.modifiers));
+
+    switch (r.kind) {
+        case InputRecord::KeyPress:
+        case InputRecord::KeyRelease: {
+            QKeyEvent ev(r.kind == InputRecord::KeyPress ? QEvent::KeyPress : QEvent::KeyRelease,
+                         r.code, mods, r.scancode, 0, 0, r.text, r.autoRepeat);
+            if (r.kind == InputRecord::KeyPress) m_input->handleKeyPress(&ev);
+            else                                 m_input->handleKeyRelease(&ev);
+            break;
+        }
+        case InputRecord::MouseMove:
+            m_input->handleMouseMove(r.pos.toPoint(),
+                                     Qt::MouseButtons::fromInt(int(r.modifiers)));
+            break;
+        case InputRecord::MousePress:
+            m_input->handleMousePress(r.pos.toPoint(), Qt::MouseButton(r.code), mods);
+            break;
+        case InputRecord::MouseRelease:
+            m_input->handleMouseRelease(r.pos.toPoint(), Qt::MouseButton(r.code), mods);
+            break;
+        case InputRecord::Wheel:
+            m_input->handleWheel(r.pos.toPoint(), r.delta, mods);
+            break;
+        case InputRecord::PointerDelta:
+            m_input->handlePointerDelta(r.delta, LatencyTracer::instance().now());
+            break;
+        case InputRecord::Gesture:
+            m_input->handleGesture(GestureType(r.code), int(r.modifiers), float(r.pos.x()));
+            break;
+        case InputRecord::Touch: {
+            static const QPointingDevice device(
+                "hackerland-replay", 0, QInputDevice::DeviceType::TouchScreen,
+                QPointingDevice::PointerType::Finger, QInputDevice::Capability::Position,
+                10, 0);
+            QList<QEventPoint> points;
+            for (const auto& p : r.points)
+                points.append(QEventPoint(p.id, QEventPoint::State(p.state), p.pos, p.pos));
+            QTouchEvent ev(QEvent::Type(r.code), &device, mods, points);
+            m_input->handleTouch(&ev);
+            break;
+        }
+        case InputRecord::Ipc:
+            if (m_ipc) m_ipc->execute(r.text);
+            break;
+    }
+}
+
+void InputReplayer::finish() {
+    QJsonObject report;
+    report["events"]      = m_records.size();
+    report["speed"]       = m_speed;
+    report["recorded_ms"] = m_records.isEmpty() ? 0.0 : m_records.last().timeNs / 1e6;
+    report["wall_ms"]     = m_clock.nsecsElapsed() / 1e6 - kSettleMs;
+    report["latency"]     = LatencyTracer::instance().toJson();
+    emit finished(report);
+}
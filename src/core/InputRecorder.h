@@ -0,0 +1,149 @@
+#pragma once
+
+#include <QObject>
+#include <QFile>
+#include <QDataStream>
+#include <QElapsedTimer>
+#include <QJsonObject>
+#include <QPointF>
+#include <QString>
+#include <QTimer>
+#include <QVector>
+
+#include <Qt>
+
+class QKeyEvent;
+class QTouchEvent;
+class InputHandler;
+class IPCServer;
+enum class GestureType;
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Input recordings
+//
+// A recording is the input stream as it reached InputHandler, plus IPC
+// commands, in a compact binary file:
+//
+//   header   quint32 magic 'HLRC', quint16 version
+//   records  qint64 time (ns since start), quint8 InputRecord::Kind, payload
+//
+// All through QDataStream (big endian, Qt_6_0), so a file replays on any
+// machine.  Positions are compositor coordinates; a replay wants the same
+// output size as the recording.
+// ─────────────────────────────────────────────────────────────────────────────
+struct InputRecord {
+    enum Kind : quint8 {
+        KeyPress, KeyRelease,
+        MouseMove, MousePress, MouseRelease, Wheel,
+        PointerDelta, Gesture, Touch,
+        Ipc
+    };
+
+    struct TouchPoint {
+        qint32  id    = 0;
+        quint8  state = 0;      ///< QEventPoint::State
+        QPointF pos;
+    };
+
+    qint64  timeNs    = 0;
+    Kind    kind      = MouseMove;
+    qint32  code      = 0;      ///< Key: Qt::Key · button · GestureType · touch QEvent::Type
+    quint32 scancode  = 0;      ///< Key
+    quint32 modifiers = 0;      ///< Qt::KeyboardModifiers (buttons for MouseMove, fingers for Gesture)
+    bool    autoRepeat = false; ///< Key
+    QPointF pos;                ///< Pointer position · (gesture magnitude, 0)
+    QPointF delta;              ///< Wheel angle delta · pointer delta
+    QString text;               ///< Key text · IPC command
+    QVector<TouchPoint> points; ///< Touch
+};
+
+QDataStream& operator<<(QDataStream& s, const InputRecord& r);
+QDataStream& operator>>(QDataStream& s, InputRecord& r);
+
+// ─────────────────────────────────────────────────────────────────────────────
+// InputRecorder
+//
+// While one is started, InputHandler's entry points and IPCServer append
+// every event to it — one null check per event otherwise.  GUI thread only.
+// ─────────────────────────────────────────────────────────────────────────────
+class InputRecorder {
+public:
+    InputRecorder() = default;
+    ~InputRecorder() { stop(); }
+
+    /// The recorder currently capturing, if any.
+    static InputRecorder* active() { return s_active; }
+
+    /// Truncate \p path and start capturing into it.
+    bool start(const QString& path);
+    void stop();
+
+    void key         (const QKeyEvent* event);
+    void mouseMove   (const QPoint& pos, Qt::MouseButtons buttons);
+    void mouseButton (const QPoint& pos, Qt::MouseButton button,
+                      Qt::KeyboardModifiers modifiers, bool pressed);
+    void wheel       (const QPoint& pos, const QPointF& angleDelta,
+                      Qt::KeyboardModifiers modifiers);
+    void pointerDelta(const QPointF& delta);
+    void gesture     (GestureType type, int fingers, float magnitude);
+    void touch       (const QTouchEvent* event);
+    void ipc         (const QString& command);
+
+    static constexpr quint32 kMagic   = 0x484C5243;   ///< "HLRC"
+    static constexpr quint16 kVersion = 1;
+
+private:
+    void write(InputRecord& r);
+
+    static InputRecorder* s_active;
+
+    QFile         m_file;
+    QDataStream   m_out;
+    QElapsedTimer m_clock;
+    quint64       m_count = 0;
+};
+
+// ─────────────────────────────────────────────────────────────────────────────
+// InputReplayer
+//
+// Feeds a recording back into InputHandler (and IPCServer::execute()) on
+// its original schedule, divided by the speed factor.  The LatencyTracer is
+// reset when the replay starts; kSettleMs after the last event, finished()
+// reports the events replayed, wall time and the tracer's histograms —
+// latency per path and frame intervals.
+//
+// Meant for a headless instance (QT_QPA_PLATFORM=offscreen) with the same
+// config and clients as the recording, so two builds can be compared on
+// exactly the same session.
+// ─────────────────────────────────────────────────────────────────────────────
+class InputReplayer : public QObject {
+    Q_OBJECT
+public:
+    InputReplayer(InputHandler* input, IPCServer* ipc, QObject* parent = nullptr);
+
+    /// Read the whole recording.  Returns false (and warns) if it is not one.
+    bool load(const QString& path);
+
+    /// Start injecting; \p speed 2 replays twice as fast.
+    void start(double speed = 1.0);
+
+    int eventCount() const { return m_records.size(); }
+
+signals:
+    void finished(const QJsonObject& report);
+
+private:
+    void step();
+    void inject(const InputRecord& r);
+    void finish();
+
+    static constexpr int kSettleMs = 500;   ///< Let the last frames land
+
+    InputHandler*        m_input = nullptr;
+    IPCServer*           m_ipc   = nullptr;
+    QVector<InputRecord> m_records;
+    int                  m_next  = 0;
+    double               m_speed = 1.0;
+    QElapsedTimer        m_clock;
+    QTimer               m_timer;
+};
@@ -0,0 +1,127 @@
+#include "LatencyTracer.h"
+
+#include <QJsonArray>
+
+#include <time.h>
+
+// ─────────────────────────────────────────────────────────────────────────────
+// LatencyHistogram
+// ─────────────────────────────────────────────────────────────────────────────
+
+void LatencyHistogram::add(qint64 us) {
+    if (us < 0) us = 0;
+    const qint64 b = us / kBucketUs;
+    ++m_buckets[b < kBuckets ? int(b) : kBuckets - 1];
+    ++m_count;
+    m_sumUs += us;
+    if (us > m_maxUs) m_maxUs = us;
+}
+
+qint64 LatencyHistogram::percentileUs(double p) const {
+    if (!m_count) return 0;
+    const quint64 target = quint64(qBound(0.0, p, 1.0) * double(m_count - 1)) + 1;
+    quint64 seen = 0;
+    for (int i = 0; i < kBuckets; ++i) {
+        seen += m_buckets[i];
+        if (seen >= target)
+            return i == kBuckets - 1 ? m_maxUs : qMin(qint64(i + 1) * kBucketUs, m_maxUs);
+    }
+    return m_maxUs;
+}
+
+QJsonObject LatencyHistogram::toJson() const {
+    QJsonObject o;
+    o["count"]   = qint64(m_count);
+    o["mean_ms"] = meanUs() / 1000.0;
+    o["p50_ms"]  = percentileUs(0.50) / 1000.0;
+    o["p90_ms"]  = percentileUs(0.90) / 1000.0;
+    o["p99_ms"]  = percentileUs(0.99) / 1000.0;
+    o["max_ms"]  = m_maxUs / 1000.0;
+    o["bucket_ms"] = kBucketUs / 1000.0;
+
+    // Counts per bucket, trailing empties trimmed
+    int last = kBuckets - 1;
+    while (last >= 0 && !m_buckets[last]) --last;
+    QJsonArray buckets;
+    for (int i = 0; i <= last; ++i) buckets.append(qint64(m_buckets[i]));
+    o["buckets"] = buckets;
+    return o;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// LatencyTracer
+// ─────────────────────────────────────────────────────────────────────────────
+
+LatencyTracer::LatencyTracer() {
+    timespec ts{};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    m_clock.start();
+    m_originNs = qint64(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+LatencyTracer& LatencyTracer::instance() {
+    static LatencyTracer s;
+    return s;
+}
+
+void LatencyTracer::begin(LatencyPath path, qint64 arrivalNs, const void* client) {
+    Pending& p = m_pending[int(path)];
+    // An older event still unreflected is the sample — unless it has gone
+    // stale without a frame, in which case it is dropped
+    if (p.active && arrivalNs - p.arrivalNs <= kMaxPendingNs) return;
+
+    p.active        = true;
+    p.arrivalNs     = arrivalNs;
+    p.client        = client;
+    p.waitingCommit = client != nullptr;
+}
+
+void LatencyTracer::clientCommitted(const void* client) {
+    for (auto& p : m_pending) {
+        if (p.active && p.waitingCommit && p.client == client)
+            p.waitingCommit = false;
+    }
+}
+
+void LatencyTracer::framePresented() {
+    const qint64 t = now();
+    if (m_lastFrameNs >= 0) m_frames.add((t - m_lastFrameNs) / 1000);
+    m_lastFrameNs = t;
+
+    for (int i = 0; i < kLatencyPathCount; ++i) {
+        Pending& p = m_pending[i];
+        if (!p.active) continue;
+        if (t - p.arrivalNs > kMaxPendingNs) {
+            p = Pending();
+            continue;
+        }
+        if (p.waitingCommit) continue;
+        m_hist[i].add((t - p.arrivalNs) / 1000);
+        p = Pending();
+    }
+}
+
+void LatencyTracer::reset() {
+    m_pending.fill(Pending());
+    for (auto& h : m_hist) h.clear();
+    m_frames.clear();
+    m_lastFrameNs = -1;
+}
+
+QJsonObject LatencyTracer::toJson() const {
+    QJsonObject o;
+    for (int i = 0; i < kLatencyPathCount; ++i)
+        o[pathName(LatencyPath(i))] = m_hist[i].toJson();
+    o["frame_interval"] = m_frames.toJson();
+    return o;
+}
+
+const char* LatencyTracer::pathName(LatencyPath path) {
+    switch (path) {
+        case LatencyPath::KeybindAction:     return "keybind";
+        case LatencyPath::Drag:              return "drag";
+        case LatencyPath::ClientKeyEcho:     return "client_key";
+        case LatencyPath::ClientPointerEcho: return "client_pointer";
+    }
+    return "unknown";
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <QJsonObject>
+#include <QElapsedTimer>
+#include <array>
+
+// ─────────────────────────────────────────────────────────────────────────────
+// LatencyPath
+//
+// The routes an input event can take to the screen.  Each one keeps its own
+// histogram.
+// ─────────────────────────────────────────────────────────────────────────────
+enum class LatencyPath : quint8 {
+    KeybindAction,      ///< Key press → compositor action → frame
+    Drag,               ///< Pointer motion during a move / resize grab → frame
+    ClientKeyEcho,      ///< Key forwarded to a client → client commit → frame
+    ClientPointerEcho   ///< Motion forwarded to a client → client commit → frame
+};
+
+constexpr int kLatencyPathCount = int(LatencyPath::ClientPointerEcho) + 1;
+
+// ─────────────────────────────────────────────────────────────────────────────
+// LatencyHistogram
+//
+// Fixed 0.25 ms buckets up to 100 ms plus an overflow bucket — fine enough
+// to tell a 60 Hz frame from a 144 Hz one, small enough to keep per path
+// and report whole.
+// ─────────────────────────────────────────────────────────────────────────────
+class LatencyHistogram {
+public:
+    static constexpr int kBucketUs = 250;
+    static constexpr int kBuckets  = 400;   ///< Last bucket collects ≥ 100 ms
+
+    void add(qint64 us);
+    void clear() { *this = LatencyHistogram(); }
+
+    quint64 count()  const { return m_count; }
+    qint64  maxUs()  const { return m_maxUs; }
+    double  meanUs() const { return m_count ? double(m_sumUs) / m_count : 0.0; }
+
+    /// Upper bound of the bucket holding the \p p-th quantile (0 … 1).
+    qint64  percentileUs(double p) const;
+
+    QJsonObject toJson() const;
+
+private:
+    std::array<quint32, kBuckets> m_buckets{};
+    quint64 m_count = 0;
+    qint64  m_sumUs = 0;
+    qint64  m_maxUs = 0;
+};
+
+// ─────────────────────────────────────────────────────────────────────────────
+// LatencyTracer
+//
+// Input-to-photon latency, measured inside the compositor:
+//
+//   1. InputHandler stamps every event with now() as it arrives and, once it
+//      knows which path the event took, calls begin().
+//   2. Client paths wait for clientCommitted() from the window the input was
+//      sent to — its first new buffer after the event.
+//   3. framePresented() (WMOutput, on frameSwapped) closes every path that is
+//      ready and records arrival → swap into that path's histogram.
+//
+// One sample per path per frame: while a path is pending, later events only
+// ride along, so the recorded value is the oldest unreflected event — the
+// delay the user actually sees.  Samples not closed within kMaxPendingNs
+// (a key the client ignored, an action that redrew nothing) are dropped
+// rather than charged to whatever is drawn next.
+//
+// GUI thread only.
+// ─────────────────────────────────────────────────────────────────────────────
+class LatencyTracer {
+public:
+    static LatencyTracer& instance();
+
+    /// Monotonic nanoseconds on the tracer's clock.
+    qint64 now() const { return m_clock.nsecsElapsed(); }
+
+    /// A kernel CLOCK_MONOTONIC timestamp (evdev / libinput event time) on
+    /// the tracer's clock — lets a backend stamp events when the device
+    /// produced them rather than when we got round to reading them.
+    qint64 fromMonotonicUs(qint64 us) const { return us * 1000 - m_originNs; }
+
+    /// An event that arrived at \p arrivalNs took \p path.  For client
+    /// paths \p client identifies the window it was forwarded to.
+    void begin(LatencyPath path, qint64 arrivalNs, const void* client = nullptr);
+
+    /// \p client committed a new buffer.
+    void clientCommitted(const void* client);
+
+    /// A frame reached the screen.
+    void framePresented();
+
+    const LatencyHistogram& histogram(LatencyPath path) const {
+        return m_hist[int(path)];
+    }
+
+    /// Time between consecutive presented frames.  Idle gaps (nothing to
+    /// redraw) land in the overflow bucket.
+    const LatencyHistogram& frameIntervals() const { return m_frames; }
+
+    void reset();
+
+    /// { "keybind": {...}, "drag": {...}, ..., "frame_interval": {...} }
+    /// — see LatencyHistogram::toJson()
+    QJsonObject toJson() const;
+
+    static const char* pathName(LatencyPath path);
+
+private:
+    LatencyTracer();
+
+    static constexpr qint64 kMaxPendingNs = 1000LL * 1000 * 1000;   ///< 1 s
+
+    struct Pending {
+        bool        active        = false;
+        bool        waitingCommit = false;
+        qint64      arrivalNs     = 0;
+        const void* client        = nullptr;
+    };
+
+    QElapsedTimer                                  m_clock;
+    qint64                                         m_originNs = 0;  ///< CLOCK_MONOTONIC at m_clock.start()
+    std::array<Pending, kLatencyPathCount>          m_pending{};
+    std::array<LatencyHistogram, kLatencyPathCount> m_hist{};
+    LatencyHistogram                               m_frames;
+    qint64                                         m_lastFrameNs = -1;
+};
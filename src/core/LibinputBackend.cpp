@@ -0,0 +1,470 @@
+#include "LibinputBackend.h"
+#include "InputHandler.h"
+#include "Config.h"
+#include "LatencyTracer.h"
+
+#include <QThread>
+#include <QSemaphore>
+#include <QSocketNotifier>
+#include <QKeyEvent>
+#include <QDebug>
+
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <linux/input.h>
+#include <libinput.h>
+#include <libudev.h>
+#include <xkbcommon/xkbcommon.h>
+
+namespace {
+
+// Same thresholds as InputHandler's touch recognition, in libinput's
+// normalised (1000 dpi) units
+constexpr float kSwipeThreshold = 80.f;
+constexpr float kPinchThreshold = 0.15f;
+
+int openRestricted(const char* path, int flags, void*) {
+    const int fd = ::open(path, flags | O_CLOEXEC);
+    return fd < 0 ? -errno : fd;
+}
+
+void closeRestricted(int fd, void*) { ::close(fd); }
+
+const libinput_interface kInterface = { openRestricted, closeRestricted };
+
+Qt::MouseButton qtButton(uint32_t code) {
+    switch (code) {
+        case BTN_LEFT:   return Qt::LeftButton;
+        case BTN_RIGHT:  return Qt::RightButton;
+        case BTN_MIDDLE: return Qt::MiddleButton;
+        case BTN_SIDE:   return Qt::BackButton;
+        case BTN_EXTRA:  return Qt::ForwardButton;
+        default:         return Qt::NoButton;
+    }
+}
+
+int qtKey(xkb_keysym_t sym) {
+    // Printable ASCII: Qt uses the upper-case character code
+    if (sym >= 0x20 && sym <= 0x7e)
+        return (sym >= 'a' && sym <= 'z') ? int(sym - 'a' + 'A') : int(sym);
+    if (sym >= 0xa0 && sym <= 0xff) return int(sym);   // Latin-1, same codes
+    if (sym >= XKB_KEY_F1 && sym <= XKB_KEY_F35) return Qt::Key_F1 + int(sym - XKB_KEY_F1);
+
+    switch (sym) {
+        case XKB_KEY_Escape:       return Qt::Key_Escape;
+        case XKB_KEY_Tab:          return Qt::Key_Tab;
+        case XKB_KEY_ISO_Left_Tab: return Qt::Key_Backtab;
+        case XKB_KEY_BackSpace:    return Qt::Key_Backspace;
+        case XKB_KEY_Return:       return Qt::Key_Return;
+        case XKB_KEY_KP_Enter:     return Qt::Key_Enter;
+        case XKB_KEY_Insert:       return Qt::Key_Insert;
+        case XKB_KEY_Delete:       return Qt::Key_Delete;
+        case XKB_KEY_Pause:        return Qt::Key_Pause;
+        case XKB_KEY_Print:        return Qt::Key_Print;
+        case XKB_KEY_Home:         return Qt::Key_Home;
+        case XKB_KEY_End:          return Qt::Key_End;
+        case XKB_KEY_Left:         return Qt::Key_Left;
+        case XKB_KEY_Up:           return Qt::Key_Up;
+        case XKB_KEY_Right:        return Qt::Key_Right;
+        case XKB_KEY_Down:         return Qt::Key_Down;
+        case XKB_KEY_Page_Up:      return Qt::Key_PageUp;
+        case XKB_KEY_Page_Down:    return Qt::Key_PageDown;
+        case XKB_KEY_Shift_L:
+        case XKB_KEY_Shift_R:      return Qt::Key_Shift;
+        case XKB_KEY_Control_L:
+        case XKB_KEY_Control_R:    return Qt::Key_Control;
+        case XKB_KEY_Alt_L:
+        case XKB_KEY_Alt_R:        return Qt::Key_Alt;
+        case XKB_KEY_Meta_L:
+        case XKB_KEY_Meta_R:       return Qt::Key_Meta;
+        case XKB_KEY_Super_L:      return Qt::Key_Super_L;
+        case XKB_KEY_Super_R:      return Qt::Key_Super_R;
+        case XKB_KEY_Caps_Lock:    return Qt::Key_CapsLock;
+        case XKB_KEY_Num_Lock:     return Qt::Key_NumLock;
+        case XKB_KEY_Scroll_Lock:  return Qt::Key_ScrollLock;
+        case XKB_KEY_Menu:         return Qt::Key_Menu;
+        case XKB_KEY_XF86AudioRaiseVolume:  return Qt::Key_VolumeUp;
+        case XKB_KEY_XF86AudioLowerVolume:  return Qt::Key_VolumeDown;
+        case XKB_KEY_XF86AudioMute:         return Qt::Key_VolumeMute;
+        case XKB_KEY_XF86AudioPlay:         return Qt::Key_MediaPlay;
+        case XKB_KEY_XF86AudioNext:         return Qt::Key_MediaNext;
+        case XKB_KEY_XF86AudioPrev:         return Qt::Key_MediaPrevious;
+        case XKB_KEY_XF86MonBrightnessUp:   return Qt::Key_MonBrightnessUp;
+        case XKB_KEY_XF86MonBrightnessDown: return Qt::Key_MonBrightnessDown;
+        default:                   return Qt::Key_unknown;
+    }
+}
+
+} // namespace
+
+// ─────────────────────────────────────────────────────────────────────────────
+// LibinputBackend::Thread — everything that touches libinput / xkb
+// ─────────────────────────────────────────────────────────────────────────────
+
+class LibinputBackend::Thread : public QThread {
+public:
+    Thread(LibinputBackend* owner, const QString& seat, const QStringList& paths, float accel)
+    : m_owner(owner), m_seat(seat), m_paths(paths), m_accel(accel) {}
+
+    /// Start and wait until the context is up (or failed).
+    bool launch() {
+        start();
+        m_started.acquire();
+        return m_ok;
+    }
+
+protected:
+    void run() override {
+        m_ok = setup();
+        m_started.release();
+        if (!m_ok) { teardown(); return; }
+
+        QSocketNotifier notifier(libinput_get_fd(m_li), QSocketNotifier::Read);
+        QObject::connect(&notifier, &QSocketNotifier::activated, &notifier, [this] { drain(); });
+        drain();   // device-added events queued during setup
+
+        exec();
+        teardown();
+    }
+
+private:
+    bool setup();
+    void teardown();
+    void drain();
+    void translate(libinput_event* ev, NativeInputBatch& out);
+    void translateKey(libinput_event_keyboard* k, NativeInputBatch& out);
+    void translateGesture(libinput_event* ev, NativeInputBatch& out);
+
+    LibinputBackend* m_owner;
+    QString          m_seat;
+    QStringList      m_paths;
+    float            m_accel;     ///< libinput pointer speed, snapshot of Config
+    QSemaphore       m_started;
+    bool             m_ok = false;
+
+    udev*        m_udev   = nullptr;
+    libinput*    m_li     = nullptr;
+    xkb_context* m_xkb    = nullptr;
+    xkb_keymap*  m_keymap = nullptr;
+    xkb_state*   m_state  = nullptr;
+
+    struct { xkb_mod_index_t shift, ctrl, alt, logo; } m_mods{};
+
+    // Gesture in progress
+    int   m_fingers   = 0;
+    float m_swipeX    = 0.f, m_swipeY = 0.f;
+    bool  m_committed = false;
+    float m_scale     = 1.f;
+};
+
+bool LibinputBackend::Thread::setup() {
+    // ── Keymap ────────────────────────────────────────────────────────────
+    // No rule names: xkbcommon reads XKB_DEFAULT_LAYOUT & co.
+    m_xkb    = xkb_context_new(XKB_CONTEXT_NO_FLAGS);
+    m_keymap = m_xkb ? xkb_keymap_new_from_names(m_xkb, nullptr, XKB_KEYMAP_COMPILE_NO_FLAGS)
+                     : nullptr;
+    m_state  = m_keymap ? xkb_state_new(m_keymap) : nullptr;
+    if (!m_state) {
+        qWarning() << "[Libinput] cannot compile xkb keymap";
+        return false;
+    }
+    m_mods = { xkb_keymap_mod_get_index(m_keymap, XKB_MOD_NAME_SHIFT),
+               xkb_keymap_mod_get_index(m_keymap, XKB_MOD_NAME_CTRL),
+               xkb_keymap_mod_get_index(m_keymap, XKB_MOD_NAME_ALT),
+               xkb_keymap_mod_get_index(m_keymap, XKB_MOD_NAME_LOGO) };
+
+    // ── Devices ───────────────────────────────────────────────────────────
+    if (!m_paths.isEmpty()) {
+        m_li = libinput_path_create_context(&kInterface, nullptr);
+        if (!m_li) return false;
+        int added = 0;
+        for (const QString& p : m_paths) {
+            if (libinput_path_add_device(m_li, p.toLocal8Bit().constData())) ++added;
+            else qWarning() << "[Libinput] cannot add" << p;
+        }
+        return added > 0;
+    }
+
+    m_udev = udev_new();
+    if (!m_udev) return false;
+    m_li = libinput_udev_create_context(&kInterface, nullptr, m_udev);
+    if (!m_li) return false;
+    if (libinput_udev_assign_seat(m_li, m_seat.toLocal8Bit().constData()) != 0) {
+        qWarning() << "[Libinput] cannot assign seat" << m_seat;
+        return false;
+    }
+    return true;
+}
+
+void LibinputBackend::Thread::teardown() {
+    if (m_li)     { libinput_unref(m_li);         m_li     = nullptr; }
+    if (m_udev)   { udev_unref(m_udev);           m_udev   = nullptr; }
+    if (m_state)  { xkb_state_unref(m_state);     m_state  = nullptr; }
+    if (m_keymap) { xkb_keymap_unref(m_keymap);   m_keymap = nullptr; }
+    if (m_xkb)    { xkb_context_unref(m_xkb);     m_xkb    = nullptr; }
+}
+
+void LibinputBackend::Thread::drain() {
+    libinput_dispatch(m_li);
+
+    NativeInputBatch batch;
+    while (libinput_event* ev = libinput_get_event(m_li)) {
+        translate(ev, batch);
+        libinput_event_destroy(ev);
+    }
+    if (batch.isEmpty()) return;
+
+    // One queued call per drain, not per event
+    LibinputBackend* owner = m_owner;
+    QMetaObject::invokeMethod(owner, [owner, batch = std::move(batch)] {
+        owner->deliver(batch);
+    }, Qt::QueuedConnection);
+}
+
+void LibinputBackend::Thread::translate(libinput_event* ev, NativeInputBatch& out) {
+    NativeInputEvent e;
+
+    switch (libinput_event_get_type(ev)) {
+        case LIBINPUT_EVENT_DEVICE_ADDED: {
+            libinput_device* dev = libinput_event_get_device(ev);
+            if (libinput_device_config_tap_get_finger_count(dev) > 0)
+                libinput_device_config_tap_set_enabled(dev, LIBINPUT_CONFIG_TAP_ENABLED);
+            // Acceleration stays libinput's, on this thread: only the speed is ours
+            if (libinput_device_config_accel_is_available(dev))
+                libinput_device_config_accel_set_speed(dev, qBound(-1.0, double(m_accel), 1.0));
+            qInfo() << "[Libinput] device added:" << libinput_device_get_name(dev);
+            return;
+        }
+        case LIBINPUT_EVENT_DEVICE_REMOVED:
+            qInfo() << "[Libinput] device removed:"
+                    << libinput_device_get_name(libinput_event_get_device(ev));
+            return;
+
+        case LIBINPUT_EVENT_POINTER_MOTION: {
+            auto* p  = libinput_event_get_pointer_event(ev);
+            e.kind   = NativeInputEvent::Motion;
+            e.dx     = float(libinput_event_pointer_get_dx(p));   // accelerated
+            e.dy     = float(libinput_event_pointer_get_dy(p));
+            e.timeUs = qint64(libinput_event_pointer_get_time_usec(p));
+            break;
+        }
+        case LIBINPUT_EVENT_POINTER_BUTTON: {
+            auto* p   = libinput_event_get_pointer_event(ev);
+            e.kind    = NativeInputEvent::Button;
+            e.code    = quint32(qtButton(libinput_event_pointer_get_button(p)));
+            e.pressed = libinput_event_pointer_get_button_state(p)
+                        == LIBINPUT_BUTTON_STATE_PRESSED;
+            e.timeUs  = qint64(libinput_event_pointer_get_time_usec(p));
+            if (!e.code) return;
+            break;
+        }
+        case LIBINPUT_EVENT_POINTER_AXIS: {
+            // libinput: 15 units per wheel click, positive = down/right.
+            // Qt: 120 per click, positive = away from the user.
+            auto* p  = libinput_event_get_pointer_event(ev);
+            e.kind   = NativeInputEvent::Scroll;
+            if (libinput_event_pointer_has_axis(p, LIBINPUT_POINTER_AXIS_SCROLL_VERTICAL))
+                e.dy = -8.f * float(libinput_event_pointer_get_axis_value(
+                           p, LIBINPUT_POINTER_AXIS_SCROLL_VERTICAL));
+            if (libinput_event_pointer_has_axis(p, LIBINPUT_POINTER_AXIS_SCROLL_HORIZONTAL))
+                e.dx = -8.f * float(libinput_event_pointer_get_axis_value(
+                           p, LIBINPUT_POINTER_AXIS_SCROLL_HORIZONTAL));
+            e.timeUs = qint64(libinput_event_pointer_get_time_usec(p));
+            if (e.dx == 0.f && e.dy == 0.f) return;   // scroll stop
+            break;
+        }
+
+        case LIBINPUT_EVENT_KEYBOARD_KEY:
+            translateKey(libinput_event_get_keyboard_event(ev), out);
+            return;
+
+        case LIBINPUT_EVENT_GESTURE_SWIPE_BEGIN:
+        case LIBINPUT_EVENT_GESTURE_SWIPE_UPDATE:
+        case LIBINPUT_EVENT_GESTURE_SWIPE_END:
+        case LIBINPUT_EVENT_GESTURE_PINCH_BEGIN:
+        case LIBINPUT_EVENT_GESTURE_PINCH_UPDATE:
+        case LIBINPUT_EVENT_GESTURE_PINCH_END:
+            translateGesture(ev, out);
+            return;
+
+        default:
+            return;
+    }
+    out.append(e);
+}
+
+void LibinputBackend::Thread::translateKey(libinput_event_keyboard* k, NativeInputBatch& out) {
+    const uint32_t     code    = libinput_event_keyboard_get_key(k);
+    const bool         pressed = libinput_event_keyboard_get_key_state(k)
+                                 == LIBINPUT_KEY_STATE_PRESSED;
+    const xkb_keycode_t kc     = code + 8;
+
+    // Symbol and text come from the state before this key changes it
+    const xkb_keysym_t sym  = xkb_state_key_get_one_sym(m_state, kc);
+    const uint32_t     utf  = pressed ? xkb_state_key_get_utf32(m_state, kc) : 0;
+    xkb_state_update_key(m_state, kc, pressed ? XKB_KEY_DOWN : XKB_KEY_UP);
+
+    auto active = [this](xkb_mod_index_t m) {
+        return m != XKB_MOD_INVALID
+            && xkb_state_mod_index_is_active(m_state, m, XKB_STATE_MODS_EFFECTIVE) > 0;
+    };
+    Qt::KeyboardModifiers mods;
+    if (active(m_mods.shift)) mods |= Qt::ShiftModifier;
+    if (active(m_mods.ctrl))  mods |= Qt::ControlModifier;
+    if (active(m_mods.alt))   mods |= Qt::AltModifier;
+    if (active(m_mods.logo))  mods |= Qt::MetaModifier;
+
+    NativeInputEvent e;
+    e.kind      = NativeInputEvent::Key;
+    e.pressed   = pressed;
+    e.code      = quint32(qtKey(sym));
+    e.scancode  = code;
+    e.modifiers = quint32(mods.toInt());
+    e.text      = (utf >= 0x20 && utf != 0x7f) ? char32_t(utf) : 0;
+    e.timeUs    = qint64(libinput_event_keyboard_get_time_usec(k));
+    out.append(e);
+}
+
+void LibinputBackend::Thread::translateGesture(libinput_event* ev, NativeInputBatch& out) {
+    auto* g = libinput_event_get_gesture_event(ev);
+
+    auto emitGesture = [&](GestureType type, float magnitude) {
+        NativeInputEvent e;
+        e.kind    = NativeInputEvent::Gesture;
+        e.code    = quint32(type);
+        e.fingers = quint8(m_fingers);
+        e.dx      = magnitude;
+        e.timeUs  = qint64(libinput_event_gesture_get_time_usec(g));
+        out.append(e);
+    };
+
+    switch (libinput_event_get_type(ev)) {
+        case LIBINPUT_EVENT_GESTURE_SWIPE_BEGIN:
+        case LIBINPUT_EVENT_GESTURE_PINCH_BEGIN:
+            m_fingers   = libinput_event_gesture_get_finger_count(g);
+            m_swipeX    = m_swipeY = 0.f;
+            m_committed = false;
+            m_scale     = 1.f;
+            return;
+
+        // ── Swipe: committed once, as soon as one axis clearly dominates ──
+        case LIBINPUT_EVENT_GESTURE_SWIPE_UPDATE: {
+            if (m_committed) return;
+            m_swipeX += float(libinput_event_gesture_get_dx_unaccelerated(g));
+            m_swipeY += float(libinput_event_gesture_get_dy_unaccelerated(g));
+            const float ax = qAbs(m_swipeX), ay = qAbs(m_swipeY);
+            if (ax > kSwipeThreshold && ax > ay * 1.5f) {
+                m_committed = true;
+                emitGesture(m_swipeX > 0 ? GestureType::SwipeRight : GestureType::SwipeLeft, ax);
+            } else if (ay > kSwipeThreshold && ay > ax * 1.5f) {
+                m_committed = true;
+                emitGesture(m_swipeY > 0 ? GestureType::SwipeDown : GestureType::SwipeUp, ay);
+            }
+            return;
+        }
+        case LIBINPUT_EVENT_GESTURE_SWIPE_END:
+            m_fingers = 0;
+            return;
+
+        // ── Pinch: reported once, at the end, if it went far enough ───────
+        case LIBINPUT_EVENT_GESTURE_PINCH_UPDATE:
+            m_scale = float(libinput_event_gesture_get_scale(g));
+            return;
+        case LIBINPUT_EVENT_GESTURE_PINCH_END:
+            if (!libinput_event_gesture_get_cancelled(g) && qAbs(m_scale - 1.f) > kPinchThreshold)
+                emitGesture(GestureType::Pinch, m_scale - 1.f);
+            m_fingers = 0;
+            return;
+
+        default:
+            return;
+    }
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// LibinputBackend
+// ─────────────────────────────────────────────────────────────────────────────
+
+LibinputBackend::LibinputBackend(InputHandler* input, QObject* parent)
+: QObject(parent), m_input(input) {}
+
+LibinputBackend::~LibinputBackend() { stop(); }
+
+bool LibinputBackend::start(const QString& seat) {
+    QString s = seat;
+    if (s.isEmpty()) s = qEnvironmentVariable("XDG_SEAT", QStringLiteral("seat0"));
+    return launch(new Thread(this, s, {}, Config::instance().input.pointerAccel));
+}
+
+bool LibinputBackend::startWithDevices(const QStringList& nodes) {
+    if (nodes.isEmpty()) return false;
+    return launch(new Thread(this, QString(), nodes, Config::instance().input.pointerAccel));
+}
+
+bool LibinputBackend::launch(Thread* t) {
+    stop();
+    t->setObjectName(QStringLiteral("libinput"));
+    if (!t->launch()) {
+        t->wait();
+        delete t;
+        qWarning() << "[Libinput] backend unavailable — using Qt input events";
+        return false;
+    }
+    m_thread = t;
+    if (m_input) m_input->setNativeInput(true);
+    qInfo() << "[Libinput] input thread running";
+    return true;
+}
+
+void LibinputBackend::stop() {
+    if (!m_thread) return;
+    m_thread->quit();
+    m_thread->wait();
+    delete m_thread;
+    m_thread = nullptr;
+    if (m_input) m_input->setNativeInput(false);
+}
+
+void LibinputBackend::deliver(const NativeInputBatch& batch) {
+    if (!m_input) return;
+    auto& tracer = LatencyTracer::instance();
+
+    for (const NativeInputEvent& e : batch) {
+        const qint64 arrival = tracer.fromMonotonicUs(e.timeUs);
+
+        switch (e.kind) {
+            case NativeInputEvent::Motion:
+                m_input->handlePointerDelta(QPointF(e.dx, e.dy), arrival);
+                break;
+
+            case NativeInputEvent::Button:
+                if (e.pressed)
+                    m_input->handleMousePress(m_input->cursorPos(), Qt::MouseButton(e.code),
+                                              m_input->currentModifiers());
+                else
+                    m_input->handleMouseRelease(m_input->cursorPos(), Qt::MouseButton(e.code),
+                                                m_input->currentModifiers());
+                break;
+
+            case NativeInputEvent::Scroll:
+                m_input->handleWheel(m_input->cursorPos(), QPointF(e.dx, e.dy),
+                                     m_input->currentModifiers());
+                break;
+
+            case NativeInputEvent::Key: {
+                const QString text = e.text ? QString::fromUcs4(&e.text, 1) : QString();
+                QKeyEvent ev(e.pressed ? QEvent::KeyPress : QEvent::KeyRelease,
+                             int(e.code), Qt::KeyboardModifiers(e.modifiers),
+                             e.scancode + 8, 0, e.modifiers, text);
+                if (e.pressed) m_input->handleKeyPress(&ev, arrival);
+                else           m_input->handleKeyRelease(&ev);
+                break;
+            }
+
+            case NativeInputEvent::Gesture:
+                m_input->handleGesture(GestureType(e.code), e.fingers, e.dx);
+                break;
+        }
+    }
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+class InputHandler;
+
+// ─────────────────────────────────────────────────────────────────────────────
+// NativeInputEvent
+//
+// One input event as the libinput thread hands it over — plain data, no
+// QEvent, no strings.  Keys are already translated through xkbcommon;
+// motion is already accelerated; gestures are already recognised.
+// ─────────────────────────────────────────────────────────────────────────────
+struct NativeInputEvent {
+    enum Kind : quint8 { Motion, Button, Scroll, Key, Gesture };
+
+    Kind     kind      = Motion;
+    bool     pressed   = false;    ///< Button / Key
+    quint8   fingers   = 0;        ///< Gesture
+    quint32  code      = 0;        ///< Qt::MouseButton / Qt::Key / GestureType
+    quint32  scancode  = 0;        ///< Key: evdev keycode
+    quint32  modifiers = 0;        ///< Key: Qt::KeyboardModifiers after the event
+    char32_t text      = 0;        ///< Key: character produced, 0 if none
+    float    dx = 0.f, dy = 0.f;   ///< Motion delta / scroll angle delta / gesture magnitude (dx)
+    qint64   timeUs    = 0;        ///< Kernel CLOCK_MONOTONIC
+};
+
+using NativeInputBatch = QVector<NativeInputEvent>;
+
+// ─────────────────────────────────────────────────────────────────────────────
+// LibinputBackend
+//
+// Optional replacement for Qt widget input events.  A dedicated thread owns
+// the libinput context (udev seat, or an explicit device list through the
+// path backend — recorded evdev streams replayed via uinput), drains it
+// whenever its fd is readable, and posts each drain to the GUI thread as one
+// NativeInputBatch.  Pointer acceleration is libinput's own, at the speed
+// set by [input] pointer_accel; touchpad swipes and pinches are recognised
+// on the input thread; key codes go through an xkbcommon keymap
+// (XKB_DEFAULT_* environment, as for clients).
+//
+// So reading, acceleration and recognition keep running while the GUI
+// thread is busy painting, and every event carries the kernel's timestamp
+// into the LatencyTracer instead of the time we got round to it.
+//
+// Devices are opened directly (open_restricted is plain open()), so the
+// compositor needs read access to /dev/input — the input group, or a
+// logind session handing out fds.
+// ─────────────────────────────────────────────────────────────────────────────
+class LibinputBackend : public QObject {
+    Q_OBJECT
+public:
+    explicit LibinputBackend(InputHandler* input, QObject* parent = nullptr);
+    ~LibinputBackend() override;
+
+    /// Enumerate \p seat through udev (empty: $XDG_SEAT, else "seat0").
+    bool start(const QString& seat = QString());
+
+    /// Path backend: exactly these /dev/input/event* nodes, no hotplug.
+    bool startWithDevices(const QStringList& nodes);
+
+    void stop();
+    bool isActive() const { return m_thread != nullptr; }
+
+private:
+    class Thread;
+
+    bool launch(Thread* t);
+    void deliver(const NativeInputBatch& batch);
+
+    InputHandler* m_input  = nullptr;
+    Thread*       m_thread = nullptr;
+};
@@ -0,0 +1,185 @@
+#include "SpatialIndex.h"
+#include "Window.h"
+
+#include <climits>
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Maintenance
+// ─────────────────────────────────────────────────────────────────────────────
+
+void SpatialIndex::update(Window* w) {
+    if (!w) return;
+    const QRect rect = w->geometry();
+
+    auto it = m_entries.find(w);
+    if (it == m_entries.end()) {
+        // New windows go on top until the next restack() says otherwise
+        m_entries.insert(w, Entry{rect, int(m_entries.size())});
+        insertCells(w, rect);
+        return;
+    }
+    if (it->rect == rect) return;
+
+    removeCells(w, it->rect);
+    it->rect = rect;
+    insertCells(w, rect);
+}
+
+void SpatialIndex::remove(Window* w) {
+    auto it = m_entries.find(w);
+    if (it == m_entries.end()) return;
+    removeCells(w, it->rect);
+    m_entries.erase(it);
+}
+
+void SpatialIndex::restack(const QList<Window*>& windows) {
+    for (int i = 0; i < windows.size(); ++i) {
+        Window* w = windows[i];
+        auto it = m_entries.find(w);
+        if (it == m_entries.end()) {
+            m_entries.insert(w, Entry{w->geometry(), i});
+            insertCells(w, w->geometry());
+        } else {
+            it->z = i;
+        }
+    }
+}
+
+void SpatialIndex::clear() {
+    m_entries.clear();
+    m_cells.clear();
+    m_minCx = m_minCy = 0;
+    m_maxCx = m_maxCy = -1;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Queries
+// ─────────────────────────────────────────────────────────────────────────────
+
+Window* SpatialIndex::topAt(const QPoint& pos) const {
+    const auto cell = m_cells.constFind(cellKey(cellCoord(pos.x()), cellCoord(pos.y())));
+    if (cell == m_cells.cend()) return nullptr;
+
+    Window* best  = nullptr;
+    int     bestZ = -1;
+    for (Window* w : *cell) {
+        if (!w->isVisible()) continue;
+        const Entry e = m_entries.value(w);
+        if (e.z > bestZ && e.rect.contains(pos)) {
+            best  = w;
+            bestZ = e.z;
+        }
+    }
+    return best;
+}
+
+Window* SpatialIndex::nearest(const QPoint& from, Qt::Edge dir,
+                              const Window* exclude) const {
+    if (m_entries.isEmpty()) return nullptr;
+
+    // Work in (primary, secondary) coordinates: primary runs along \p dir,
+    // sign is +1 when moving towards larger coordinates.
+    const bool horizontal = (dir == Qt::LeftEdge || dir == Qt::RightEdge);
+    const int  sign       = (dir == Qt::RightEdge || dir == Qt::BottomEdge) ? 1 : -1;
+
+    const int p0   = horizontal ? from.x() : from.y();
+    const int s0   = horizontal ? from.y() : from.x();
+    const int minP = horizontal ? m_minCx : m_minCy;
+    const int maxP = horizontal ? m_maxCx : m_maxCy;
+    const int minS = horizontal ? m_minCy : m_minCx;
+    const int maxS = horizontal ? m_maxCy : m_maxCx;
+
+    Window* best      = nullptr;
+    int     bestScore = INT_MAX;
+
+    // One strip of cells per step along the primary axis.  A window is
+    // considered in the cell holding its centre only, so it is scored once
+    // no matter how many cells its rect spans.
+    const int start = sign > 0 ? qMax(cellCoord(p0), minP) : qMin(cellCoord(p0), maxP);
+    for (int c = start; sign > 0 ? c <= maxP : c >= minP; c += sign) {
+        const int cellLo = c * kCellSize;
+        const int cellHi = cellLo + kCellSize - 1;
+        const int nearDist = qMax(0, sign > 0 ? cellLo - p0 : p0 - cellHi);
+        const int farDist  = qMax(0, sign > 0 ? cellHi - p0 : p0 - cellLo);
+
+        // Score is at least 4 × primary distance; nothing farther can win.
+        if (best && nearDist * 4 >= bestScore) break;
+
+        // The 90° sector limits the sideways reach to the primary distance.
+        const int sLo = qMax(minS, cellCoord(s0 - farDist));
+        const int sHi = qMin(maxS, cellCoord(s0 + farDist));
+
+        for (int s = sLo; s <= sHi; ++s) {
+            const auto cell = m_cells.constFind(horizontal ? cellKey(c, s) : cellKey(s, c));
+            if (cell == m_cells.cend()) continue;
+
+            for (Window* w : *cell) {
+                if (w == exclude || !w->isVisible()) continue;
+
+                const QPoint wc = m_entries.value(w).rect.center();
+                const int wp = horizontal ? wc.x() : wc.y();
+                const int ws = horizontal ? wc.y() : wc.x();
+                if (cellCoord(wp) != c || cellCoord(ws) != s) continue;
+
+                const int primary   = (wp - p0) * sign;
+                const int secondary = qAbs(ws - s0);
+                if (primary <= 0 || primary < secondary) continue;
+
+                const int score = primary * 4 + secondary;
+                if (score < bestScore) {
+                    bestScore = score;
+                    best      = w;
+                }
+            }
+        }
+    }
+    return best;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Private helpers
+// ─────────────────────────────────────────────────────────────────────────────
+
+int SpatialIndex::cellCoord(int v) {
+    // Floor division — windows may sit partly at negative coordinates
+    return v >= 0 ? v / kCellSize : -((-v + kCellSize - 1) / kCellSize);
+}
+
+SpatialIndex::CellKey SpatialIndex::cellKey(int cx, int cy) {
+    return (CellKey(quint32(cx)) << 32) | quint32(cy);
+}
+
+void SpatialIndex::insertCells(Window* w, const QRect& rect) {
+    if (rect.isEmpty()) return;
+
+    const int cx0 = cellCoord(rect.left()),  cx1 = cellCoord(rect.right());
+    const int cy0 = cellCoord(rect.top()),   cy1 = cellCoord(rect.bottom());
+    for (int cx = cx0; cx <= cx1; ++cx) {
+        for (int cy = cy0; cy <= cy1; ++cy)
+            m_cells[cellKey(cx, cy)].append(w);
+    }
+
+    if (m_maxCx < m_minCx) {
+        m_minCx = cx0; m_maxCx = cx1;
+        m_minCy = cy0; m_maxCy = cy1;
+    } else {
+        m_minCx = qMin(m_minCx, cx0); m_maxCx = qMax(m_maxCx, cx1);
+        m_minCy = qMin(m_minCy, cy0); m_maxCy = qMax(m_maxCy, cy1);
+    }
+}
+
+void SpatialIndex::removeCells(Window* w, const QRect& rect) {
+    if (rect.isEmpty()) return;
+
+    // Emptied cells are kept: a window being animated across the screen
+    // re-enters the same few cells every frame, and keeping the lists
+    // avoids a free/alloc pair per cell per frame.
+    const int cx0 = cellCoord(rect.left()),  cx1 = cellCoord(rect.right());
+    const int cy0 = cellCoord(rect.top()),   cy1 = cellCoord(rect.bottom());
+    for (int cx = cx0; cx <= cx1; ++cx) {
+        for (int cy = cy0; cy <= cy1; ++cy) {
+            auto it = m_cells.find(cellKey(cx, cy));
+            if (it != m_cells.end()) it->removeOne(w);
+        }
+    }
+}
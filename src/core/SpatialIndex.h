@@ -0,0 +1,86 @@
+#pragma once
+
+#include <QRect>
+#include <QPoint>
+#include <QList>
+#include <QHash>
+#include <Qt>
+
+class Window;
+
+// ─────────────────────────────────────────────────────────────────────────────
+// SpatialIndex
+//
+// Uniform grid over window rects, owned by a Workspace.  Replaces the
+// "copy visibleWindows(), scan back to front" pattern on every pointer move:
+//
+//   • topAt() looks at the single cell under the point, so hit-testing costs
+//     the number of windows overlapping that cell rather than the number of
+//     windows on the workspace.
+//   • nearest() walks strips of cells outward from a point and stops once no
+//     farther strip can beat the best candidate found — directional focus.
+//
+// Each window is stored with its rect and stacking position (its index in
+// the workspace's window list; higher is on top).  The Workspace keeps the
+// index current from Window::geometryChanged and its own list edits; an
+// update only touches the cells the old and new rect cover.
+//
+// Hidden windows stay in the index and are skipped at query time, so
+// minimise / workspace switches need no bookkeeping.
+// ─────────────────────────────────────────────────────────────────────────────
+class SpatialIndex {
+public:
+    SpatialIndex() = default;
+
+    // ── Maintenance ───────────────────────────────────────────────────────
+    /// Insert \p w or move it to its current geometry.
+    void update(Window* w);
+
+    /// Drop \p w from every cell.
+    void remove(Window* w);
+
+    /// Re-read stacking order from \p windows (bottom first).  Windows not
+    /// yet indexed are inserted.
+    void restack(const QList<Window*>& windows);
+
+    void clear();
+
+    int  size()              const { return m_entries.size(); }
+    bool contains(Window* w) const { return m_entries.contains(w); }
+
+    // ── Queries ───────────────────────────────────────────────────────────
+    /// Top-most visible window whose rect contains \p pos, or nullptr.
+    Window* topAt(const QPoint& pos) const;
+
+    /// Visible window whose centre is closest to \p from in direction
+    /// \p dir, restricted to the 90° sector around that direction.  Closeness
+    /// along the direction counts four times as much as the sideways offset.
+    /// \p exclude (typically the window \p from belongs to) is never returned.
+    Window* nearest(const QPoint& from, Qt::Edge dir,
+                    const Window* exclude = nullptr) const;
+
+    /// Side length of a grid cell in pixels.
+    static constexpr int kCellSize = 256;
+
+private:
+    struct Entry {
+        QRect rect;
+        int   z = 0;
+    };
+
+    using CellKey = quint64;
+
+    static int     cellCoord(int v);
+    static CellKey cellKey(int cx, int cy);
+
+    void insertCells(Window* w, const QRect& rect);
+    void removeCells(Window* w, const QRect& rect);
+
+    QHash<Window*, Entry>          m_entries;
+    QHash<CellKey, QList<Window*>> m_cells;
+
+    // Occupied cell range — bounds the search in nearest().  Grows only;
+    // reset by clear().
+    int m_minCx = 0, m_maxCx = -1;
+    int m_minCy = 0, m_maxCy = -1;
+};
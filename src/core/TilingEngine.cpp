@@ -1,4 +1,5 @@
 #include "TilingEngine.h"
+#include "BSPTree.h"
 #include "Window.h"
 #include <QtMath>
 #include <QDebug>
@@ -31,16 +32,16 @@ QRect TilingEngine::applyInnerGap(const QRect& rect,
                                       return rect.adjusted(h, h, -h, -h);
                                   }
 
-                                  QRect TilingEngine::applyConstraints(const QRect& rect, const Window* w) const {
-                                      if (!w) return rect;
+                                  QRect TilingEngine::applyConstraints(const QRect& rect, const QSize& minSize,
+                                                                       const QSize& maxSize) const {
                                       QSize sz = rect.size();
-                                      if (w->minSize().isValid()) {
-                                          sz.setWidth (qMax(sz.width(),  w->minSize().width()));
-                                          sz.setHeight(qMax(sz.height(), w->minSize().height()));
+                                      if (minSize.isValid()) {
+                                          sz.setWidth (qMax(sz.width(),  minSize.width()));
+                                          sz.setHeight(qMax(sz.height(), minSize.height()));
                                       }
-                                      if (w->maxSize().isValid() && !w->maxSize().isEmpty()) {
-                                          if (w->maxSize().width()  > 0) sz.setWidth (qMin(sz.width(),  w->maxSize().width()));
-                                          if (w->maxSize().height() > 0) sz.setHeight(qMin(sz.height(), w->maxSize().height()));
+                                      if (maxSize.isValid() && !maxSize.isEmpty()) {
+                                          if (maxSize.width()  > 0) sz.setWidth (qMin(sz.width(),  maxSize.width()));
+                                          if (maxSize.height() > 0) sz.setHeight(qMin(sz.height(), maxSize.height()));
                                       }
                                       QPoint center = rect.center();
                                       return QRect(center.x() - sz.width() / 2,
@@ -52,19 +53,40 @@ QRect TilingEngine::applyInnerGap(const QRect& rect,
                                   // Context builder
                                   // ─────────────────────────────────────────────────────────────────────────────
 
-                                  TilingContext TilingEngine::buildContext(const QList<Window*>& windows,
-                                                                           const QRect&          area) const {
-                                                                               TilingContext ctx;
-                                                                               ctx.area        = area;
-                                                                               ctx.gaps        = m_gaps;
-                                                                               ctx.masterRatio = m_masterRatio;
-                                                                               ctx.maxColumns  = m_maxColumns;
-
-                                                                               for (auto* w : windows) {
-                                                                                   if (!w->isVisible()) continue;
-                                                                                   if (w->isFullscreen())     ctx.fullscreen.append(w);
-                                                                                   else if (w->isFloating())  ctx.floating.append(w);
-                                                                                   else                       ctx.tiled.append(w);
+                                  TilingContext& TilingEngine::buildContext(const Snapshot& snap, TilingContext& ctx) const {
+                                                                               // clear() keeps capacity (Qt 6), so the buckets stop allocating once
+                                                                               // they have grown to the workspace's window count.
+                                                                               ctx.tiled.clear();
+                                                                               ctx.minSize.clear();
+                                                                               ctx.maxSize.clear();
+                                                                               ctx.floating.clear();
+                                                                               ctx.floatGeom.clear();
+                                                                               ctx.fullscreen.clear();
+                                                                               ctx.parked.clear();
+                                                                               ctx.area        = snap.key.area;
+                                                                               ctx.gaps        = snap.key.gaps;
+                                                                               ctx.masterRatio = snap.key.masterRatio;
+                                                                               ctx.maxColumns  = snap.key.maxColumns;
+
+                                                                               // Only the snapshot is read — this may run off the GUI thread
+                                                                               for (int i = 0; i < snap.windows.size(); ++i) {
+                                                                                   Window* w = snap.windows[i];
+                                                                                   const LayoutKey::Entry& e = snap.key.windows[i];
+                                                                                   switch (WindowState(e.state)) {
+                                                                                       // Minimized: out of the layout, but a persistent BSP tree keeps
+                                                                                       // the slot it comes back to
+                                                                                       case WindowState::Minimized:  ctx.parked.append(w);     break;
+                                                                                       case WindowState::Fullscreen: ctx.fullscreen.append(w); break;
+                                                                                       case WindowState::Floating:
+                                                                                           ctx.floating.append(w);
+                                                                                           ctx.floatGeom.append(e.floatGeom);
+                                                                                           break;
+                                                                                       default:
+                                                                                           ctx.tiled.append(w);
+                                                                                           ctx.minSize.append(e.minSize);
+                                                                                           ctx.maxSize.append(e.maxSize);
+                                                                                           break;
+                                                                                   }
                                                                                }
                                                                                return ctx;
                                                                            }
@@ -75,45 +97,177 @@ QRect TilingEngine::applyInnerGap(const QRect& rect,
 
                                                                            QList<TileResult> TilingEngine::tile(const QList<Window*>& windows,
                                                                                                                 const QRect&          area,
-                                                                                                                TilingLayout          layout) const {
-                                                                                                                    TilingContext ctx = buildContext(windows, area);
+                                                                                                                TilingLayout          layout,
+                                                                                                                BSPTree*              bsp,
+                                                                                                                Window*               focused) const {
                                                                                                                     QList<TileResult> results;
+                                                                                                                    tileInto(windows, area, layout, results, bsp, focused);
+                                                                                                                    return results;
+                                                                                                                }
+
+                                                                                                                void TilingEngine::runLayout(const Snapshot& snap, QList<TileResult>& out, BSPTree* bsp) const {
+                                                                                                                    out.clear();
+
+                                                                                                                    TilingContext& ctx = buildContext(snap, m_scratch.ctx);
+                                                                                                                    ctx.bsp     = bsp;
+                                                                                                                    ctx.focused = snap.focused;
+                                                                                                                    const QRect& area = ctx.area;
                                                                                                                     int z = 0;
 
                                                                                                                     // Fullscreen windows span the full output
                                                                                                                     for (auto* w : ctx.fullscreen)
-                                                                                                                        results.append({w, area, 1000 + z++});
+                                                                                                                        out.append({w, area, 1000 + z++});
 
                                                                                                                     // Floating windows keep their geometry
                                                                                                                     z = 100;
-                                                                                                                    for (auto* w : ctx.floating)
-                                                                                                                        results.append({w, w->geometry(), z++});
+                                                                                                                    for (int i = 0; i < ctx.floating.size(); ++i)
+                                                                                                                        out.append({ctx.floating[i], ctx.floatGeom[i], z++});
 
-                                                                                                                    if (ctx.tiled.isEmpty()) return results;
+                                                                                                                    if (ctx.tiled.isEmpty()) return;
 
                                                                                                                     // Smart gaps: single tiled window fills work area without gaps
-                                                                                                                    const bool isSingle = (ctx.tiled.size() == 1) && m_gaps.smartGaps;
+                                                                                                                    const bool isSingle = (ctx.tiled.size() == 1) && ctx.gaps.smartGaps;
 
-                                                                                                                    QList<TileResult> tiledResults;
                                                                                                                     if (isSingle) {
-                                                                                                                        tiledResults = layoutMonocle(ctx);
-                                                                                                                    } else {
-                                                                                                                        switch (layout) {
-                                                                                                                            case TilingLayout::Spiral:      tiledResults = layoutSpiral(ctx);      break;
-                                                                                                                            case TilingLayout::Tall:        tiledResults = layoutTall(ctx);        break;
-                                                                                                                            case TilingLayout::Wide:        tiledResults = layoutWide(ctx);        break;
-                                                                                                                            case TilingLayout::Grid:        tiledResults = layoutGrid(ctx);        break;
-                                                                                                                            case TilingLayout::Dwindle:     tiledResults = layoutDwindle(ctx);     break;
-                                                                                                                            case TilingLayout::Monocle:     tiledResults = layoutMonocle(ctx);     break;
-                                                                                                                            case TilingLayout::Centered:    tiledResults = layoutCentered(ctx);    break;
-                                                                                                                            case TilingLayout::ThreeColumn: tiledResults = layoutThreeColumn(ctx); break;
-                                                                                                                            case TilingLayout::BSP:         tiledResults = layoutBSP(ctx);         break;
-                                                                                                                            default:                        tiledResults = layoutSpiral(ctx);      break;
+                                                                                                                        layoutMonocle(ctx, out);
+                                                                                                                        return;
+                                                                                                                    }
+
+                                                                                                                    switch (TilingLayout(snap.key.layout)) {
+                                                                                                                        case TilingLayout::Spiral:      layoutSpiral(ctx, out);      break;
+                                                                                                                        case TilingLayout::Tall:        layoutTall(ctx, out);        break;
+                                                                                                                        case TilingLayout::Wide:        layoutWide(ctx, out);        break;
+                                                                                                                        case TilingLayout::Grid:        layoutGrid(ctx, out);        break;
+                                                                                                                        case TilingLayout::Dwindle:     layoutDwindle(ctx, out);     break;
+                                                                                                                        case TilingLayout::Monocle:     layoutMonocle(ctx, out);     break;
+                                                                                                                        case TilingLayout::Centered:    layoutCentered(ctx, out);    break;
+                                                                                                                        case TilingLayout::ThreeColumn: layoutThreeColumn(ctx, out); break;
+                                                                                                                        case TilingLayout::BSP:         layoutBSP(ctx, out);         break;
+                                                                                                                        default:                        layoutSpiral(ctx, out);      break;
+                                                                                                                    }
+                                                                                                                }
+
+                                                                                                                void TilingEngine::tileInto(const QList<Window*>& windows,
+                                                                                                                                            const QRect&          area,
+                                                                                                                                            TilingLayout          layout,
+                                                                                                                                            QList<TileResult>&    out,
+                                                                                                                                            BSPTree*              bsp,
+                                                                                                                                            Window*               focused) const {
+                                                                                                                    snapshot(windows, area, layout, bsp, focused, m_scratch.snap);
+                                                                                                                    tileCached(m_scratch.snap, out, bsp);
+                                                                                                                }
+
+                                                                                                                void TilingEngine::tileCached(Snapshot& snap, QList<TileResult>& out, BSPTree* bsp) const {
+                                                                                                                    if (m_cache.valid && m_cache.key == snap.key) {
+                                                                                                                        ++m_cache.hits;
+                                                                                                                        out.clear();
+                                                                                                                        out.append(m_cache.results);
+                                                                                                                        return;
+                                                                                                                    }
+
+                                                                                                                    ++m_cache.misses;
+                                                                                                                    runLayout(snap, out, bsp);
+                                                                                                                    storeCache(snap.key, bsp, out);
+                                                                                                                }
+
+                                                                                                                void TilingEngine::tileChanges(const QList<Window*>& windows,
+                                                                                                                                               const QRect&          area,
+                                                                                                                                               TilingLayout          layout,
+                                                                                                                                               QList<TileResult>&    changed,
+                                                                                                                                               BSPTree*              bsp,
+                                                                                                                                               Window*               focused) const {
+                                                                                                                    snapshot(windows, area, layout, bsp, focused, m_scratch.snap);
+                                                                                                                    tileChanges(m_scratch.snap, changed, bsp);
+                                                                                                                }
+
+                                                                                                                void TilingEngine::tileChanges(Snapshot& snap, QList<TileResult>& changed, BSPTree* bsp) const {
+                                                                                                                    changed.clear();
+
+                                                                                                                    QList<TileResult>& current = m_scratch.tiles;
+                                                                                                                    tileCached(snap, current, bsp);
+                                                                                                                    const bool sameLayout = m_cache.appliedValid && m_cache.appliedSerial == m_cache.serial;
+
+                                                                                                                    // Where each window was when the snapshot was taken — never asked of
+                                                                                                                    // the Window itself, which may be changing on another thread.
+                                                                                                                    auto geometryOf = [&snap](int hint, const Window* w) {
+                                                                                                                        const int i = (hint < snap.windows.size() && snap.windows[hint] == w)
+                                                                                                                                    ? hint : int(snap.windows.indexOf(w));
+                                                                                                                        return i >= 0 ? snap.geometry[i] : QRect();
+                                                                                                                    };
+
+                                                                                                                    // Diff against what the previous tileChanges() call saw, not against the
+                                                                                                                    // memoized result — a tile()/tileInto() from elsewhere (a preview, say)
+                                                                                                                    // must not swallow a change the caller has yet to apply.  Results usually
+                                                                                                                    // come back in the same order, so try the same index before scanning.
+                                                                                                                    // A target that did not change is still reported if the window is not
+                                                                                                                    // there (a client resize, a missed configure), so drift gets corrected.
+                                                                                                                    const QList<TileResult>& prev = m_cache.applied;
+                                                                                                                    for (int i = 0; i < current.size(); ++i) {
+                                                                                                                        const TileResult& t = current[i];
+                                                                                                                        if (geometryOf(i, t.window) != t.targetGeometry) {
+                                                                                                                            changed.append(t);
+                                                                                                                            continue;
                                                                                                                         }
+                                                                                                                        if (sameLayout) continue;
+
+                                                                                                                        const TileResult* old = nullptr;
+                                                                                                                        if (i < prev.size() && prev[i].window == t.window) {
+                                                                                                                            old = &prev[i];
+                                                                                                                        } else {
+                                                                                                                            for (const TileResult& p : prev) {
+                                                                                                                                if (p.window == t.window) { old = &p; break; }
+                                                                                                                            }
+                                                                                                                        }
+                                                                                                                        if (!old || old->targetGeometry != t.targetGeometry)
+                                                                                                                            changed.append(t);
                                                                                                                     }
 
-                                                                                                                    results.append(tiledResults);
-                                                                                                                    return results;
+                                                                                                                    if (sameLayout) return;
+                                                                                                                    m_cache.appliedSerial = m_cache.serial;
+                                                                                                                    m_cache.appliedValid  = true;
+                                                                                                                    m_cache.applied.swap(current);
+                                                                                                                }
+
+                                                                                                                void TilingEngine::storeCache(LayoutKey& key, const BSPTree* bsp,
+                                                                                                                                              const QList<TileResult>& results) const {
+                                                                                                                    // The key just built moves into the cache; the old one goes back to
+                                                                                                                    // the caller's snapshot, so neither list reallocates.
+                                                                                                                    m_cache.key.swap(key);
+                                                                                                                    // A BSP layout can insert leaves while syncing, which bumps the tree's
+                                                                                                                    // generation — re-key so the next identical call is a hit.
+                                                                                                                    if (bsp) m_cache.key.bspGeneration = bsp->generation();
+                                                                                                                    m_cache.valid = true;
+                                                                                                                    ++m_cache.serial;
+                                                                                                                    m_cache.results.clear();
+                                                                                                                    m_cache.results.append(results);
+                                                                                                                }
+
+                                                                                                                void TilingEngine::snapshot(const QList<Window*>& windows, const QRect& area,
+                                                                                                                                            TilingLayout layout, const BSPTree* bsp,
+                                                                                                                                            Window* focused, Snapshot& snap) const {
+                                                                                                                    LayoutKey& key = snap.key;
+
+                                                                                                                    key.layout        = int(layout);
+                                                                                                                    key.area          = area;
+                                                                                                                    key.gaps          = m_gaps;
+                                                                                                                    key.masterRatio   = m_masterRatio;
+                                                                                                                    key.maxColumns    = m_maxColumns;
+                                                                                                                    key.bspGeneration = bsp ? bsp->generation() : 0;
+                                                                                                                    snap.focused      = focused;
+
+                                                                                                                    // Everything buildContext() and the layouts read from a window.  Ids
+                                                                                                                    // rather than pointers in the key, so a freed-and-reused address can't
+                                                                                                                    // hit; the pointers ride alongside as the results' identities.
+                                                                                                                    key.windows.clear();
+                                                                                                                    snap.windows.clear();
+                                                                                                                    snap.geometry.clear();
+                                                                                                                    for (Window* w : windows) {
+                                                                                                                        key.windows.append({w->id(), int(w->state()),
+                                                                                                                                            w->minSize(), w->maxSize(),
+                                                                                                                                            w->isFloating() ? w->geometry() : QRect()});
+                                                                                                                        snap.windows.append(w);
+                                                                                                                        snap.geometry.append(w->geometry());
+                                                                                                                    }
                                                                                                                 }
 
                                                                                                                 // ─────────────────────────────────────────────────────────────────────────────
@@ -134,10 +288,9 @@ QRect TilingEngine::applyInnerGap(const QRect& rect,
                                                                                                                 //   • Min-size clamp: windows below their minSize are collapsed into the
                                                                                                                 //     last slot rather than rendered off-screen.
                                                                                                                 //
-                                                                                                                QList<TileResult> TilingEngine::layoutSpiral(const TilingContext& ctx) const {
-                                                                                                                    QList<TileResult> results;
+                                                                                                                void TilingEngine::layoutSpiral(const TilingContext& ctx, QList<TileResult>& results) const {
                                                                                                                     const auto& windows = ctx.tiled;
-                                                                                                                    if (windows.isEmpty()) return results;
+                                                                                                                    if (windows.isEmpty()) return;
 
                                                                                                                     // Golden ratio — each child takes φ of remaining space
                                                                                                                     static constexpr float kPhi = 0.6180339887f;
@@ -146,9 +299,10 @@ QRect TilingEngine::applyInnerGap(const QRect& rect,
 
                                                                                                                     // Pre-collect windows that are too small to tile; merge them into last slot
                                                                                                                     // (honours minSize constraints set by Wayland clients)
-                                                                                                                    QList<int> validIdx;
+                                                                                                                    QList<int>& validIdx = m_scratch.indices;
+                                                                                                                    validIdx.clear();
                                                                                                                     for (int i = 0; i < windows.size(); ++i) {
-                                                                                                                        const QSize ms = windows[i]->minSize();
+                                                                                                                        const QSize ms = ctx.minSize[i];
                                                                                                                         if (i == 0 || remaining.width() > ms.width() + 60)
                                                                                                                             validIdx.append(i);
                                                                                                                     }
@@ -212,26 +366,24 @@ QRect TilingEngine::applyInnerGap(const QRect& rect,
                                                                                                                         }
 
                                                                                                                         winRect = applyHalfGap(winRect);
-                                                                                                                        winRect = applyConstraints(winRect, windows[i]);
+                                                                                                                        winRect = applyConstraints(winRect, ctx.minSize[i], ctx.maxSize[i]);
                                                                                                                         results.append({windows[i], winRect, vi});
                                                                                                                     }
-                                                                                                                    return results;
                                                                                                                 }
 
                                                                                                                 // ─────────────────────────────────────────────────────────────────────────────
                                                                                                                 // Layout: Tall (master-left)
                                                                                                                 // ─────────────────────────────────────────────────────────────────────────────
 
-                                                                                                                QList<TileResult> TilingEngine::layoutTall(const TilingContext& ctx) const {
-                                                                                                                    QList<TileResult> results;
+                                                                                                                void TilingEngine::layoutTall(const TilingContext& ctx, QList<TileResult>& results) const {
                                                                                                                     const auto& windows = ctx.tiled;
-                                                                                                                    if (windows.isEmpty()) return results;
+                                                                                                                    if (windows.isEmpty()) return;
 
                                                                                                                     const QRect a = applyOuterGap(ctx.area);
 
                                                                                                                     if (windows.size() == 1) {
                                                                                                                         results.append({windows[0], applyHalfGap(a), 0});
-                                                                                                                        return results;
+                                                                                                                        return;
                                                                                                                     }
 
                                                                                                                     const int masterW = (int)(a.width() * ctx.masterRatio);
@@ -248,23 +400,21 @@ QRect TilingEngine::applyInnerGap(const QRect& rect,
                                                                                                                             applyHalfGap(QRect(stackX, y, stackW, h)),
                                                                                                                                        i + 1});
                                                                                                                     }
-                                                                                                                    return results;
                                                                                                                 }
 
                                                                                                                 // ─────────────────────────────────────────────────────────────────────────────
                                                                                                                 // Layout: Wide (master-top)
                                                                                                                 // ─────────────────────────────────────────────────────────────────────────────
 
-                                                                                                                QList<TileResult> TilingEngine::layoutWide(const TilingContext& ctx) const {
-                                                                                                                    QList<TileResult> results;
+                                                                                                                void TilingEngine::layoutWide(const TilingContext& ctx, QList<TileResult>& results) const {
                                                                                                                     const auto& windows = ctx.tiled;
-                                                                                                                    if (windows.isEmpty()) return results;
+                                                                                                                    if (windows.isEmpty()) return;
 
                                                                                                                     const QRect a = applyOuterGap(ctx.area);
 
                                                                                                                     if (windows.size() == 1) {
                                                                                                                         results.append({windows[0], applyHalfGap(a), 0});
-                                                                                                                        return results;
+                                                                                                                        return;
                                                                                                                     }
 
                                                                                                                     const int masterH = (int)(a.height() * ctx.masterRatio);
@@ -281,17 +431,15 @@ QRect TilingEngine::applyInnerGap(const QRect& rect,
                                                                                                                             applyHalfGap(QRect(x, stackY, w, stackH)),
                                                                                                                                        i + 1});
                                                                                                                     }
-                                                                                                                    return results;
                                                                                                                 }
 
                                                                                                                 // ─────────────────────────────────────────────────────────────────────────────
                                                                                                                 // Layout: Grid
                                                                                                                 // ─────────────────────────────────────────────────────────────────────────────
 
-                                                                                                                QList<TileResult> TilingEngine::layoutGrid(const TilingContext& ctx) const {
-                                                                                                                    QList<TileResult> results;
+                                                                                                                void TilingEngine::layoutGrid(const TilingContext& ctx, QList<TileResult>& results) const {
                                                                                                                     const auto& windows = ctx.tiled;
-                                                                                                                    if (windows.isEmpty()) return results;
+                                                                                                                    if (windows.isEmpty()) return;
 
                                                                                                                     const QRect a    = applyOuterGap(ctx.area);
                                                                                                                     const int   n    = windows.size();
@@ -312,17 +460,15 @@ QRect TilingEngine::applyInnerGap(const QRect& rect,
                                                                                                                                                cellW, cellH)),
                                                                                                                                                i});
                                                                                                                     }
-                                                                                                                    return results;
                                                                                                                 }
 
                                                                                                                 // ─────────────────────────────────────────────────────────────────────────────
                                                                                                                 // Layout: Dwindle
                                                                                                                 // ─────────────────────────────────────────────────────────────────────────────
 
-                                                                                                                QList<TileResult> TilingEngine::layoutDwindle(const TilingContext& ctx) const {
-                                                                                                                    QList<TileResult> results;
+                                                                                                                void TilingEngine::layoutDwindle(const TilingContext& ctx, QList<TileResult>& results) const {
                                                                                                                     const auto& windows = ctx.tiled;
-                                                                                                                    if (windows.isEmpty()) return results;
+                                                                                                                    if (windows.isEmpty()) return;
 
                                                                                                                     QRect remaining = applyOuterGap(ctx.area);
 
@@ -344,28 +490,25 @@ QRect TilingEngine::applyInnerGap(const QRect& rect,
 
                                                                                                                         results.append({windows[i], applyHalfGap(winRect), i});
                                                                                                                     }
-                                                                                                                    return results;
                                                                                                                 }
 
                                                                                                                 // ─────────────────────────────────────────────────────────────────────────────
                                                                                                                 // Layout: Monocle
                                                                                                                 // ─────────────────────────────────────────────────────────────────────────────
 
-                                                                                                                QList<TileResult> TilingEngine::layoutMonocle(const TilingContext& ctx) const {
-                                                                                                                    QList<TileResult> results;
+                                                                                                                void TilingEngine::layoutMonocle(const TilingContext& ctx, QList<TileResult>& results) const {
                                                                                                                     const QRect a = applyOuterGap(ctx.area);
                                                                                                                     const QRect r = applyHalfGap(a);
                                                                                                                     for (int i = 0; i < ctx.tiled.size(); ++i)
                                                                                                                         results.append({ctx.tiled[i], r, i});
-                                                                                                                    return results;
                                                                                                                 }
 
                                                                                                                 // ─────────────────────────────────────────────────────────────────────────────
                                                                                                                 // Layout: Centered
                                                                                                                 // ─────────────────────────────────────────────────────────────────────────────
 
-                                                                                                                QList<TileResult> TilingEngine::layoutCentered(const TilingContext& ctx) const {
-                                                                                                                    if (ctx.tiled.isEmpty()) return {};
+                                                                                                                void TilingEngine::layoutCentered(const TilingContext& ctx, QList<TileResult>& results) const {
+                                                                                                                    if (ctx.tiled.isEmpty()) return;
 
                                                                                                                     if (ctx.tiled.size() == 1) {
                                                                                                                         const QRect& area = ctx.area;
@@ -373,24 +516,24 @@ QRect TilingEngine::applyInnerGap(const QRect& rect,
                                                                                                                         const int h = (int)(area.height() * 0.78f);
                                                                                                                         const int x = area.x() + (area.width()  - w) / 2;
                                                                                                                         const int y = area.y() + (area.height() - h) / 2;
-                                                                                                                        return {{ctx.tiled[0], QRect(x, y, w, h), 0}};
+                                                                                                                        results.append({ctx.tiled[0], QRect(x, y, w, h), 0});
+                                                                                                                        return;
                                                                                                                     }
 
-                                                                                                                    return layoutSpiral(ctx);
+                                                                                                                    layoutSpiral(ctx, results);
                                                                                                                 }
 
                                                                                                                 // ─────────────────────────────────────────────────────────────────────────────
                                                                                                                 // Layout: ThreeColumn
                                                                                                                 // ─────────────────────────────────────────────────────────────────────────────
 
-                                                                                                                QList<TileResult> TilingEngine::layoutThreeColumn(const TilingContext& ctx) const {
-                                                                                                                    QList<TileResult> results;
+                                                                                                                void TilingEngine::layoutThreeColumn(const TilingContext& ctx, QList<TileResult>& results) const {
                                                                                                                     const auto& windows = ctx.tiled;
-                                                                                                                    if (windows.isEmpty()) return results;
+                                                                                                                    if (windows.isEmpty()) return;
 
                                                                                                                     const QRect a = applyOuterGap(ctx.area);
 
-                                                                                                                    if (windows.size() <= 2) return layoutTall(ctx);
+                                                                                                                    if (windows.size() <= 2) { layoutTall(ctx, results); return; }
 
                                                                                                                     const int colW = a.width() / 3;
 
@@ -398,7 +541,10 @@ QRect TilingEngine::applyInnerGap(const QRect& rect,
                                                                                                                     // Centre column — master
                                                                                                                     // Right column — remaining slaves
                                                                                                                     const int masterIdx = 0;
-                                                                                                                    QList<Window*> left, right;
+                                                                                                                    QList<Window*>& left  = m_scratch.left;
+                                                                                                                    QList<Window*>& right = m_scratch.right;
+                                                                                                                    left.clear();
+                                                                                                                    right.clear();
                                                                                                                     for (int i = 1; i < windows.size(); ++i) {
                                                                                                                         if (i % 2 == 1) left.append(windows[i]);
                                                                                                                         else             right.append(windows[i]);
@@ -417,77 +563,75 @@ QRect TilingEngine::applyInnerGap(const QRect& rect,
                                                                                                                     results.append({windows[masterIdx], applyHalfGap(QRect(a.x() + colW, a.y(), colW, a.height())), 0});
                                                                                                                     fillColumn(right, colW * 2, 20);
 
-                                                                                                                    return results;
                                                                                                                 }
 
                                                                                                                 // ─────────────────────────────────────────────────────────────────────────────
                                                                                                                 // Layout: BSP
                                                                                                                 // ─────────────────────────────────────────────────────────────────────────────
 
-                                                                                                                BSPNode* TilingEngine::buildBSPTree(int count, const QRect& rect,
-                                                                                                                                                    BSPNode::Split preferredSplit) const {
-                                                                                                                                                        auto* node = new BSPNode();
-                                                                                                                                                        node->rect = rect;
-
-                                                                                                                                                        if (count <= 1) {
-                                                                                                                                                            node->isLeaf      = true;
-                                                                                                                                                            node->windowIndex = 0;
-                                                                                                                                                            return node;
-                                                                                                                                                        }
-
-                                                                                                                                                        node->isLeaf = false;
-                                                                                                                                                        node->split  = preferredSplit;
-                                                                                                                                                        node->ratio  = 0.5f;
-
-                                                                                                                                                        const BSPNode::Split nextSplit =
-                                                                                                                                                        (preferredSplit == BSPNode::Split::Horizontal)
-                                                                                                                                                        ? BSPNode::Split::Vertical
-                                                                                                                                                        : BSPNode::Split::Horizontal;
-
-                                                                                                                                                        const int leftCount  = count / 2;
-                                                                                                                                                        const int rightCount = count - leftCount;
-
-                                                                                                                                                        QRect leftRect, rightRect;
-                                                                                                                                                        if (preferredSplit == BSPNode::Split::Horizontal) {
-                                                                                                                                                            const int w = (int)(rect.width() * node->ratio);
-                                                                                                                                                            leftRect  = QRect(rect.x(), rect.y(), w, rect.height());
-                                                                                                                                                            rightRect = QRect(rect.x() + w, rect.y(), rect.width() - w, rect.height());
-                                                                                                                                                        } else {
-                                                                                                                                                            const int h = (int)(rect.height() * node->ratio);
-                                                                                                                                                            leftRect  = QRect(rect.x(), rect.y(), rect.width(), h);
-                                                                                                                                                            rightRect = QRect(rect.x(), rect.y() + h, rect.width(), rect.height() - h);
-                                                                                                                                                        }
-
-                                                                                                                                                        node->left  = buildBSPTree(leftCount,  leftRect,  nextSplit);
-                                                                                                                                                        node->right = buildBSPTree(rightCount, rightRect, nextSplit);
-                                                                                                                                                        return node;
-                                                                                                                                                    }
-
-                                                                                                                                                    void TilingEngine::collectBSPResults(const BSPNode*       node,
-                                                                                                                                                                                         const TilingContext& ctx,
-                                                                                                                                                                                         QList<TileResult>&   out,
-                                                                                                                                                                                         int&                 index) const {
-                                                                                                                                                                                             if (!node) return;
-                                                                                                                                                                                             if (node->isLeaf) {
-                                                                                                                                                                                                 if (index < ctx.tiled.size())
-                                                                                                                                                                                                     out.append({ctx.tiled[index++], applyHalfGap(node->rect), index});
-                                                                                                                                                                                                 return;
-                                                                                                                                                                                             }
-                                                                                                                                                                                             collectBSPResults(node->left,  ctx, out, index);
-                                                                                                                                                                                             collectBSPResults(node->right, ctx, out, index);
-                                                                                                                                                                                         }
+                                                                                                                void TilingEngine::layoutBSPRange(const TilingContext& ctx, int first, int count,
+                                                                                                                                                  const QRect& rect, BSPNode::Split split,
+                                                                                                                                                  QList<TileResult>& out) const {
+                                                                                                                    // Balanced split without materialising nodes: the left half gets
+                                                                                                                    // count / 2 windows, the right half the rest, alternating direction.
+                                                                                                                    if (count <= 1) {
+                                                                                                                        out.append({ctx.tiled[first], applyHalfGap(rect), first + 1});
+                                                                                                                        return;
+                                                                                                                    }
 
-                                                                                                                                                                                         QList<TileResult> TilingEngine::layoutBSP(const TilingContext& ctx) const {
-                                                                                                                                                                                             QList<TileResult> results;
-                                                                                                                                                                                             if (ctx.tiled.isEmpty()) return results;
+                                                                                                                    const BSPNode::Split next = (split == BSPNode::Split::Horizontal)
+                                                                                                                        ? BSPNode::Split::Vertical
+                                                                                                                        : BSPNode::Split::Horizontal;
 
-                                                                                                                                                                                             const QRect area = applyOuterGap(ctx.area);
-                                                                                                                                                                                             BSPNode* root = buildBSPTree(ctx.tiled.size(), area, BSPNode::Split::Horizontal);
-                                                                                                                                                                                             int index = 0;
-                                                                                                                                                                                             collectBSPResults(root, ctx, results, index);
-                                                                                                                                                                                             delete root;
-                                                                                                                                                                                             return results;
-                                                                                                                                                                                         }
+                                                                                                                    const int leftCount = count / 2;
+
+                                                                                                                    QRect leftRect, rightRect;
+                                                                                                                    if (split == BSPNode::Split::Horizontal) {
+                                                                                                                        const int w = rect.width() / 2;
+                                                                                                                        leftRect  = QRect(rect.x(), rect.y(), w, rect.height());
+                                                                                                                        rightRect = QRect(rect.x() + w, rect.y(), rect.width() - w, rect.height());
+                                                                                                                    } else {
+                                                                                                                        const int h = rect.height() / 2;
+                                                                                                                        leftRect  = QRect(rect.x(), rect.y(), rect.width(), h);
+                                                                                                                        rightRect = QRect(rect.x(), rect.y() + h, rect.width(), rect.height() - h);
+                                                                                                                    }
+
+                                                                                                                    layoutBSPRange(ctx, first,             leftCount,         leftRect,  next, out);
+                                                                                                                    layoutBSPRange(ctx, first + leftCount, count - leftCount, rightRect, next, out);
+                                                                                                                }
+
+                                                                                                                void TilingEngine::layoutBSP(const TilingContext& ctx, QList<TileResult>& results) const {
+                                                                                                                    if (ctx.tiled.isEmpty()) return;
+
+                                                                                                                    const QRect area = applyOuterGap(ctx.area);
+
+                                                                                                                    // Persistent tree: sync membership (insert at the focused leaf, promote
+                                                                                                                    // siblings of removed leaves) and re-lay out only dirty subtrees.
+                                                                                                                    // Untouched leaves keep their exact rect, so callers skip them.
+                                                                                                                    if (ctx.bsp) {
+                                                                                                                        // Minimized windows stay members, parked: their leaf gives its
+                                                                                                                        // rect to the sibling and is still there when they are restored
+                                                                                                                        QList<Window*>& members = m_scratch.members;
+                                                                                                                        members.clear();
+                                                                                                                        members.append(ctx.tiled);
+                                                                                                                        members.append(ctx.parked);
+                                                                                                                        ctx.bsp->sync(members, ctx.focused);
+                                                                                                                        for (auto* w : ctx.tiled)  ctx.bsp->setParked(w, false);
+                                                                                                                        for (auto* w : ctx.parked) ctx.bsp->setParked(w, true);
+                                                                                                                        ctx.bsp->layout(area);
+
+                                                                                                                        QList<const BSPNode*>& leaves = m_scratch.leaves;
+                                                                                                                        ctx.bsp->leaves(leaves);
+                                                                                                                        int z = 0;
+                                                                                                                        for (const BSPNode* leaf : leaves) {
+                                                                                                                            if (!leaf->parked)
+                                                                                                                                results.append({leaf->window, applyHalfGap(leaf->rect), z++});
+                                                                                                                        }
+                                                                                                                        return;
+                                                                                                                    }
+
+                                                                                                                    layoutBSPRange(ctx, 0, ctx.tiled.size(), area, BSPNode::Split::Horizontal, results);
+                                                                                                                }
 
                                                                                                                                                                                          // ─────────────────────────────────────────────────────────────────────────────
                                                                                                                                                                                          // String helpers
@@ -7,8 +7,10 @@
 #include <QString>
 #include <QHash>
 #include <functional>
+#include <utility>
 
 class Window;
+class BSPTree;
 
 // ─────────────────────────────────────────────────────────────────────────────
 // TilingLayout
@@ -33,8 +35,8 @@ enum class TilingLayout {
     Centered,   ///< Single window: centred at ~72 % of the work area.
     ///<   Multiple windows: falls back to Spiral.
     ThreeColumn,///< Three equal-width columns; master goes in the centre.
-    BSP         ///< Binary-space partition; each split direction is stored in
-    ///<   the per-window tile slot for stable re-layout.
+    BSP         ///< Binary-space partition; the tree persists per workspace
+    ///<   (see BSPTree) so splits and ratios survive re-layout.
 };
 
 // ─────────────────────────────────────────────────────────────────────────────
@@ -64,6 +66,8 @@ struct GapPolicy {
     ///<   window is tiled (fills the full work area).
     bool smartBorders= true; ///< When true: suppress window borders if only one
     ///<   window is tiled.
+
+    bool operator==(const GapPolicy&) const = default;
 };
 
 // ─────────────────────────────────────────────────────────────────────────────
@@ -74,21 +78,32 @@ struct GapPolicy {
 // ─────────────────────────────────────────────────────────────────────────────
 struct TilingContext {
     QList<Window*> tiled;    ///< Windows to be placed by the engine (already
-    ///<   filtered: tiled, visible, non-fullscreen).
+    ///<   filtered: tiled, not minimized, non-fullscreen).
+    ///<   Visibility is ignored, so a hidden workspace
+    ///<   lays out the same as when it is shown.
+    QList<QSize>   minSize;  ///< Parallel to tiled: the client's size
+    QList<QSize>   maxSize;  ///<   constraints, as snapshotted.
     QList<Window*> floating; ///< Floating windows — returned unchanged.
+    QList<QRect>   floatGeom;///< Parallel to floating: their geometry.
     QList<Window*> fullscreen;///< Fullscreen windows — span the full output.
+    QList<Window*> parked;   ///< Minimized tiled windows — not placed, but a
+    ///<   persistent BSP tree keeps their slot.
     QRect          area;     ///< Work area in compositor coordinates.
     GapPolicy      gaps;
     float          masterRatio = 0.55f;
     int            maxColumns  = 3;    ///< Used by Grid / ThreeColumn.
     bool           monocleActive = false; ///< For Monocle: paint active on top.
+    BSPTree*       bsp     = nullptr; ///< Persistent tree for BSP, or nullptr
+    ///<   to build a throw-away balanced tree.
+    Window*        focused = nullptr; ///< Leaf new BSP windows split from.
 };
 
 // ─────────────────────────────────────────────────────────────────────────────
-// BSPNode  (used internally by the BSP layout)
+// BSPNode  (used by the BSP layout)
 //
 // Each node represents either a split point or a leaf (one window slot).
-// The tree is rebuilt every time the window list changes.
+// Only persistent trees (BSPTree) create nodes; the stateless BSP layout
+// computes the same balanced split without materialising a tree.
 // ─────────────────────────────────────────────────────────────────────────────
 struct BSPNode {
     enum class Split { Horizontal, Vertical };
@@ -97,10 +112,14 @@ struct BSPNode {
     Split  split    = Split::Horizontal;
     float  ratio    = 0.5f;            ///< Where in [0.1, 0.9] the split falls.
     QRect  rect;                       ///< Assigned by the layout pass.
-    int    windowIndex = -1;           ///< Index into TilingContext::tiled.
+    Window* window = nullptr;          ///< Leaf occupant (persistent trees).
+    bool   dirty    = false;           ///< Subtree rects need recomputing.
+    bool   parked   = false;           ///< Leaf whose window is minimized.
+    int    live     = 0;               ///< Unparked leaves in this subtree.
 
-    BSPNode* left  = nullptr;          ///< Child towards the origin.
-    BSPNode* right = nullptr;          ///< Child away from the origin.
+    BSPNode* parent = nullptr;         ///< nullptr for the root.
+    BSPNode* left   = nullptr;         ///< Child towards the origin.
+    BSPNode* right  = nullptr;         ///< Child away from the origin.
 
     ~BSPNode() { delete left; delete right; }
 };
@@ -112,6 +131,12 @@ struct BSPNode {
 // area rectangle it returns the desired geometry for each window.  It holds no
 // mutable per-window state between calls: all per-window parameters it needs
 // (min/max size, tile slot) are read from the Window objects themselves.
+// The only state it keeps is scratch memory reused across calls, so
+// tileInto() does not allocate once its buffers have grown, and the last
+// result together with everything that produced it (window ids, states
+// and constraints, area, layout, gaps, ratio, BSP tree generation).  A
+// repeated call with the same inputs returns the cached geometry without
+// running the layout.
 //
 // Usage
 // ─────
@@ -125,9 +150,13 @@ struct BSPNode {
 //
 // Thread safety
 // ─────────────
-//   tile() and all layout methods are const and do not modify shared state.
-//   They may safely be called from a worker thread as long as the Window
-//   objects are not mutated concurrently.
+//   tile() and all layout methods are const but share the engine's scratch
+//   buffers, so one engine must not run two layouts at once.  Each Workspace
+//   owns its own engine; different engines may run on different threads as
+//   long as the Window objects are not mutated concurrently.
+//   snapshot() + tileChanges(Snapshot&) lift that last condition: the
+//   snapshot is taken where the windows live, and the pass itself reads no
+//   Window, so it can run while the GUI thread goes on mutating them.
 // ─────────────────────────────────────────────────────────────────────────────
 class TilingEngine : public QObject {
     Q_OBJECT
@@ -149,41 +178,124 @@ public:
     ///      windows (geometry = \p area) with appropriate z-orders.
     ///
     /// Returns results sorted so that lower z-orders come first.
+    ///
+    /// For TilingLayout::BSP, pass the workspace's persistent \p bsp tree
+    /// and the \p focused window: the tree is synced to the tiled set and
+    /// only its dirty subtrees are re-laid out.  This is the one case where
+    /// tile() mutates caller-owned state.
     QList<TileResult> tile(const QList<Window*>& windows,
                            const QRect&          area,
-                           TilingLayout          layout) const;
+                           TilingLayout          layout,
+                           BSPTree*              bsp     = nullptr,
+                           Window*               focused = nullptr) const;
+
+                           /// Same as tile() but writes into \p out, which is cleared first and
+                           /// keeps its capacity.  Together with the engine's scratch buffers a
+                           /// steady-state call (same window count) does no heap allocation.
+                           void tileInto(const QList<Window*>& windows,
+                                         const QRect&          area,
+                                         TilingLayout          layout,
+                                         QList<TileResult>&    out,
+                                         BSPTree*              bsp     = nullptr,
+                                         Window*               focused = nullptr) const;
+
+                           /// Like tileInto(), but \p changed receives only the results whose
+                           /// target differs from the previous call (windows new to the layout
+                           /// included) or from the window's current geometry().  Lets the caller
+                           /// animate just the windows that actually move.
+                           void tileChanges(const QList<Window*>& windows,
+                                            const QRect&          area,
+                                            TilingLayout          layout,
+                                            QList<TileResult>&    changed,
+                                            BSPTree*              bsp     = nullptr,
+                                            Window*               focused = nullptr) const;
+
+                           // ── Off-thread layout ─────────────────────────────────────────────────
+
+                           /// Every input the layout reads, compared field by field — a cache hit
+                           /// needs the inputs to match, not just a hash of them.
+                           struct LayoutKey {
+                               struct Entry {
+                                   quint64 id        = 0;
+                                   int     state     = 0;      ///< WindowState
+                                   QSize   minSize;
+                                   QSize   maxSize;
+                                   QRect   floatGeom;          ///< Floating windows only.
+                                   bool operator==(const Entry&) const = default;
+                               };
+                               int          layout        = -1;
+                               QRect        area;
+                               GapPolicy    gaps;
+                               float        masterRatio   = 0.0f;
+                               int          maxColumns    = 0;
+                               quint64      bspGeneration = 0;
+                               QList<Entry> windows;
+
+                               bool operator==(const LayoutKey&) const = default;
+                               void swap(LayoutKey& o) { std::swap(*this, o); }
+                           };
+
+                           /// One layout call with everything it reads from the Window objects
+                           /// copied out.  Window pointers are kept as identities only.
+                           struct Snapshot {
+                               LayoutKey      key;
+                               QList<Window*> windows;     ///< Parallel to key.windows.
+                               QList<QRect>   geometry;    ///< Current geometry, parallel to windows.
+                               Window*        focused = nullptr;
+                           };
+
+                           /// Fill \p snap (capacity kept) for a tileChanges() call with these
+                           /// arguments.  Run it on the thread that owns the windows.
+                           void snapshot(const QList<Window*>& windows,
+                                         const QRect&          area,
+                                         TilingLayout          layout,
+                                         const BSPTree*        bsp,
+                                         Window*               focused,
+                                         Snapshot&             snap) const;
+
+                           /// tileChanges() over a snapshot; dereferences no Window, so it may run
+                           /// on a worker thread.  \p snap's key moves into the layout cache, which
+                           /// leaves the snapshot spent.
+                           void tileChanges(Snapshot&          snap,
+                                            QList<TileResult>& changed,
+                                            BSPTree*           bsp = nullptr) const;
+
+                           /// Layout-cache counters, for diagnostics.
+                           quint64 cacheHits()   const { return m_cache.hits;   }
+                           quint64 cacheMisses() const { return m_cache.misses; }
 
                            // ── Named layout methods ──────────────────────────────────────────────
                            // Each method receives only the tiled-window subset and the gap-shrunk
-                           // work area; it must NOT handle floating / fullscreen windows.
+                           // work area and appends to \p out; it must NOT handle floating /
+                           // fullscreen windows.
 
                            /// Fibonacci spiral: each window takes a half of the remaining rect,
                            /// cycling through directions Right → Down → Left → Up.
-                           QList<TileResult> layoutSpiral(const TilingContext& ctx) const;
+                           void layoutSpiral(const TilingContext& ctx, QList<TileResult>& out) const;
 
                            /// Master-left + right stack.
-                           QList<TileResult> layoutTall(const TilingContext& ctx) const;
+                           void layoutTall(const TilingContext& ctx, QList<TileResult>& out) const;
 
                            /// Master-top + bottom row.
-                           QList<TileResult> layoutWide(const TilingContext& ctx) const;
+                           void layoutWide(const TilingContext& ctx, QList<TileResult>& out) const;
 
                            /// Near-square grid; last row centred if window count is not a perfect square.
-                           QList<TileResult> layoutGrid(const TilingContext& ctx) const;
+                           void layoutGrid(const TilingContext& ctx, QList<TileResult>& out) const;
 
                            /// Alternating-axis halving cascade into a corner.
-                           QList<TileResult> layoutDwindle(const TilingContext& ctx) const;
+                           void layoutDwindle(const TilingContext& ctx, QList<TileResult>& out) const;
 
                            /// All windows stacked on top of each other (monocle / tabbed).
-                           QList<TileResult> layoutMonocle(const TilingContext& ctx) const;
+                           void layoutMonocle(const TilingContext& ctx, QList<TileResult>& out) const;
 
                            /// Single window centred at ~72 % of the work area; multiple → Spiral.
-                           QList<TileResult> layoutCentered(const TilingContext& ctx) const;
+                           void layoutCentered(const TilingContext& ctx, QList<TileResult>& out) const;
 
                            /// Three equal columns with master in the middle.
-                           QList<TileResult> layoutThreeColumn(const TilingContext& ctx) const;
+                           void layoutThreeColumn(const TilingContext& ctx, QList<TileResult>& out) const;
 
-                           /// Binary-space partition using per-window tile-slot split direction.
-                           QList<TileResult> layoutBSP(const TilingContext& ctx) const;
+                           /// Binary-space partition — persistent tree if ctx.bsp is set.
+                           void layoutBSP(const TilingContext& ctx, QList<TileResult>& out) const;
 
                            // ── Configuration ─────────────────────────────────────────────────────
 
@@ -220,11 +332,10 @@ public:
 private:
     // ── Context builder ───────────────────────────────────────────────────
 
-    /// Partition \p windows into tiled / floating / fullscreen, apply
+    /// Partition \p snap's windows into tiled / floating / fullscreen, apply
     /// smart-gap suppression, and populate a TilingContext ready for a
     /// layout method.
-    TilingContext buildContext(const QList<Window*>& windows,
-                               const QRect&          area) const;
+    TilingContext& buildContext(const Snapshot& snap, TilingContext& ctx) const;
 
                                // ── Gap helpers ───────────────────────────────────────────────────────
 
@@ -243,26 +354,64 @@ private:
 
                                                    // ── Size-constraint helper ─────────────────────────────────────────────
 
-                                                   /// Clamp \p rect so the window's minSize / maxSize constraints are
-                                                   /// respected, keeping the rect centred around its original centre point.
-                                                   QRect applyConstraints(const QRect& rect, const Window* w) const;
+                                                   /// Clamp \p rect to a window's \p minSize / \p maxSize, keeping the
+                                                   /// rect centred around its original centre point.
+                                                   QRect applyConstraints(const QRect& rect, const QSize& minSize,
+                                                                          const QSize& maxSize) const;
 
                                                    // ── BSP helpers ───────────────────────────────────────────────────────
 
-                                                   /// Recursively build a balanced BSP tree for \p count leaf windows
-                                                   /// occupying \p rect.  Caller owns the returned root node.
-                                                   BSPNode* buildBSPTree(int count, const QRect& rect,
-                                                                         BSPNode::Split preferredSplit) const;
+                                                   /// Stateless balanced BSP over ctx.tiled[first, first + count): appends
+                                                   /// one TileResult per window directly, no tree nodes are allocated.
+                                                   void layoutBSPRange(const TilingContext& ctx, int first, int count,
+                                                                       const QRect& rect, BSPNode::Split split,
+                                                                       QList<TileResult>& out) const;
+
+                                                   // ── Memoization ───────────────────────────────────────────────────────
 
-                                                                         /// Walk the BSP tree and collect one TileResult per leaf, assigning
-                                                                         /// windows from \p ctx.tiled in slot order.
-                                                                         void collectBSPResults(const BSPNode*       node,
-                                                                                                const TilingContext& ctx,
-                                                                                                QList<TileResult>&   out,
-                                                                                                int&                 index) const;
+                                                   /// The actual layout pass; tileInto() and tileChanges() wrap it.
+                                                   void runLayout(const Snapshot& snap, QList<TileResult>& out, BSPTree* bsp) const;
+
+                                                   /// Cached layout for \p snap, or a fresh pass that becomes the cache.
+                                                   void tileCached(Snapshot& snap, QList<TileResult>& out, BSPTree* bsp) const;
+
+                                                   /// Adopt \p key and \p results as the cached layout.  \p key is
+                                                   /// swapped with the old one, so neither list reallocates.
+                                                   void storeCache(LayoutKey& key, const BSPTree* bsp,
+                                                                   const QList<TileResult>& results) const;
 
                                                                                                 // ── Members ───────────────────────────────────────────────────────────
                                                                                                 float      m_masterRatio = 0.55f;
                                                                                                 GapPolicy  m_gaps;
                                                                                                 int        m_maxColumns  = 3;
+
+                                                                                                // Reused between calls; only grows.  Makes tile() non-reentrant
+                                                                                                // for a single engine — see "Thread safety" above.
+                                                                                                struct Scratch {
+                                                                                                    TilingContext         ctx;
+                                                                                                    QList<int>            indices;
+                                                                                                    QList<Window*>        left;
+                                                                                                    QList<Window*>        right;
+                                                                                                    QList<const BSPNode*> leaves;
+                                                                                                    QList<Window*>        members;   ///< BSP: tiled + parked.
+                                                                                                    QList<TileResult>     tiles;     ///< tileChanges() full result.
+                                                                                                    Snapshot              snap;      ///< Inputs of the call in progress.
+                                                                                                };
+                                                                                                mutable Scratch m_scratch;
+
+                                                                                                // Last layout and the key it was computed for.
+                                                                                                struct LayoutCache {
+                                                                                                    LayoutKey         key;
+                                                                                                    bool              valid  = false;
+                                                                                                    quint64           serial = 0;   ///< Bumped on every stored layout.
+                                                                                                    QList<TileResult> results;
+                                                                                                    quint64           hits   = 0;
+                                                                                                    quint64           misses = 0;
+
+                                                                                                    // What the last tileChanges() call diffed against and returned.
+                                                                                                    quint64           appliedSerial = 0;
+                                                                                                    bool              appliedValid  = false;
+                                                                                                    QList<TileResult> applied;
+                                                                                                };
+                                                                                                mutable LayoutCache m_cache;
 };
@@ -66,6 +66,12 @@ Window::Window(WMSurface* surface, QObject* parent)
     // Windows start inactive; set opacity accordingly.
     m_opacity = Config::instance().theme.inactiveOpacity;
 
+    // Relay commits so listeners need not track the surface's lifetime
+    if (m_surface) {
+        connect(m_surface, &WMSurface::contentChanged,
+                this, [this](const QRegion&) { emit contentChanged(); });
+    }
+
     qDebug() << "[Window" << m_id << "] created";
 }
 
@@ -175,7 +181,7 @@ void Window::setGeometryAnimated(const QRect& rect, int durationMs) {
     m_animProgress = 0.0f;
 
     // Set geometry directly so the window model is consistent; the
-    // AnimationEngine overrides this with interpolated frames.
+    // AnimationEngine draws the interpolated frames via setVisualGeometry().
     if (m_geometry == target) return;
     m_geometry = target;
 
@@ -240,12 +246,17 @@ void Window::setVisible(bool visible) {
     // No early-return guard: callers may legitimately set the same value
     // when making a workspace visible after a switch; they rely on the
     // window actually updating its paint state.
+    const bool changed = m_visible != visible;
     m_visible = visible;
     qDebug() << "[Window" << m_id << "] visible:" << visible;
+    if (changed) emit visibilityChanged(visible);
 }
 
 void Window::setOpacity(float opacity) {
-    m_opacity = qBound(0.0f, opacity, 1.0f);
+    const float clamped = qBound(0.0f, opacity, 1.0f);
+    if (qFuzzyCompare(m_opacity, clamped)) return;
+    m_opacity = clamped;
+    emit opacityChanged(m_opacity);
 }
 
 // ─────────────────────────────────────────────────────────────────────────────
@@ -339,6 +350,16 @@ void Window::setAnimProgress(float p) {
     // No signal needed — AnimationEngine drives repaints itself.
 }
 
+void Window::setVisualGeometry(const QRect& rect) {
+    // Render-only: deliberately no geometryChanged(), so the hit-test grid,
+    // blur caches and the client's configured size stay put mid-animation.
+    m_visualGeometry = rect;
+}
+
+void Window::clearVisualGeometry() {
+    m_visualGeometry = QRect();
+}
+
 // ─────────────────────────────────────────────────────────────────────────────
 // Constraints helper
 // ─────────────────────────────────────────────────────────────────────────────
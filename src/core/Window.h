@@ -151,6 +151,18 @@ public:
     /// 1.0 = animation complete / not running.
     float animProgress()       const { return m_animProgress; }
 
+    /// Where the window is drawn this frame.  Equals geometry() except while
+    /// an animation moves or scales the last committed frame — the renderer
+    /// maps geometry() onto this rect instead of re-laying out the window.
+    QRect visualGeometry()     const {
+        return m_visualGeometry.isValid() ? m_visualGeometry : m_geometry;
+    }
+
+    /// True while visualGeometry() differs from geometry().
+    bool  hasVisualTransform() const {
+        return m_visualGeometry.isValid() && m_visualGeometry != m_geometry;
+    }
+
     /// Render opacity in [0, 1].  Set automatically from config on
     /// setActive(); can be overridden for custom fade effects.
     float opacity()            const { return m_opacity; }
@@ -201,6 +213,13 @@ public:
     /// Update animation progress; clamped to [0, 1].
     void setAnimProgress(float p);
 
+    /// Draw the window at \p rect without changing geometry().  No signal,
+    /// no configure — the client never sees it.  Used by AnimationEngine.
+    void setVisualGeometry(const QRect& rect);
+
+    /// Drop the visual override; the window is drawn at geometry() again.
+    void clearVisualGeometry();
+
     /// Assign tile slot index; -1 = not in tile order.
     void setTileSlot(int s) { m_tileSlot = s; }
 
@@ -249,8 +268,13 @@ signals:
     void stateChanged(WindowState state);
     void titleChanged(const QString& title);
     void visibilityChanged(bool visible);
+    void opacityChanged(float opacity);
     void workspaceChanged(int workspaceId);
 
+    /// Relayed from WMSurface::contentChanged: the client committed a new
+    /// buffer.
+    void contentChanged();
+
     // ── Request signals (consumed by WMCompositor / WMXdgShell) ──────────
     /// WMXdgShell reacts by sending xdg_toplevel.close to the client.
     void closeRequested();
@@ -313,6 +337,7 @@ private:
     // Rendering
     float       m_animProgress = 1.0f; ///< 0=start  1=complete
     float       m_opacity      = 1.0f;
+    QRect       m_visualGeometry;      ///< Invalid = draw at m_geometry
 
     // Animation target (set by setGeometryAnimated, read by AnimationEngine)
     QRect       m_animTarget;
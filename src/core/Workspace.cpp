@@ -35,6 +35,7 @@ Workspace::Workspace(int id, QObject* parent)
 }
 
 Workspace::~Workspace() {
+    settleLayout();
     // Windows are owned by WMCompositor, not by us.  Just clear the reference.
     // Any active-window signal would fire into dead objects if we emitted here,
     // so we suppress it during destruction.
@@ -48,6 +49,7 @@ Workspace::~Workspace() {
 // ─────────────────────────────────────────────────────────────────────────────
 
 void Workspace::onConfigReloaded() {
+    settleLayout();
     const auto& cfg = Config::instance();
     m_engine.setMasterRatio(cfg.tiling.masterRatio);
     m_engine.setGaps(cfg.theme.gapInner, cfg.theme.gapOuter);
@@ -121,6 +123,7 @@ void Workspace::cycleLayoutBackward() {
 void Workspace::addWindow(Window* w) {
     Q_ASSERT(w);
     if (m_windows.contains(w)) return;
+    settleLayout();
 
     // Connect window signals so the workspace can react to state changes.
     connectWindowSignals(w);
@@ -128,24 +131,33 @@ void Workspace::addWindow(Window* w) {
     m_windows.append(w);
     w->setWorkspace(m_id);
 
+    // Split the focused leaf — the new window has not been activated yet,
+    // so m_activeWindow is still the one the user was working in.
+    if (!w->isFloating() && !w->isFullscreen())
+        m_bsp.insert(w, m_activeWindow);
+
     // Update tile slots for all tiled windows.
     refreshTileSlots();
 
     qDebug() << "[Workspace" << m_id << "] window added:"
     << w->title() << "(id=" << w->id() << ") total=" << m_windows.size();
 
+    ++m_revision;
     emit windowAdded(w);
 }
 
 void Workspace::removeWindow(Window* w) {
     Q_ASSERT(w);
     if (!m_windows.contains(w)) return;
+    settleLayout();
 
     // Disconnect all signals we previously connected.
     disconnectWindowSignals(w);
 
     m_windows.removeOne(w);
     m_focusHistory.removeAll(w);
+    m_bsp.remove(w);
+    m_spatial.remove(w);
 
     // If the removed window was active, promote the most-recently-focused
     // window that is still on this workspace.
@@ -167,6 +179,7 @@ void Workspace::removeWindow(Window* w) {
     qDebug() << "[Workspace" << m_id << "] window removed:"
     << w->title() << "remaining=" << m_windows.size();
 
+    ++m_revision;
     emit windowRemoved(w);
 }
 
@@ -213,6 +226,7 @@ void Workspace::setActiveWindow(Window* w) {
     qDebug() << "[Workspace" << m_id << "] active window:"
     << (w ? w->title() : "<none>");
 
+    ++m_revision;
     emit activeWindowChanged(w);
 }
 
@@ -237,60 +251,17 @@ void Workspace::focusPrev() {
 void Workspace::focusDirection(FocusDirection dir) {
     if (!m_activeWindow || m_windows.size() < 2) return;
 
-    QList<Window*> candidates = focusableWindows();
-    if (candidates.size() < 2) return;
-
-    const QRect cur = m_activeWindow->geometry();
-    const QPoint curCenter = cur.center();
-
-    Window* best   = nullptr;
-    int     bestScore = INT_MAX;
-
-    for (auto* w : candidates) {
-        if (w == m_activeWindow) continue;
-
-        const QPoint wc = w->geometry().center();
-        const int dx = wc.x() - curCenter.x();
-        const int dy = wc.y() - curCenter.y();
-
-        // Determine if the candidate lies in the requested direction.
-        // We use a 45-degree sector test so diagonal neighbours are reachable.
-        bool inSector = false;
-        int  primary  = 0; // smaller = closer along primary axis
-        int  secondary = 0;
-
-        switch (dir) {
-            case FocusDirection::Left:
-                inSector  = (dx < 0) && (qAbs(dx) >= qAbs(dy));
-                primary   = -dx;
-                secondary = qAbs(dy);
-                break;
-            case FocusDirection::Right:
-                inSector  = (dx > 0) && (qAbs(dx) >= qAbs(dy));
-                primary   = dx;
-                secondary = qAbs(dy);
-                break;
-            case FocusDirection::Up:
-                inSector  = (dy < 0) && (qAbs(dy) >= qAbs(dx));
-                primary   = -dy;
-                secondary = qAbs(dx);
-                break;
-            case FocusDirection::Down:
-                inSector  = (dy > 0) && (qAbs(dy) >= qAbs(dx));
-                primary   = dy;
-                secondary = qAbs(dx);
-                break;
-        }
-
-        if (!inSector) continue;
-
-        // Score: prefer windows close on the primary axis, then secondary.
-        int score = primary * 4 + secondary;
-        if (score < bestScore) {
-            bestScore = score;
-            best      = w;
-        }
+    // Nearest window centre within the 45° sector either side of the
+    // direction, weighting distance along it 4× over sideways offset.
+    Qt::Edge edge = Qt::RightEdge;
+    switch (dir) {
+        case FocusDirection::Left:  edge = Qt::LeftEdge;   break;
+        case FocusDirection::Right: edge = Qt::RightEdge;  break;
+        case FocusDirection::Up:    edge = Qt::TopEdge;    break;
+        case FocusDirection::Down:  edge = Qt::BottomEdge; break;
     }
+    Window* best = m_spatial.nearest(m_activeWindow->geometry().center(),
+                                     edge, m_activeWindow);
 
     if (best) {
         setActiveWindow(best);
@@ -325,7 +296,9 @@ void Workspace::swapWindows(Window* a, Window* b) {
     int ia = m_windows.indexOf(a);
     int ib = m_windows.indexOf(b);
     if (ia < 0 || ib < 0) return;
+    settleLayout();
     m_windows.swapItemsAt(ia, ib);
+    m_bsp.swap(a, b);
     refreshTileSlots();
     qDebug() << "[Workspace" << m_id << "] swapped:"
     << a->title() << "<->" << b->title();
@@ -343,6 +316,8 @@ void Workspace::moveWindowUp(Window* w) {
     if (!w) return;
     int idx = m_windows.indexOf(w);
     if (idx <= 0) return;
+    settleLayout();
+    m_bsp.swap(w, m_windows[idx - 1]);
     m_windows.swapItemsAt(idx, idx - 1);
     refreshTileSlots();
 }
@@ -352,6 +327,8 @@ void Workspace::moveWindowDown(Window* w) {
     if (!w) return;
     int idx = m_windows.indexOf(w);
     if (idx < 0 || idx >= m_windows.size() - 1) return;
+    settleLayout();
+    m_bsp.swap(w, m_windows[idx + 1]);
     m_windows.swapItemsAt(idx, idx + 1);
     refreshTileSlots();
 }
@@ -361,6 +338,9 @@ void Workspace::moveWindowToTop(Window* w) {
     if (!w) return;
     if (!m_windows.removeOne(w)) return;
     m_windows.prepend(w);
+    settleLayout();
+    // BSP has no list order — take the top-left slot instead.
+    m_bsp.swap(w, m_bsp.firstWindow());
     refreshTileSlots();
 }
 
@@ -369,11 +349,13 @@ void Workspace::moveWindowToTop(Window* w) {
 // ─────────────────────────────────────────────────────────────────────────────
 
 void Workspace::setMasterRatio(float ratio) {
+    settleLayout();
     m_engine.setMasterRatio(ratio);
     emit masterRatioChanged(m_engine.masterRatio());
 }
 
 void Workspace::adjustMasterRatio(float delta) {
+    settleLayout();
     m_engine.adjustMasterRatio(delta);
     emit masterRatioChanged(m_engine.masterRatio());
 }
@@ -383,16 +365,53 @@ void Workspace::adjustMasterRatio(float delta) {
 // ─────────────────────────────────────────────────────────────────────────────
 
 QList<TileResult> Workspace::computeTiles(const QRect& area) const {
-    return m_engine.tile(m_windows, area, m_layout);
+    QList<TileResult> tiles;
+    computeTilesInto(area, tiles);
+    return tiles;
+}
+
+void Workspace::computeTilesInto(const QRect& area, QList<TileResult>& out) const {
+    settleLayout();
+    if (m_layout == TilingLayout::BSP)
+        m_engine.tileInto(m_windows, area, m_layout, out, &m_bsp, m_activeWindow);
+    else
+        m_engine.tileInto(m_windows, area, m_layout, out);
+}
+
+void Workspace::computeTileChanges(const QRect& area, QList<TileResult>& changed) const {
+    settleLayout();
+    if (m_layout == TilingLayout::BSP)
+        m_engine.tileChanges(m_windows, area, m_layout, changed, &m_bsp, m_activeWindow);
+    else
+        m_engine.tileChanges(m_windows, area, m_layout, changed);
+}
+
+void Workspace::snapshotTiles(const QRect& area, TilingEngine::Snapshot& snap) const {
+    settleLayout();
+    if (m_layout == TilingLayout::BSP)
+        m_engine.snapshot(m_windows, area, m_layout, &m_bsp, m_activeWindow, snap);
+    else
+        m_engine.snapshot(m_windows, area, m_layout, nullptr, nullptr, snap);
+}
+
+void Workspace::computeTileChanges(TilingEngine::Snapshot& snap, QList<TileResult>& changed) const {
+    // This is the job settleLayout() waits for — no waiting here.  The
+    // layout comes from the snapshot; m_layout may have moved on since.
+    BSPTree* bsp = TilingLayout(snap.key.layout) == TilingLayout::BSP ? &m_bsp : nullptr;
+    m_engine.tileChanges(snap, changed, bsp);
+}
+
+void Workspace::settleLayout() const {
+    if (!m_layoutJob.isFinished()) m_layoutJob.waitForFinished();
 }
 
 void Workspace::retile(const QRect& area) {
     if (area.isEmpty()) return;
 
     m_lastArea = area;
-    auto tiles = computeTiles(area);
+    computeTilesInto(area, m_tiles);
 
-    for (const auto& t : tiles) {
+    for (const auto& t : std::as_const(m_tiles)) {
         if (t.window && t.window->geometry() != t.targetGeometry) {
             t.window->setGeometry(t.targetGeometry);
         }
@@ -407,9 +426,9 @@ void Workspace::retileWithAnimation(const QRect& area) {
     if (area.isEmpty()) return;
 
     m_lastArea = area;
-    auto tiles = computeTiles(area);
+    computeTilesInto(area, m_tiles);
 
-    for (const auto& t : tiles) {
+    for (const auto& t : std::as_const(m_tiles)) {
         if (t.window && t.window->geometry() != t.targetGeometry) {
             t.window->setGeometryAnimated(t.targetGeometry);
         }
@@ -418,6 +437,26 @@ void Workspace::retileWithAnimation(const QRect& area) {
     emit retileRequested(area);
 }
 
+bool Workspace::resizeSplit(Window* w, Qt::Edges edges, const QPoint& cursor,
+                            const QRect& area) {
+    if (m_layout != TilingLayout::BSP || area.isEmpty()) return false;
+    settleLayout();
+    if (!w || !m_bsp.contains(w)) return false;
+
+    bool moved = false;
+    for (Qt::Edge e : {Qt::LeftEdge, Qt::RightEdge, Qt::TopEdge, Qt::BottomEdge}) {
+        if (!(edges & e)) continue;
+        const int pos = (e == Qt::LeftEdge || e == Qt::RightEdge) ? cursor.x() : cursor.y();
+        moved |= m_bsp.moveSplit(w, e, pos);
+    }
+    if (!moved) return false;
+
+    // Only the moved split's subtree is dirty; retile() leaves every other
+    // window's geometry untouched.
+    retile(area);
+    return true;
+}
+
 // ─────────────────────────────────────────────────────────────────────────────
 // Window visibility helpers
 // ─────────────────────────────────────────────────────────────────────────────
@@ -482,18 +521,27 @@ void Workspace::connectWindowSignals(Window* w) {
     // When a window changes state (e.g. client requests float/fullscreen) the
     // workspace must retile so the layout reflects the new window count.
     connect(w, &Window::stateChanged, this, [this](WindowState) {
-        if (!m_lastArea.isEmpty()) {
-            retileWithAnimation(m_lastArea);
-        }
+        emit retileNeeded();
     });
 
-    // If visibility changes (minimise / restore) retile immediately.
-    connect(w, &Window::geometryChanged, this, [this, w](const QRect& newRect) {
-        // Only care about geometry changes we didn't initiate (e.g. client
-        // resizing itself).  Update m_lastArea if it covers the new rect.
-        Q_UNUSED(w);
-        Q_UNUSED(newRect);
-        // No action needed here — WMCompositor drives retiling.
+    // Every geometry change — layout, animation frame, interactive move,
+    // client resize — moves the window in the hit-test grid.  Retiling
+    // itself is driven by WMCompositor.
+    connect(w, &Window::geometryChanged, this, [this, w](const QRect&) {
+        m_spatial.update(w);
+        ++m_revision;
+    });
+    connect(w, &Window::titleChanged, this, [this](const QString&) {
+        ++m_revision;
+    });
+    connect(w, &Window::visibilityChanged, this, [this](bool) {
+        ++m_revision;
+    });
+    connect(w, &Window::opacityChanged, this, [this](float) {
+        ++m_revision;
+    });
+    connect(w, &Window::contentChanged, this, [this]() {
+        ++m_contentRevision;
     });
 }
 
@@ -512,6 +560,8 @@ void Workspace::refreshTileSlots() {
             w->setTileSlot(-1);
         }
     }
+    // List order doubles as stacking order (last = top) for hit-testing.
+    m_spatial.restack(m_windows);
 }
 
 Window* Workspace::mostRecentlyFocused() const {
@@ -532,8 +582,6 @@ void Workspace::onWindowStateChanged(WindowState state) {
     qDebug() << "[Workspace" << m_id << "] window state changed:"
     << w->title() << (int)state;
 
-    refreshTileSlots();
-
     // When a window becomes fullscreen or maximized, push it to the top of
     // the visual stack by making sure it is last in the window list.
     if (state == WindowState::Fullscreen || state == WindowState::Maximized) {
@@ -542,6 +590,9 @@ void Workspace::onWindowStateChanged(WindowState state) {
             m_windows.append(w);
         }
     }
+
+    // After the reorder, so the spatial index stacks w on top
+    refreshTileSlots();
 }
 
 // ─────────────────────────────────────────────────────────────────────────────
@@ -3,10 +3,14 @@
 #include <QObject>
 #include <QList>
 #include <QRect>
+#include <QPoint>
 #include <QString>
+#include <QFuture>
 #include <climits>
 
 #include "TilingEngine.h"
+#include "BSPTree.h"
+#include "SpatialIndex.h"
 
 class Window;
 enum class WindowState;
@@ -34,6 +38,11 @@ enum class FocusDirection { Left, Right, Up, Down };
 //     m_windows (stale entries are removed when windows are removed).
 //   • Tile slots (Window::tileSlot) are kept in sync with m_windows order by
 //     refreshTileSlots().
+//   • m_bsp holds every tiled window that the BSP layout has seen; windows
+//     are inserted at the focused leaf and removed eagerly, so it never
+//     outlives a Window pointer.
+//   • m_spatial holds exactly the windows in m_windows, with their current
+//     geometry and their m_windows index as stacking order.
 // ─────────────────────────────────────────────────────────────────────────────
 class Workspace : public QObject {
     Q_OBJECT
@@ -131,6 +140,26 @@ public:
     /// Compute tile positions without applying them.
     QList<TileResult> computeTiles(const QRect& area) const;
 
+    /// Same, into a caller-owned buffer reused across calls (no allocation
+    /// once it has grown to the window count).
+    void computeTilesInto(const QRect& area, QList<TileResult>& out) const;
+
+    /// Only the tiles whose target moved since the previous call (or that
+    /// are new to the layout).  Empty when nothing relevant changed.
+    /// Touches only this workspace's engine and BSP tree, so different
+    /// workspaces may run it concurrently while no Window is mutated.
+    void computeTileChanges(const QRect& area, QList<TileResult>& changed) const;
+
+    /// The same in two halves, for layout off the GUI thread.
+    /// snapshotTiles() copies out what the layout reads from the windows;
+    /// computeTileChanges(snap) reads no Window and may run on a worker.
+    void snapshotTiles(const QRect& area, TilingEngine::Snapshot& snap) const;
+    void computeTileChanges(TilingEngine::Snapshot& snap, QList<TileResult>& changed) const;
+
+    /// A worker pass over this workspace's engine and BSP tree.  Until it
+    /// finishes, every method here that touches either waits for it.
+    void setLayoutJob(const QFuture<void>& job) { m_layoutJob = job; }
+
     /// Compute and immediately apply tile positions via Window::setGeometry().
     void retile(const QRect& area);
 
@@ -141,6 +170,14 @@ public:
     /// Last area passed to retile() — used to re-run layout on state changes.
     QRect lastArea() const { return m_lastArea; }
 
+    /// Interactive resize of a tiled window in the BSP layout: moves the
+    /// split(s) bordering \p w on \p edges to \p cursor and re-applies
+    /// geometry in \p area without animation.  Only the moved split's
+    /// subtree is recomputed.  Returns false if the layout is not BSP or
+    /// \p w has no split on those edges (caller falls back to a free resize).
+    bool resizeSplit(Window* w, Qt::Edges edges, const QPoint& cursor,
+                     const QRect& area);
+
     // ── Visibility helpers ────────────────────────────────────────────────
 
     /// Show all windows (called when switching TO this workspace).
@@ -163,6 +200,24 @@ public:
     /// All windows that can receive keyboard focus (visible).
     QList<Window*> focusableWindows()const;
 
+    // ── Hit-testing ───────────────────────────────────────────────────────
+
+    /// Top-most visible window under \p pos (compositor coordinates).
+    Window* windowAt(const QPoint& pos) const { return m_spatial.topAt(pos); }
+
+    // ── Render revision ───────────────────────────────────────────────────
+
+    /// Bumped whenever something a rendered picture of this workspace shows
+    /// changes: windows added, removed, moved, retitled, shown, hidden or
+    /// faded, or focus moving.
+    /// WMOutput keys its offscreen workspace snapshots on it.
+    quint64 revision() const { return m_revision; }
+
+    /// Bumped on every client commit.  Kept apart from revision() because
+    /// busy clients commit every frame: a snapshot that is only behind on
+    /// content is still good enough to slide in.
+    quint64 contentRevision() const { return m_contentRevision; }
+
     // ── Debug ─────────────────────────────────────────────────────────────
     QString debugString() const;
 
@@ -173,6 +228,9 @@ signals:
     void layoutChanged(TilingLayout l);
     void masterRatioChanged(float ratio);
     void retileRequested(const QRect& area);
+    /// A window's state change invalidated the layout; the compositor
+    /// coalesces this with other requests into one pass per frame.
+    void retileNeeded();
 
 private slots:
     void onConfigReloaded();
@@ -185,13 +243,18 @@ private:
 
     // ── Internal helpers ──────────────────────────────────────────────────
 
-    /// Assign consecutive tileSlot indices to all non-floating windows.
+    /// Assign consecutive tileSlot indices to all non-floating windows and
+    /// push the current m_windows order into the spatial index.
     void refreshTileSlots();
 
     /// Return the first visible window in the MRU focus history that is
     /// still present in m_windows.
     Window* mostRecentlyFocused() const;
 
+    /// Block until the layout job (setLayoutJob()) is done with m_engine
+    /// and m_bsp.  Normally already finished.
+    void settleLayout() const;
+
     // ── Members ───────────────────────────────────────────────────────────
     int          m_id;
     QString      m_name;
@@ -200,6 +263,13 @@ private:
     TilingLayout m_layout = TilingLayout::Spiral;
     TilingEngine m_engine;
 
+    /// Persistent BSP partition.  Mutable: computeTiles() is logically const
+    /// but the tree caches split rects and syncs membership lazily.
+    mutable BSPTree m_bsp;
+
+    /// Grid over window rects for windowAt() and focusDirection().
+    SpatialIndex   m_spatial;
+
     QList<Window*> m_windows;        ///< All windows, in tile order.
     Window*        m_activeWindow = nullptr;
 
@@ -209,5 +279,14 @@ private:
     /// Work area from the last retile() call; used to re-tile on state change.
     QRect          m_lastArea;
 
+    /// Result buffer for retile() / retileWithAnimation().
+    QList<TileResult> m_tiles;
+
+    /// Worker pass in flight on m_engine / m_bsp, if any.
+    mutable QFuture<void> m_layoutJob;
+
+    quint64        m_revision        = 0;
+    quint64        m_contentRevision = 0;
+
     static constexpr int kMaxFocusHistory = 32;
 };
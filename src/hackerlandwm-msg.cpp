@@ -20,9 +20,20 @@
 //   hackerlandwm-msg reload
 //   hackerlandwm-msg lock
 //   hackerlandwm-msg status
+//   hackerlandwm-msg get_tree
+//   hackerlandwm-msg get_tree_since 1234
+//   hackerlandwm-msg state
+//   hackerlandwm-msg latency
+//   hackerlandwm-msg latency reset
+//   hackerlandwm-msg ipc_stats
+//   hackerlandwm-msg screenshot_window firefox --decorations ~/zgloszenie.png
+//   hackerlandwm-msg subscribe workspace window
 //   hackerlandwm-msg quit
+//   hackerlandwm-msg 'workspace 3; exec alacritty; layout tall'
+//   hackerlandwm-msg --stdin < login-commands.txt   (bez subscribe)
 //
 // Protokół: linia tekstu → JSON response {"success":true} lub {"success":false,"error":"..."}
+//           subscribe: po odpowiedzi jedna linia JSON na zdarzenie, aż do rozłączenia
 // Socket:   $XDG_RUNTIME_DIR/hackerlandwm.sock
 // ─────────────────────────────────────────────────────────────────────────────
 
@@ -34,6 +45,9 @@
 #include <QDir>
 #include <QJsonDocument>
 #include <QJsonObject>
+#include <QJsonArray>
+
+#include "hackerlandwm-state.h"
 
 #include <cstdio>
 #include <unistd.h>
@@ -57,6 +71,8 @@ static void printHelp() {
             "\n"
             "Użycie:\n"
             "  hackerlandwm-msg <komenda> [argumenty]\n"
+            "  hackerlandwm-msg '<komenda>; <komenda>; ...'\n"
+            "  hackerlandwm-msg --stdin < komendy.txt\n"
             "\n"
             "Komendy:\n"
             "  workspace <N>          przełącz na workspace N (1-9)\n"
@@ -71,8 +87,24 @@ static void printHelp() {
             "  reload                 przeładuj config bez restartu WM\n"
             "  lock                   zablokuj ekran\n"
             "  status                 pokaż stan WM (JSON)\n"
+            "  get_tree               pełne drzewo: wyjścia → workspace'y → okna (JSON)\n"
+            "  get_tree_since <gen>   tylko węzły zmienione po generacji <gen>\n"
+            "  state_page             ścieżka strony stanu w pamięci współdzielonej\n"
+            "  state                  stan z pamięci współdzielonej ($HACKERLANDWM_STATE)\n"
+            "  screenshot_window <id|app_id> [--decorations] [plik]\n"
+            "                         zrzut jednego okna, także zasłoniętego\n"
+            "  latency [reset]        histogramy opóźnień wejście → klatka (JSON)\n"
+            "  ipc_stats [reset]      kolejka komend IPC: głębokość, czas oczekiwania, limity\n"
+            "  subscribe <klasa>...   wypisuj zdarzenia (JSON, linia na zdarzenie):\n"
+            "                         workspace|window|layout|config|output\n"
             "  quit                   zamknij WM\n"
             "\n"
+            "Paczki:\n"
+            "  Komendy rozdzielone ';' (lub tablica JSON) wykonywane są razem:\n"
+            "  najpierw wszystkie są sprawdzane, potem wykonane — albo żadna.\n"
+            "  --stdin trzyma jedno połączenie i wysyła komendy linia po linii\n"
+            "  (bez subscribe — ten uruchamiaj osobno).\n"
+            "\n"
             "Przykłady:\n"
             "  hackerlandwm-msg workspace 3\n"
             "  hackerlandwm-msg exec alacritty\n"
@@ -81,6 +113,7 @@ static void printHelp() {
             "  hackerlandwm-msg reload\n"
             "  hackerlandwm-msg lock\n"
             "  hackerlandwm-msg status\n"
+            "  hackerlandwm-msg subscribe workspace window | jq .\n"
             "\n"
             "Socket: %s\n",
             socketPath().toLocal8Bit().constData()
@@ -116,8 +149,31 @@ static bool validateCommand(const QStringList& parts, QString& error) {
             error = "nieznany kierunek: " + parts[1];
             return false;
         }
+    } else if (verb == "latency" || verb == "ipc_stats") {
+        if (parts.size() > 1 && parts[1].toLower() != "reset") {
+            error = verb + " przyjmuje tylko argument 'reset'";
+            return false;
+        }
+    } else if (verb == "screenshot_window") {
+        if (parts.size() < 2) { error = "screenshot_window wymaga id okna albo app_id"; return false; }
+    } else if (verb == "get_tree_since") {
+        bool ok = false;
+        if (parts.size() < 2 || (parts[1].toULongLong(&ok), !ok)) {
+            error = "get_tree_since wymaga numeru generacji";
+            return false;
+        }
+    } else if (verb == "subscribe") {
+        if (parts.size() < 2) { error = "subscribe wymaga klasy zdarzeń"; return false; }
+        const QStringList classes = {"workspace","window","layout","config","output"};
+        for (const auto& c : parts.mid(1)) {
+            if (!classes.contains(c.toLower())) {
+                error = QString("nieznana klasa zdarzeń '%1'. Dostępne: %2")
+                .arg(c).arg(classes.join(", "));
+                return false;
+            }
+        }
     } else if (!QStringList{"close","fullscreen","float","maximize",
-        "reload","lock","status","quit"}.contains(verb)) {
+        "reload","lock","status","get_tree","state_page","state","quit"}.contains(verb)) {
         error = "nieznana komenda: " + verb;
         return false;
         }
@@ -128,23 +184,8 @@ static bool validateCommand(const QStringList& parts, QString& error) {
 // ─────────────────────────────────────────────────────────────────────────────
 // Drukowanie odpowiedzi JSON
 // ─────────────────────────────────────────────────────────────────────────────
-static int printResponse(const QByteArray& raw) {
-    if (raw.trimmed().isEmpty()) {
-        fprintf(stderr, "Brak odpowiedzi od hackerlandwm\n");
-        return 1;
-    }
-
-    QJsonParseError err;
-    const QJsonDocument doc = QJsonDocument::fromJson(raw.trimmed(), &err);
-
-    if (err.error != QJsonParseError::NoError) {
-        // Odpowiedź nie jest JSON — wydrukuj bezpośrednio
-        fprintf(stdout, "%s\n", raw.trimmed().constData());
-        return 0;
-    }
-
-    const QJsonObject obj = doc.object();
-    const bool success    = obj["success"].toBool();
+static int printReply(const QJsonObject& obj) {
+    const bool success = obj["success"].toBool();
 
     if (success) {
         if (obj.contains("result")) {
@@ -170,6 +211,134 @@ static int printResponse(const QByteArray& raw) {
     }
 }
 
+static int printResponse(const QByteArray& raw) {
+    if (raw.trimmed().isEmpty()) {
+        fprintf(stderr, "Brak odpowiedzi od hackerlandwm\n");
+        return 1;
+    }
+
+    QJsonParseError err;
+    const QJsonDocument doc = QJsonDocument::fromJson(raw.trimmed(), &err);
+
+    if (err.error != QJsonParseError::NoError) {
+        // Odpowiedź nie jest JSON — wydrukuj bezpośrednio
+        fprintf(stdout, "%s\n", raw.trimmed().constData());
+        return 0;
+    }
+
+    // Paczka komend — jedna odpowiedź na komendę
+    if (doc.isArray()) {
+        int rc = 0;
+        for (const auto& v : doc.array())
+            rc |= printReply(v.toObject());
+        return rc;
+    }
+    return printReply(doc.object());
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// state — odczyt stanu ze współdzielonej pamięci (hackerlandwm-state.h),
+// bez żadnej komendy IPC, gdy znamy ścieżkę
+// ─────────────────────────────────────────────────────────────────────────────
+static int printState(const QString& path) {
+    const hlwm_state_page* page = hlwm_state_map(path.toLocal8Bit().constData());
+    if (!page) {
+        fprintf(stderr, "hackerlandwm-msg: nie można zmapować %s\n", path.toLocal8Bit().constData());
+        return 1;
+    }
+
+    static hlwm_state_page snap;
+    const int rc = hlwm_state_read(page, &snap);
+    hlwm_state_unmap(page);
+    if (rc != 0) {
+        fprintf(stderr, "hackerlandwm-msg: stan zmienia się zbyt szybko, spróbuj ponownie\n");
+        return 1;
+    }
+
+    QJsonArray windows;
+    for (uint32_t i = 0; i < snap.window_count; ++i) {
+        const hlwm_state_window& w = snap.windows[i];
+        QJsonObject o;
+        o["id"]        = qint64(w.id);
+        o["workspace"] = w.workspace;
+        o["app_id"]    = QString::fromUtf8(w.app_id);
+        o["title"]     = QString::fromUtf8(w.title);
+        o["focused"]   = bool(w.flags & HLWM_WINDOW_FOCUSED);
+        o["visible"]   = bool(w.flags & HLWM_WINDOW_VISIBLE);
+        windows.append(o);
+    }
+
+    QJsonObject st;
+    st["generation"]     = qint64(snap.generation);
+    st["workspace"]      = snap.active_workspace;
+    st["focused_window"] = qint64(snap.focused_window);
+    st["focused_title"]  = QString::fromUtf8(snap.focused_title);
+    st["total_windows"]  = qint64(snap.total_windows);
+    st["windows"]        = windows;
+    fprintf(stdout, "%s\n", QJsonDocument(st).toJson(QJsonDocument::Indented).constData());
+    return 0;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// --stdin — jedno połączenie, komendy linia po linii
+//
+// Komendy są wysyłane potokowo, bez czekania na każdą odpowiedź; serwer
+// odpowiada w kolejności.  Odpowiedzi drukowane są, gdy tylko przyjdą.
+// ─────────────────────────────────────────────────────────────────────────────
+static int runStdin(QLocalSocket& sock) {
+    int  rc      = 0;
+    long pending = 0;
+
+    auto drain = [&](int timeoutMs) {
+        while (pending > 0) {
+            while (pending > 0 && sock.canReadLine()) {
+                rc |= printResponse(sock.readLine());
+                --pending;
+            }
+            fflush(stdout);
+            if (pending == 0 || !sock.waitForReadyRead(timeoutMs)) break;
+        }
+    };
+
+    // subscribe zamieniłby resztę połączenia w strumień zdarzeń i kolejne
+    // odpowiedzi utonęłyby w nim — odrzucamy go tu, zanim trafi do serwera
+    auto isSubscribe = [](const QString& line) {
+        for (const QString& part : line.split(';')) {
+            if (part.trimmed().section(' ', 0, 0).toLower() == "subscribe")
+                return true;
+        }
+        return false;
+    };
+
+    QTextStream in(stdin);
+    QString line;
+    long lineNo = 0;
+    while (in.readLineInto(&line)) {
+        ++lineNo;
+        line = line.trimmed();
+        if (line.isEmpty() || line.startsWith('#')) continue;
+        if (isSubscribe(line)) {
+            drain(0);
+            fprintf(stderr, "hackerlandwm-msg: linia %ld: subscribe nie działa z --stdin — "
+                            "uruchom osobno: hackerlandwm-msg subscribe <klasa>...\n", lineNo);
+            rc = 1;
+            continue;
+        }
+        sock.write((line + "\n").toUtf8());
+        ++pending;
+        sock.flush();
+        drain(0);
+    }
+
+    drain(3000);
+    if (pending > 0) {
+        fprintf(stderr, "hackerlandwm-msg: brak %ld odpowiedzi\n", pending);
+        rc = 1;
+    }
+    sock.disconnectFromServer();
+    return rc;
+}
+
 // ─────────────────────────────────────────────────────────────────────────────
 // main
 // ─────────────────────────────────────────────────────────────────────────────
@@ -193,12 +362,21 @@ int main(int argc, char* argv[]) {
             return 0;
         }
 
+        const bool stdinMode = allArgs.first() == "--stdin";
+
+        // ── state: pamięć współdzielona, IPC tylko po ścieżkę ───────────────
+        const QString statePath = qEnvironmentVariable("HACKERLANDWM_STATE");
+        if (allArgs.first() == "state" && !statePath.isEmpty())
+            return printState(statePath);
+
         // ── Zbuduj komendę ────────────────────────────────────────────────────
         const QString cmd = allArgs.join(' ');
 
         // ── Walidacja ─────────────────────────────────────────────────────────
+        // Paczki (';' lub tablica JSON) waliduje serwer — w całości
+        const bool batch = cmd.contains(';') || cmd.startsWith('[');
         QString validErr;
-        if (!validateCommand(allArgs, validErr)) {
+        if (!stdinMode && !batch && !validateCommand(allArgs, validErr)) {
             fprintf(stderr, "hackerlandwm-msg: %s\n", validErr.toLocal8Bit().constData());
             fprintf(stderr, "Użyj --help aby zobaczyć dostępne komendy.\n");
             return 1;
@@ -219,8 +397,11 @@ int main(int argc, char* argv[]) {
             return 1;
         }
 
+        if (stdinMode) return runStdin(sock);
+
         // ── Wyślij komendę ────────────────────────────────────────────────────
-        sock.write((cmd + "\n").toUtf8());
+        const bool stateMode = allArgs.first() == "state";
+        sock.write(((stateMode ? QString("state_page") : cmd) + "\n").toUtf8());
         if (!sock.flush()) {
             fprintf(stderr, "hackerlandwm-msg: błąd wysyłania\n");
             return 1;
@@ -238,8 +419,39 @@ int main(int argc, char* argv[]) {
             return 1;
         }
 
-        const QByteArray response = sock.readAll();
+        // ── subscribe: odpowiedź, potem strumień zdarzeń ─────────────────────
+        if (allArgs[0].toLower() == "subscribe") {
+            while (!sock.canReadLine() && sock.waitForReadyRead(3000)) {}
+            const int rc = printResponse(sock.readLine());
+            if (rc != 0) return rc;
+
+            for (;;) {
+                while (sock.canReadLine()) {
+                    fputs(sock.readLine().constData(), stdout);
+                }
+                fflush(stdout);
+                if (sock.state() != QLocalSocket::ConnectedState) break;
+                sock.waitForReadyRead(-1);
+            }
+            return 0;
+        }
+
+        // Duża odpowiedź (get_tree) przychodzi w kilku kawałkach — czytaj
+        // do końca linii, tak jak przy subscribe
+        while (!sock.canReadLine() && sock.waitForReadyRead(3000)) {}
+        if (!sock.canReadLine()) {
+            fprintf(stderr, "hackerlandwm-msg: timeout — niepełna odpowiedź\n");
+            return 1;
+        }
+        const QByteArray response = sock.readLine();
         sock.disconnectFromServer();
 
+        if (stateMode) {
+            const QJsonObject obj = QJsonDocument::fromJson(response.trimmed()).object();
+            if (!obj["success"].toBool()) return printResponse(response);
+            const QJsonObject info = QJsonDocument::fromJson(obj["result"].toString().toUtf8()).object();
+            return printState(info["path"].toString());
+        }
+
         return printResponse(response);
 }
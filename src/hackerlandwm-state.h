@@ -0,0 +1,143 @@
+/*
+ * ─────────────────────────────────────────────────────────────────────────────
+ * hackerlandwm-state.h — read HackerLand WM state from shared memory
+ *
+ * The compositor publishes a small snapshot of its state (active workspace,
+ * focused window, window list) into a memfd page and advertises it:
+ *
+ *   - in $HACKERLANDWM_STATE, set for every process it launches, and
+ *   - through IPC:  hackerlandwm-msg state_page  →  {"path": ..., ...}
+ *
+ * The path is /proc/<compositor pid>/fd/<n>; only the same user can open it.
+ * Readers map it read-only once and then read with no syscalls at all:
+ *
+ *   const struct hlwm_state_page* page = hlwm_state_map(getenv("HACKERLANDWM_STATE"));
+ *   struct hlwm_state_page snap;
+ *   uint64_t seen = 0;
+ *   for (;;) {
+ *       if (hlwm_state_changed(page, seen) && hlwm_state_read(page, &snap) == 0) {
+ *           seen = snap.seq;
+ *           printf("workspace %d: %s\n", snap.active_workspace, snap.focused_title);
+ *       }
+ *       ...
+ *   }
+ *
+ * Consistency comes from a seqlock: the compositor makes `seq` odd while it
+ * writes and even again when done; hlwm_state_read() copies, then retries if
+ * `seq` moved or was odd.  Strings are NUL-terminated UTF-8, truncated to
+ * fit.  Plain C99 / C++, no Qt, GCC / Clang atomics.
+ * ─────────────────────────────────────────────────────────────────────────────
+ */
+#ifndef HACKERLANDWM_STATE_H
+#define HACKERLANDWM_STATE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define HLWM_STATE_MAGIC        0x484C5354u   /* "HLST" */
+#define HLWM_STATE_VERSION      1u
+#define HLWM_STATE_SIZE         65536u
+#define HLWM_STATE_MAX_WINDOWS  256
+#define HLWM_STATE_TITLE_LEN    128
+#define HLWM_STATE_APP_ID_LEN   64
+
+/* hlwm_state_window.flags */
+#define HLWM_WINDOW_FOCUSED     (1u << 0)
+#define HLWM_WINDOW_VISIBLE     (1u << 1)
+#define HLWM_WINDOW_FLOATING    (1u << 2)
+#define HLWM_WINDOW_FULLSCREEN  (1u << 3)
+#define HLWM_WINDOW_MAXIMIZED   (1u << 4)
+
+struct hlwm_state_window {
+    uint64_t id;                               /* same id as get_tree */
+    int32_t  workspace;
+    uint32_t flags;                            /* HLWM_WINDOW_* */
+    int32_t  x, y, width, height;
+    char     app_id[HLWM_STATE_APP_ID_LEN];
+    char     title[HLWM_STATE_TITLE_LEN];
+};
+
+struct hlwm_state_page {
+    uint32_t magic;                            /* HLWM_STATE_MAGIC */
+    uint32_t version;                          /* HLWM_STATE_VERSION */
+    uint32_t size;                             /* bytes mapped */
+    uint32_t reserved;
+
+    uint64_t seq;                              /* seqlock — odd while writing */
+    uint64_t generation;                       /* get_tree generation */
+    uint64_t update_ns;                        /* CLOCK_MONOTONIC of the write */
+
+    int32_t  active_workspace;
+    int32_t  workspace_count;
+    uint64_t focused_window;                   /* 0: none */
+    char     focused_title[HLWM_STATE_TITLE_LEN];
+
+    uint32_t window_count;                     /* entries used in windows[] */
+    uint32_t total_windows;                    /* > window_count if truncated */
+    struct hlwm_state_window windows[HLWM_STATE_MAX_WINDOWS];
+};
+
+#ifdef __cplusplus
+static_assert(sizeof(struct hlwm_state_page) <= HLWM_STATE_SIZE, "state page overflows its mapping");
+#else
+_Static_assert(sizeof(struct hlwm_state_page) <= HLWM_STATE_SIZE, "state page overflows its mapping");
+#endif
+
+/* Map the page at \p path read-only.  NULL if it cannot be opened or is not
+ * a version HLWM_STATE_VERSION page. */
+static inline const struct hlwm_state_page* hlwm_state_map(const char* path) {
+    if (!path || !*path) return NULL;
+    const int fd = open(path, O_RDONLY);    /* closed again right below */
+    if (fd < 0) return NULL;
+    void* p = mmap(NULL, HLWM_STATE_SIZE, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) return NULL;
+
+    const struct hlwm_state_page* page = (const struct hlwm_state_page*)p;
+    if (page->magic != HLWM_STATE_MAGIC || page->version != HLWM_STATE_VERSION) {
+        munmap(p, HLWM_STATE_SIZE);
+        return NULL;
+    }
+    return page;
+}
+
+static inline void hlwm_state_unmap(const struct hlwm_state_page* page) {
+    if (page) munmap((void*)page, HLWM_STATE_SIZE);
+}
+
+/* Nonzero if the page was written since a snapshot taken at \p seen_seq.
+ * One load — cheap enough to call every frame. */
+static inline int hlwm_state_changed(const struct hlwm_state_page* page, uint64_t seen_seq) {
+    return __atomic_load_n(&page->seq, __ATOMIC_ACQUIRE) != seen_seq;
+}
+
+/* Copy a consistent snapshot into \p out: the fixed part plus the
+ * window_count windows in use.  0 on success, -1 if the compositor kept
+ * writing through every retry. */
+static inline int hlwm_state_read(const struct hlwm_state_page* page,
+                                  struct hlwm_state_page* out) {
+    for (int attempt = 0; attempt < 64; ++attempt) {
+        const uint64_t s1 = __atomic_load_n(&page->seq, __ATOMIC_ACQUIRE);
+        if (s1 & 1) continue;
+
+        memcpy(out, page, offsetof(struct hlwm_state_page, windows));
+        uint32_t n = out->window_count;
+        if (n > HLWM_STATE_MAX_WINDOWS) n = HLWM_STATE_MAX_WINDOWS;
+        memcpy(out->windows, page->windows, n * sizeof(struct hlwm_state_window));
+
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&page->seq, __ATOMIC_RELAXED) == s1) {
+            out->seq          = s1;
+            out->window_count = n;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+#endif /* HACKERLANDWM_STATE_H */
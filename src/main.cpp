@@ -11,6 +11,7 @@
 #include <QTextStream>
 #include <QDateTime>
 #include <QTimer>
+#include <QJsonDocument>
 #include <csignal>
 #include <unistd.h>
 #include <sys/utsname.h>
@@ -19,6 +20,8 @@
 #include "compositor/IPCServer.h"
 #include "core/Config.h"
 #include "core/GamepadHandler.h"
+#include "core/LibinputBackend.h"
+#include "core/InputRecorder.h"
 
 Q_LOGGING_CATEGORY(lcWM, "hackerlandwm")
 
@@ -244,7 +247,12 @@ int main(int argc, char* argv[])
     const QCommandLineOption modeOpt   ("mode",          "Compositor mode: tiling|cage|gamescope", "mode");
     const QCommandLineOption execOpt   ("exec",          "Command to run in cage/gamescope mode",  "cmd");
     const QCommandLineOption gamepadOpt("gamepad",       "Enable gamepad / joystick input");
+    const QCommandLineOption libinputOpt("libinput",     "Read input with libinput on its own thread (needs /dev/input access)");
+    const QCommandLineOption inputDevOpt("input-device", "With --libinput: use only this evdev node (repeatable)", "node");
     const QCommandLineOption noIpcOpt  ("no-ipc",        "Disable IPC socket");
+    const QCommandLineOption recordOpt ("record",        "Record input and IPC commands to a file", "file");
+    const QCommandLineOption replayOpt ("replay",        "Replay a recording, print statistics and exit", "file");
+    const QCommandLineOption speedOpt  ("replay-speed",  "Replay speed factor (default 1)", "factor", "1");
 
     parser.addOption(cfgOpt);
     parser.addOption(devOpt);
@@ -254,7 +262,12 @@ int main(int argc, char* argv[])
     parser.addOption(modeOpt);
     parser.addOption(execOpt);
     parser.addOption(gamepadOpt);
+    parser.addOption(libinputOpt);
+    parser.addOption(inputDevOpt);
     parser.addOption(noIpcOpt);
+    parser.addOption(recordOpt);
+    parser.addOption(replayOpt);
+    parser.addOption(speedOpt);
     parser.process(app);
 
     // ── Dev logging ───────────────────────────────────────────────────────
@@ -363,20 +376,70 @@ int main(int argc, char* argv[])
     if (parser.isSet(gamepadOpt)) {
         gamepad = new GamepadHandler(&compositor);
         if (gamepad->start()) {
-            // dispatchAction is the public slot — handleKeybind is private
             QObject::connect(gamepad, &GamepadHandler::actionTriggered,
-                             &compositor, &WMCompositor::dispatchAction);
+                             &compositor, &WMCompositor::dispatch);
         } else {
-            qCWarning(lcWM) << "[Gamepad] no joystick device found (/dev/input/js0-js3)";
+            qCWarning(lcWM) << "[Gamepad] no gamepad found and no udev to wait for one";
         }
     }
 
+    // ── Native input ──────────────────────────────────────────────────────
+    // Opt-in: reads the seat's devices on a dedicated thread instead of
+    // taking Qt's input events.  --input-device picks exact nodes through
+    // the path backend (e.g. uinput devices replaying a recording).
+    LibinputBackend* libinput = nullptr;
+    if (parser.isSet(libinputOpt) || parser.isSet(inputDevOpt)) {
+        libinput = new LibinputBackend(compositor.inputHandler(), &compositor);
+        const QStringList nodes = parser.values(inputDevOpt);
+        const bool ok = nodes.isEmpty() ? libinput->start()
+                                        : libinput->startWithDevices(nodes);
+        if (!ok) {
+            delete libinput;
+            libinput = nullptr;
+        }
+    }
+
+    // ── Record / replay ───────────────────────────────────────────────────
+    // Benchmark runs replay headless against the same config and clients:
+    //   QT_QPA_PLATFORM=offscreen ./hackerlandwm --no-ipc --replay session.hlrec
+    // The report (JSON, latency and frame-interval histograms) goes to stdout.
+    InputRecorder recorder;
+    if (parser.isSet(recordOpt) && !recorder.start(parser.value(recordOpt))) {
+        return 1;
+    }
+
+    InputReplayer* replayer = nullptr;
+    if (parser.isSet(replayOpt)) {
+        if (!ipc) ipc = new IPCServer(&compositor, &compositor);   // execute() only
+        replayer = new InputReplayer(compositor.inputHandler(), ipc, &compositor);
+        if (!replayer->load(parser.value(replayOpt))) {
+            return 1;
+        }
+        QObject::connect(replayer, &InputReplayer::finished,
+                         [](const QJsonObject& report) {
+                             const QByteArray json = QJsonDocument(report).toJson();
+                             fwrite(json.constData(), 1, json.size(), stdout);
+                             fflush(stdout);
+                             QCoreApplication::quit();
+                         });
+    }
+
     compositor.show();
     qCInfo(lcWM) << "Running. WAYLAND_DISPLAY=" << qgetenv("WAYLAND_DISPLAY");
 
+    if (replayer) {
+        bool ok = false;
+        double speed = parser.value(speedOpt).toDouble(&ok);
+        if (!ok || speed <= 0.0) speed = 1.0;
+        qCInfo(lcWM) << "replaying" << replayer->eventCount() << "events at" << speed << "x";
+        QTimer::singleShot(0, replayer, [replayer, speed] { replayer->start(speed); });
+    }
+
     const int ret = app.exec();
 
     // ── Cleanup ───────────────────────────────────────────────────────────
+    recorder.stop();
+    delete libinput;   // joins the input thread before InputHandler goes
     delete gamepad;
     delete ipc;
 
@@ -149,6 +149,17 @@ void RenderEngine::drawWindow(QPainter& p, Window* w, bool active) {
     const float opacity = qBound(0.f, w->opacity(), 1.f);
     p.setOpacity(opacity);
 
+    // Animations move / scale the committed frame rather than the geometry,
+    // so the blur cache above survives them.
+    p.save();
+    if (w->hasVisualTransform()) {
+        const QRect vis = w->visualGeometry();
+        p.translate(vis.topLeft());
+        p.scale(qreal(vis.width())  / rect.width(),
+                qreal(vis.height()) / rect.height());
+        p.translate(-rect.topLeft());
+    }
+
     drawWindowShadow        (p, rect, active);
     drawWindowBlurBackground(p, w, rect);
     drawWindowGlassOverlay  (p, rect, active);
@@ -156,6 +167,7 @@ void RenderEngine::drawWindow(QPainter& p, Window* w, bool active) {
     drawTitleBar            (p, w, active);
     drawTitleBarSeparator   (p, rect, active);
 
+    p.restore();
     p.setOpacity(1.f);
 }
 
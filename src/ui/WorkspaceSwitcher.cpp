@@ -1,5 +1,6 @@
 #include "WorkspaceSwitcher.h"
 #include "compositor/WMCompositor.h"
+#include "compositor/WMOutput.h"
 #include "core/Workspace.h"
 #include "core/Window.h"
 #include "core/Config.h"
@@ -194,6 +195,18 @@ void WorkspaceSwitcher::rebuildThumb(WsThumb& t, Workspace* ws) {
     t.tiles.clear();
     t.occupied = false;
 
+    // The output keeps a picture of every workspace it has switched away
+    // from; while it is still current, show that instead of mini-tiles.
+    t.preview = QPixmap();
+    if (WMOutput* out = m_compositor->primaryOutput()) {
+        const QImage snap = out->workspaceSnapshot(ws->id());
+        if (!snap.isNull()) {
+            t.preview = QPixmap::fromImage(
+                snap.scaled(kThumbW - kThumbPad * 2, kThumbH - kThumbPad * 2,
+                            Qt::IgnoreAspectRatio, Qt::SmoothTransformation));
+        }
+    }
+
     const QList<Window*> wins = ws->visibleWindows();
     if (wins.isEmpty()) {
         t.previewDirty = false;
@@ -511,6 +524,11 @@ void WorkspaceSwitcher::drawThumbFrame(QPainter& p, const WsThumb& t) {
 // ── drawThumbTiles ────────────────────────────────────────────────────────────
 
 void WorkspaceSwitcher::drawThumbTiles(QPainter& p, const WsThumb& t) {
+    if (!t.preview.isNull()) {
+        p.drawPixmap(t.rect.topLeft() + QPoint(kThumbPad, kThumbPad), t.preview);
+        return;
+    }
+
     if (t.tiles.isEmpty()) {
         // Empty workspace — draw a subtle grid hint.
         const auto& theme = Config::instance().theme;
@@ -31,7 +31,7 @@ struct WsThumb {
     bool     active   = false;     ///< This is the currently-shown workspace
     bool     occupied = false;     ///< Has at least one visible window
     QRect    rect;                 ///< Thumb rect in switcher-local coords
-    QPixmap  preview;              ///< Scaled-down window layout preview
+    QPixmap  preview;              ///< Scaled output snapshot; null → mini-tiles
     bool     previewDirty = true;  ///< Needs to be repainted
 
     // ── Window mini-tiles for the preview ─────────────────────────────────
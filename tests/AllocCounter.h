@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Allocation counter
+//
+// Qt containers allocate through malloc/realloc and operator new ends up in
+// malloc too, so interposing those three catches every heap allocation made
+// on the counting thread.  glibc exports the real implementations as
+// __libc_*; elsewhere HLWM_COUNT_ALLOCS is not defined and tests that need
+// it should QSKIP.
+//
+// Defines malloc() — include from exactly one file per test executable.
+// ─────────────────────────────────────────────────────────────────────────────
+#if defined(__GLIBC__)
+#define HLWM_COUNT_ALLOCS 1
+
+namespace {
+thread_local bool t_counting = false;
+thread_local long t_allocs   = 0;
+
+inline void countAlloc() {
+    if (t_counting) ++t_allocs;
+}
+} // namespace
+
+extern "C" {
+void* __libc_malloc(size_t);
+void* __libc_realloc(void*, size_t);
+void* __libc_calloc(size_t, size_t);
+
+void* malloc(size_t n)              { countAlloc(); return __libc_malloc(n); }
+void* realloc(void* p, size_t n)    { countAlloc(); return __libc_realloc(p, n); }
+void* calloc(size_t c, size_t n)    { countAlloc(); return __libc_calloc(c, n); }
+}
+#endif
+
+namespace {
+
+/// Counts heap allocations on this thread for the lifetime of the guard.
+struct AllocScope {
+#ifdef HLWM_COUNT_ALLOCS
+    AllocScope()  { t_allocs = 0; t_counting = true; }
+    ~AllocScope() { t_counting = false; }
+    long count() const { return t_allocs; }
+#else
+    long count() const { return 0; }
+#endif
+};
+
+} // namespace
@@ -0,0 +1,129 @@
+#include <QtTest>
+
+#include "core/Action.h"
+#include "core/TilingEngine.h"
+
+// ─────────────────────────────────────────────────────────────────────────────
+// A mix of what the default bindings and typical IPC scripts send
+// ─────────────────────────────────────────────────────────────────────────────
+namespace {
+
+const char* const kSpecs[] = {
+    "exec:alacritty",  "workspace:3",     "workspace:next",  "movetoworkspace:7",
+    "focus:left",      "focus:next",      "move:down",       "layout:bsp",
+    "layout:cycle",    "close",           "fullscreen",      "float",
+};
+
+/// Stand-in for WMCompositor::dispatch(): a switch over the opcode, which
+/// is all the per-trigger work left once an action is parsed.
+int dispatch(const Action& a) {
+    switch (a.op) {
+        case ActionOp::Exec:            return a.str.size();
+        case ActionOp::Workspace:
+        case ActionOp::MoveToWorkspace:
+        case ActionOp::Focus:
+        case ActionOp::Move:
+        case ActionOp::Layout:          return a.arg;
+        case ActionOp::None:            return -1;
+        default:                        return int(a.op);
+    }
+}
+
+} // namespace
+
+// ─────────────────────────────────────────────────────────────────────────────
+// TestAction
+// ─────────────────────────────────────────────────────────────────────────────
+class TestAction : public QObject {
+    Q_OBJECT
+
+private slots:
+    void roundTrip_data();
+    void roundTrip();
+
+    void deprecatedAliases();
+
+    void rejects_data();
+    void rejects();
+
+    void dispatchParsed();
+    void dispatchReparsed();
+};
+
+void TestAction::roundTrip_data() {
+    QTest::addColumn<QString>("spec");
+    for (const char* s : kSpecs) QTest::newRow(s) << QString::fromLatin1(s);
+    QTest::newRow("workspace:prev") << QStringLiteral("workspace:prev");
+    QTest::newRow("layout:spiral")  << QStringLiteral("layout:spiral");
+    QTest::newRow("quit")           << QStringLiteral("quit");
+}
+
+void TestAction::roundTrip() {
+    QFETCH(QString, spec);
+
+    QString error;
+    const Action a = Action::parse(spec, &error);
+    QVERIFY2(a.isValid(), qPrintable(error));
+    QCOMPARE(a.toString(), spec);
+    QCOMPARE(Action::parse(a.toString()), a);
+}
+
+void TestAction::deprecatedAliases() {
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("layout:tiling is deprecated"));
+    QCOMPARE(Action::parse("layout:tiling"), Action(ActionOp::Layout, int(TilingLayout::Spiral)));
+
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("layout:float is deprecated"));
+    QCOMPARE(Action::parse("layout:float"), Action(ActionOp::Float));
+}
+
+void TestAction::rejects_data() {
+    QTest::addColumn<QString>("spec");
+    QTest::newRow("unknown verb")   << QStringLiteral("teleport:3");
+    QTest::newRow("missing arg")    << QStringLiteral("exec:");
+    QTest::newRow("stray arg")      << QStringLiteral("close:now");
+    QTest::newRow("workspace 0")    << QStringLiteral("workspace:0");
+    QTest::newRow("bad direction")  << QStringLiteral("move:next");
+    QTest::newRow("unknown layout") << QStringLiteral("layout:hexagon");
+}
+
+void TestAction::rejects() {
+    QFETCH(QString, spec);
+
+    QString error;
+    QVERIFY(!Action::parse(spec, &error).isValid());
+    QVERIFY(!error.isEmpty());
+}
+
+// ── Benchmarks ────────────────────────────────────────────────────────────────
+// Action throughput: the same twelve triggers dispatched from pre-parsed
+// values (what bindings, the gamepad map and IPC now hand over) against
+// parsing the string on every trigger, as each hop used to.
+
+void TestAction::dispatchParsed() {
+    QList<Action> actions;
+    for (const char* s : kSpecs) actions.append(Action::parse(QString::fromLatin1(s)));
+
+    volatile int sink = 0;
+    QBENCHMARK {
+        int acc = 0;
+        for (const Action& a : actions) acc += dispatch(a);
+        sink = acc;
+    }
+    Q_UNUSED(sink);
+}
+
+void TestAction::dispatchReparsed() {
+    QStringList specs;
+    for (const char* s : kSpecs) specs.append(QString::fromLatin1(s));
+
+    volatile int sink = 0;
+    QBENCHMARK {
+        int acc = 0;
+        for (const QString& s : specs) acc += dispatch(Action::parse(s));
+        sink = acc;
+    }
+    Q_UNUSED(sink);
+}
+
+QTEST_MAIN(TestAction)
+#include "tst_action.moc"
@@ -0,0 +1,194 @@
+#include <QtTest>
+
+#include "core/Easing.h"
+
+#include <algorithm>
+#include <cmath>
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Reference curves
+//
+// Written against <cmath> rather than Easing::analytic(), so the compile-time
+// series helpers (cexp / ccos / csqrt) are checked along with the tables.
+// ─────────────────────────────────────────────────────────────────────────────
+namespace {
+
+double reference(EasingCurve c, double t) {
+    switch (c) {
+        case EasingCurve::Linear:         return t;
+        case EasingCurve::EaseInCubic:    return t * t * t;
+        case EasingCurve::EaseOutCubic:   return 1.0 - std::pow(1.0 - t, 3.0);
+        case EasingCurve::EaseInOutCubic:
+            return t < 0.5 ? 4.0 * t * t * t : 1.0 - std::pow(-2.0 * t + 2.0, 3.0) / 2.0;
+        case EasingCurve::EaseOutBack: {
+            const double c1 = 1.70158, c3 = c1 + 1.0;
+            return 1.0 + c3 * std::pow(t - 1.0, 3.0) + c1 * std::pow(t - 1.0, 2.0);
+        }
+        case EasingCurve::Spring: {
+            if (t >= 1.0) return 1.0;
+            const double zeta = 0.55, omega = 2.0 * Easing::kPi * 1.5;
+            return 1.0 - std::exp(-zeta * omega * t)
+                       * std::cos(omega * std::sqrt(1.0 - zeta * zeta) * t);
+        }
+        case EasingCurve::EaseOutQuint:   return 1.0 - std::pow(1.0 - t, 5.0);
+        case EasingCurve::EaseInQuart:    return std::pow(t, 4.0);
+    }
+    return t;
+}
+
+/// y of the CSS cubic-bezier at x, by bisection on x(s) — slow but
+/// independent of the Newton solver used to bake the tables.
+double bezierAt(double x, double x1, double y1, double x2, double y2) {
+    auto coord = [](double s, double p1, double p2) {
+        const double u = 1.0 - s;
+        return 3.0 * u * u * s * p1 + 3.0 * u * s * s * p2 + s * s * s;
+    };
+    double lo = 0.0, hi = 1.0;
+    for (int i = 0; i < 60; ++i) {
+        const double mid = 0.5 * (lo + hi);
+        (coord(mid, x1, x2) < x ? lo : hi) = mid;
+    }
+    return coord(0.5 * (lo + hi), y1, y2);
+}
+
+/// Largest |lut(t) − f(t)| over a grid much finer than the table.
+template <typename F>
+double maxError(const EasingLUT& lut, F f) {
+    double worst = 0.0;
+    for (int i = 0; i <= 10000; ++i) {
+        const double t = i / 10000.0;
+        worst = std::max(worst, std::abs(double(lut.sample(float(t))) - f(t)));
+    }
+    return worst;
+}
+
+// Linear interpolation over 512 steps: the worst curve here (spring, |f''|
+// up to ~ω²) is off by about 1e-4; float rounding adds ~1e-7.
+constexpr double kTolerance = 2e-4;
+
+} // namespace
+
+// ─────────────────────────────────────────────────────────────────────────────
+// TestEasing
+// ─────────────────────────────────────────────────────────────────────────────
+class TestEasing : public QObject {
+    Q_OBJECT
+
+private slots:
+    void builtinMatchesAnalytic_data();
+    void builtinMatchesAnalytic();
+
+    void cubicBezierMatchesReference_data();
+    void cubicBezierMatchesReference();
+
+    void fromString();
+    void sampleClamps();
+
+    void sampleLut();
+    void evaluateAnalytic();
+};
+
+void TestEasing::builtinMatchesAnalytic_data() {
+    QTest::addColumn<int>("curve");
+    for (int c = 0; c < kEasingCurveCount; ++c) {
+        const QByteArray name = EasingLUT::curveToString(EasingCurve(c)).toLatin1();
+        QTest::newRow(name.constData()) << c;
+    }
+}
+
+void TestEasing::builtinMatchesAnalytic() {
+    QFETCH(int, curve);
+    const auto c = EasingCurve(curve);
+
+    const double err = maxError(EasingLUT::builtin(c),
+                                [c](double t) { return reference(c, t); });
+    QVERIFY2(err < kTolerance, qPrintable(QString::number(err)));
+}
+
+void TestEasing::cubicBezierMatchesReference_data() {
+    QTest::addColumn<QString>("spec");
+    QTest::addColumn<double>("x1");
+    QTest::addColumn<double>("y1");
+    QTest::addColumn<double>("x2");
+    QTest::addColumn<double>("y2");
+
+    QTest::newRow("ease")        << "ease"        << 0.25 << 0.1 << 0.25 << 1.0;
+    QTest::newRow("ease-in")     << "ease-in"     << 0.42 << 0.0 << 1.0  << 1.0;
+    QTest::newRow("ease-out")    << "ease-out"    << 0.0  << 0.0 << 0.58 << 1.0;
+    QTest::newRow("ease-in-out") << "ease-in-out" << 0.42 << 0.0 << 0.58 << 1.0;
+    QTest::newRow("overshoot")   << "cubic-bezier(0.34, 1.56, 0.64, 1)"
+                                 << 0.34 << 1.56 << 0.64 << 1.0;
+    QTest::newRow("steep")       << "cubic-bezier(0.9, 0, 0.1, 1)"
+                                 << 0.9  << 0.0  << 0.1  << 1.0;
+}
+
+void TestEasing::cubicBezierMatchesReference() {
+    QFETCH(QString, spec);
+    QFETCH(double, x1);
+    QFETCH(double, y1);
+    QFETCH(double, x2);
+    QFETCH(double, y2);
+
+    EasingLUT lut;
+    QVERIFY(EasingLUT::fromString(spec, lut));
+
+    // Config values are floats; use the same rounding for the reference
+    const double fx1 = float(x1), fy1 = float(y1), fx2 = float(x2), fy2 = float(y2);
+    const double err = maxError(lut, [=](double t) { return bezierAt(t, fx1, fy1, fx2, fy2); });
+    QVERIFY2(err < kTolerance, qPrintable(QString::number(err)));
+}
+
+void TestEasing::fromString() {
+    EasingLUT lut;
+    QVERIFY(EasingLUT::fromString("  Cubic-Bezier( 0.4, 0, 0.2, 1 ) ", lut));
+    QVERIFY(EasingLUT::fromString("spring", lut));
+    QCOMPARE(lut.sample(0.3f), EasingLUT::builtin(EasingCurve::Spring).sample(0.3f));
+
+    const EasingLUT before = lut;
+    QVERIFY(!EasingLUT::fromString("cubic-bezier(0.4, 0, 0.2)", lut));
+    QVERIFY(!EasingLUT::fromString("cubic-bezier(a, b, c, d)", lut));
+    QVERIFY(!EasingLUT::fromString("bouncy", lut));
+    QCOMPARE(lut.sample(0.3f), before.sample(0.3f));
+
+    for (int c = 0; c < kEasingCurveCount; ++c) {
+        EasingCurve parsed;
+        QVERIFY(EasingLUT::curveFromString(EasingLUT::curveToString(EasingCurve(c)), parsed));
+        QCOMPARE(int(parsed), c);
+    }
+}
+
+void TestEasing::sampleClamps() {
+    const EasingLUT& lut = EasingLUT::builtin(EasingCurve::EaseOutCubic);
+    QCOMPARE(lut.sample(-1.0f), 0.0f);
+    QCOMPARE(lut.sample(0.0f),  0.0f);
+    QCOMPARE(lut.sample(1.0f),  1.0f);
+    QCOMPARE(lut.sample(2.0f),  1.0f);
+}
+
+// ── Benchmarks ────────────────────────────────────────────────────────────────
+// One animation tick's worth of evaluations: the table against the analytic
+// spring (an exp and a cos per call) it replaces.
+
+void TestEasing::sampleLut() {
+    const EasingLUT& lut = EasingLUT::builtin(EasingCurve::Spring);
+    volatile float sink = 0.0f;
+    QBENCHMARK {
+        float acc = 0.0f;
+        for (int i = 0; i < 1024; ++i) acc += lut.sample(i / 1023.0f);
+        sink = acc;
+    }
+    Q_UNUSED(sink);
+}
+
+void TestEasing::evaluateAnalytic() {
+    volatile double sink = 0.0;
+    QBENCHMARK {
+        double acc = 0.0;
+        for (int i = 0; i < 1024; ++i) acc += reference(EasingCurve::Spring, i / 1023.0);
+        sink = acc;
+    }
+    Q_UNUSED(sink);
+}
+
+QTEST_MAIN(TestEasing)
+#include "tst_easing.moc"
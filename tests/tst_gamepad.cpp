@@ -0,0 +1,133 @@
+#include <QtTest>
+
+#include "core/GamepadHandler.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <linux/input.h>
+
+#include <memory>
+
+// ─────────────────────────────────────────────────────────────────────────────
+// TestGamepad
+//
+// A fake pad: GamepadHandler adopts the read end of a pipe and the test
+// writes struct input_event records into the other end, in whatever
+// pieces it likes.
+// ─────────────────────────────────────────────────────────────────────────────
+class TestGamepad : public QObject {
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void buttonTriggersAction();
+    void selectChord();
+    void shortReadKeepsPartialEvent();
+    void dpadReleaseKeepsOppositeHeld();
+    void hatAxis();
+    void eofRemovesPad();
+
+private:
+    void write(const QByteArray& bytes);
+    static QByteArray event(int type, int code, int value);
+    static QByteArray key(int code, bool pressed);
+    static QByteArray syn() { return event(EV_SYN, SYN_REPORT, 0); }
+
+    std::unique_ptr<GamepadHandler> m_pads;
+    QList<Action>                   m_actions;
+    int                             m_writeFd = -1;
+};
+
+void TestGamepad::init() {
+    int fds[2];
+    QVERIFY(::pipe2(fds, O_NONBLOCK | O_CLOEXEC) == 0);
+    m_writeFd = fds[1];
+
+    m_actions.clear();
+    m_pads = std::make_unique<GamepadHandler>();
+    connect(m_pads.get(), &GamepadHandler::actionTriggered, this,
+            [this](const Action& a) { m_actions.append(a); });
+    m_pads->addDevice(fds[0], "pipe", "fake pad");
+    QCOMPARE(m_pads->padCount(), 1);
+}
+
+void TestGamepad::cleanup() {
+    m_pads.reset();
+    if (m_writeFd >= 0) ::close(m_writeFd);
+    m_writeFd = -1;
+}
+
+void TestGamepad::write(const QByteArray& bytes) {
+    QCOMPARE(::write(m_writeFd, bytes.constData(), bytes.size()), ssize_t(bytes.size()));
+}
+
+QByteArray TestGamepad::event(int type, int code, int value) {
+    input_event e{};
+    e.type  = quint16(type);
+    e.code  = quint16(code);
+    e.value = value;
+    return QByteArray(reinterpret_cast<const char*>(&e), sizeof(e));
+}
+
+QByteArray TestGamepad::key(int code, bool pressed) {
+    return event(EV_KEY, code, pressed ? 1 : 0);
+}
+
+void TestGamepad::buttonTriggersAction() {
+    write(key(BTN_TR, true) + syn() + key(BTN_TR, false) + syn());
+    QTRY_COMPARE(m_actions.size(), 1);
+    QCOMPARE(m_actions.first(), Action(ActionOp::WorkspaceNext));
+}
+
+void TestGamepad::selectChord() {
+    write(key(BTN_SELECT, true) + syn() + key(BTN_SOUTH, true) + syn());
+    QTRY_COMPARE(m_actions.size(), 1);
+    QCOMPARE(m_actions.first(), Action(ActionOp::Close));
+}
+
+void TestGamepad::shortReadKeepsPartialEvent() {
+    const QByteArray bytes = key(BTN_TL, true) + syn();
+    const int cut = int(sizeof(input_event)) / 2;
+
+    write(bytes.left(cut));
+    QTest::qWait(50);
+    QCOMPARE(m_actions.size(), 0);
+
+    write(bytes.mid(cut));
+    QTRY_COMPARE(m_actions.size(), 1);
+    QCOMPARE(m_actions.first(), Action(ActionOp::WorkspacePrev));
+}
+
+void TestGamepad::dpadReleaseKeepsOppositeHeld() {
+    write(key(BTN_DPAD_LEFT, true) + syn());
+    QTRY_COMPARE(m_actions.size(), 1);
+    QCOMPARE(m_actions.last(), Action(ActionOp::Focus, ActionDir::Left));
+
+    // Both held cancel out; letting go of left leaves right
+    write(key(BTN_DPAD_RIGHT, true) + syn() + key(BTN_DPAD_LEFT, false) + syn());
+    QTRY_COMPARE(m_actions.size(), 2);
+    QCOMPARE(m_actions.last(), Action(ActionOp::Focus, ActionDir::Right));
+
+    write(key(BTN_DPAD_RIGHT, false) + syn());
+}
+
+void TestGamepad::hatAxis() {
+    write(event(EV_ABS, ABS_HAT0Y, 1) + syn());
+    QTRY_COMPARE(m_actions.size(), 1);
+    QCOMPARE(m_actions.last(), Action(ActionOp::Focus, ActionDir::Down));
+
+    write(event(EV_ABS, ABS_HAT0Y, 0) + syn());
+}
+
+void TestGamepad::eofRemovesPad() {
+    QSignalSpy removed(m_pads.get(), &GamepadHandler::padRemoved);
+    ::close(m_writeFd);
+    m_writeFd = -1;
+    QTRY_COMPARE(removed.count(), 1);
+    QCOMPARE(m_pads->padCount(), 0);
+}
+
+QTEST_MAIN(TestGamepad)
+#include "tst_gamepad.moc"
@@ -0,0 +1,201 @@
+#include <QtTest>
+#include <QKeyEvent>
+
+#include "core/InputHandler.h"
+#include "core/Config.h"
+
+#include "AllocCounter.h"
+
+#include <memory>
+
+// ─────────────────────────────────────────────────────────────────────────────
+// TestKeybindings
+//
+// Drives InputHandler::handleKeyPress() with bound chords only: an unbound
+// key is forwarded to the focused surface, which needs a live compositor.
+// ─────────────────────────────────────────────────────────────────────────────
+class TestKeybindings : public QObject {
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void boundChordsFire();
+    void bareKeysImplyModifier();
+    void standaloneKeysNeedNoModifier();
+    void pressDoesNotAllocate();
+
+    void pressBound();
+    void pressModifierOnly();
+
+private:
+    std::unique_ptr<InputHandler> m_input;
+    Action                        m_last;
+    int                           m_fired = 0;
+};
+
+void TestKeybindings::init() {
+    auto& keys = Config::instance().keys;
+    keys.modifier = "Super";
+    keys.bindings.clear();
+    keys.bindings["Super+Return"]  = "exec:alacritty";
+    keys.bindings["Super+Shift+Q"] = "close";
+    keys.bindings["Super+Left"]    = "focus:left";
+    for (int i = 1; i <= 9; ++i) {
+        keys.bindings[QString("Super+%1").arg(i)]       = QString("workspace:%1").arg(i);
+        keys.bindings[QString("Super+Shift+%1").arg(i)] = QString("movetoworkspace:%1").arg(i);
+    }
+
+    // The handler never touches the compositor for bound keys
+    m_input = std::make_unique<InputHandler>(nullptr);
+    m_fired = 0;
+    connect(m_input.get(), &InputHandler::actionTriggered, this, [this](const Action& a) {
+        m_last = a;
+        ++m_fired;
+    });
+}
+
+void TestKeybindings::cleanup() {
+    m_input.reset();
+}
+
+void TestKeybindings::boundChordsFire() {
+    QKeyEvent ret(QEvent::KeyPress, Qt::Key_Return, Qt::MetaModifier);
+    QVERIFY(m_input->handleKeyPress(&ret));
+    QVERIFY(m_last.op == ActionOp::Exec);
+    QCOMPARE(m_last.str, QString("alacritty"));
+
+    // Keypad Enter is the same chord; NumLock / keypad bits are ignored
+    QKeyEvent enter(QEvent::KeyPress, Qt::Key_Enter, Qt::MetaModifier | Qt::KeypadModifier);
+    QVERIFY(m_input->handleKeyPress(&enter));
+    QCOMPARE(m_fired, 2);
+
+    QKeyEvent ws(QEvent::KeyPress, Qt::Key_3, Qt::MetaModifier);
+    QVERIFY(m_input->handleKeyPress(&ws));
+    QCOMPARE(m_last, Action(ActionOp::Workspace, 3));
+
+    QKeyEvent mv(QEvent::KeyPress, Qt::Key_3, Qt::MetaModifier | Qt::ShiftModifier);
+    QVERIFY(m_input->handleKeyPress(&mv));
+    QCOMPARE(m_last, Action(ActionOp::MoveToWorkspace, 3));
+
+    QKeyEvent left(QEvent::KeyPress, Qt::Key_Left, Qt::MetaModifier);
+    QVERIFY(m_input->handleKeyPress(&left));
+    QCOMPARE(m_last, Action(ActionOp::Focus, ActionDir::Left));
+
+    // A bare modifier press is a prefix, never a trigger
+    QKeyEvent meta(QEvent::KeyPress, Qt::Key_Meta, Qt::MetaModifier);
+    QVERIFY(!m_input->handleKeyPress(&meta));
+    QCOMPARE(m_fired, 5);
+}
+
+void TestKeybindings::bareKeysImplyModifier() {
+    // The default config's spelling: no modifier, lower-case letters
+    auto& keys = Config::instance().keys;
+    keys.bindings.clear();
+    keys.bindings["Return"]  = "exec:alacritty";
+    keys.bindings["d"]       = "exec:fuzzel";
+    keys.bindings["Shift+f"] = "float";
+    keys.bindings["4"]       = "workspace:4";
+    m_input->reloadBindings();
+
+    // Plain keys are typing, not bindings
+    QKeyEvent plain(QEvent::KeyPress, Qt::Key_Return, Qt::NoModifier);
+    QVERIFY(!m_input->handleKeyPress(&plain));
+    QKeyEvent shiftF(QEvent::KeyPress, Qt::Key_F, Qt::ShiftModifier);
+    QVERIFY(!m_input->handleKeyPress(&shiftF));
+    QCOMPARE(m_fired, 0);
+
+    QKeyEvent ret(QEvent::KeyPress, Qt::Key_Return, Qt::MetaModifier);
+    QVERIFY(m_input->handleKeyPress(&ret));
+    QCOMPARE(m_last.str, QString("alacritty"));
+
+    QKeyEvent d(QEvent::KeyPress, Qt::Key_D, Qt::MetaModifier);
+    QVERIFY(m_input->handleKeyPress(&d));
+    QCOMPARE(m_last.str, QString("fuzzel"));
+
+    QKeyEvent f(QEvent::KeyPress, Qt::Key_F, Qt::MetaModifier | Qt::ShiftModifier);
+    QVERIFY(m_input->handleKeyPress(&f));
+    QCOMPARE(m_last, Action(ActionOp::Float));
+
+    QKeyEvent ws(QEvent::KeyPress, Qt::Key_4, Qt::MetaModifier);
+    QVERIFY(m_input->handleKeyPress(&ws));
+    QCOMPARE(m_last, Action(ActionOp::Workspace, 4));
+    QCOMPARE(m_fired, 4);
+}
+
+void TestKeybindings::standaloneKeysNeedNoModifier() {
+    // Keys that type nothing keep firing without the WM modifier
+    auto& keys = Config::instance().keys;
+    keys.bindings.clear();
+    keys.bindings["Print"]       = "exec:grim";
+    keys.bindings["Shift+Print"] = "exec:slurp";
+    keys.bindings["F5"]          = "reload";
+    keys.bindings["Super+F6"]    = "quit";
+    m_input->reloadBindings();
+
+    QKeyEvent print(QEvent::KeyPress, Qt::Key_Print, Qt::NoModifier);
+    QVERIFY(m_input->handleKeyPress(&print));
+    QCOMPARE(m_last.str, QString("grim"));
+
+    QKeyEvent shiftPrint(QEvent::KeyPress, Qt::Key_Print, Qt::ShiftModifier);
+    QVERIFY(m_input->handleKeyPress(&shiftPrint));
+    QCOMPARE(m_last.str, QString("slurp"));
+
+    QKeyEvent f5(QEvent::KeyPress, Qt::Key_F5, Qt::NoModifier);
+    QVERIFY(m_input->handleKeyPress(&f5));
+    QCOMPARE(m_last, Action(ActionOp::Reload));
+    QCOMPARE(m_fired, 3);
+
+    // Naming the modifier still makes it part of the chord
+    QKeyEvent f6(QEvent::KeyPress, Qt::Key_F6, Qt::NoModifier);
+    QVERIFY(!m_input->handleKeyPress(&f6));
+    QKeyEvent superF6(QEvent::KeyPress, Qt::Key_F6, Qt::MetaModifier);
+    QVERIFY(m_input->handleKeyPress(&superF6));
+    QCOMPARE(m_last, Action(ActionOp::Quit));
+}
+
+void TestKeybindings::pressDoesNotAllocate() {
+#ifndef HLWM_COUNT_ALLOCS
+    QSKIP("allocation counting needs glibc");
+#endif
+    QKeyEvent press(QEvent::KeyPress,     Qt::Key_5, Qt::MetaModifier);
+    QKeyEvent release(QEvent::KeyRelease, Qt::Key_5, Qt::MetaModifier);
+
+    // First press grows the consumed-key set
+    m_input->handleKeyPress(&press);
+    m_input->handleKeyRelease(&release);
+
+    long allocs = 0;
+    {
+        AllocScope scope;
+        for (int i = 0; i < 1000; ++i) {
+            m_input->handleKeyPress(&press);
+            m_input->handleKeyRelease(&release);
+        }
+        allocs = scope.count();
+    }
+    QCOMPARE(m_fired, 1001);
+    QCOMPARE(allocs, 0L);
+}
+
+// ── Benchmarks ────────────────────────────────────────────────────────────────
+
+void TestKeybindings::pressBound() {
+    QKeyEvent press(QEvent::KeyPress,     Qt::Key_Q, Qt::MetaModifier | Qt::ShiftModifier);
+    QKeyEvent release(QEvent::KeyRelease, Qt::Key_Q, Qt::MetaModifier | Qt::ShiftModifier);
+    QBENCHMARK {
+        m_input->handleKeyPress(&press);
+        m_input->handleKeyRelease(&release);
+    }
+}
+
+void TestKeybindings::pressModifierOnly() {
+    QKeyEvent press(QEvent::KeyPress, Qt::Key_Shift, Qt::MetaModifier | Qt::ShiftModifier);
+    QBENCHMARK {
+        m_input->handleKeyPress(&press);
+    }
+}
+
+QTEST_MAIN(TestKeybindings)
+#include "tst_keybindings.moc"
@@ -0,0 +1,189 @@
+#include <QtTest>
+#include <QDir>
+
+#include "core/LibinputBackend.h"
+#include "core/InputHandler.h"
+#include "core/Config.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/uinput.h>
+
+#include <cstring>
+#include <memory>
+
+// ─────────────────────────────────────────────────────────────────────────────
+// TestLibinput
+//
+// The path backend against uinput devices.  Needs write access to
+// /dev/uinput and read access to the event node it creates; skipped
+// otherwise, as on most CI runners.
+// ─────────────────────────────────────────────────────────────────────────────
+class TestLibinput : public QObject {
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void noDevices();
+    void missingDevice();
+    void keyChordFromDevice();
+    void pointerMotionFromDevice();
+
+private:
+    /// Create a uinput keyboard or mouse; returns its /dev/input/event* node.
+    QString createKeyboard() { return createDevice(false); }
+    QString createMouse()    { return createDevice(true); }
+    QString createDevice(bool mouse);
+    void    emitKey(int code, int value);
+    void    emitMotion(int dx, int dy);
+
+    std::unique_ptr<InputHandler>    m_input;
+    std::unique_ptr<LibinputBackend> m_backend;
+    Action                           m_last;
+    int                              m_fired   = 0;
+    int                              m_uinput  = -1;
+};
+
+void TestLibinput::init() {
+    auto& keys = Config::instance().keys;
+    keys.modifier = "Super";
+    keys.bindings.clear();
+    keys.bindings["Super+Return"] = "exec:alacritty";
+
+    m_input = std::make_unique<InputHandler>(nullptr);
+    m_fired = 0;
+    connect(m_input.get(), &InputHandler::actionTriggered, this, [this](const Action& a) {
+        m_last = a;
+        ++m_fired;
+    });
+    m_backend = std::make_unique<LibinputBackend>(m_input.get());
+}
+
+void TestLibinput::cleanup() {
+    // Thread first: it must not read a device that is going away
+    m_backend.reset();
+    m_input.reset();
+    if (m_uinput >= 0) {
+        ::ioctl(m_uinput, UI_DEV_DESTROY);
+        ::close(m_uinput);
+        m_uinput = -1;
+    }
+}
+
+QString TestLibinput::createDevice(bool mouse) {
+    m_uinput = ::open("/dev/uinput", O_WRONLY | O_NONBLOCK | O_CLOEXEC);
+    if (m_uinput < 0) return {};
+
+    ::ioctl(m_uinput, UI_SET_EVBIT, EV_KEY);
+    if (mouse) {
+        ::ioctl(m_uinput, UI_SET_EVBIT, EV_REL);
+        ::ioctl(m_uinput, UI_SET_RELBIT, REL_X);
+        ::ioctl(m_uinput, UI_SET_RELBIT, REL_Y);
+        for (int b : { BTN_LEFT, BTN_RIGHT, BTN_MIDDLE })
+            ::ioctl(m_uinput, UI_SET_KEYBIT, b);
+    } else {
+        for (int k : { KEY_LEFTMETA, KEY_ENTER, KEY_A, KEY_LEFTSHIFT })
+            ::ioctl(m_uinput, UI_SET_KEYBIT, k);
+    }
+
+    uinput_setup setup{};
+    setup.id.bustype = BUS_VIRTUAL;
+    setup.id.vendor  = 0x1234;
+    setup.id.product = 0x5678;
+    std::strncpy(setup.name, mouse ? "hackerlandwm test mouse" : "hackerlandwm test keyboard",
+                 UINPUT_MAX_NAME_SIZE - 1);
+    if (::ioctl(m_uinput, UI_DEV_SETUP, &setup) < 0 ||
+        ::ioctl(m_uinput, UI_DEV_CREATE) < 0) {
+        return {};
+    }
+
+    char sysname[64] = {};
+    if (::ioctl(m_uinput, UI_GET_SYSNAME(sizeof(sysname)), sysname) < 0) return {};
+    const QDir dir(QStringLiteral("/sys/devices/virtual/input/") + QString::fromLatin1(sysname));
+    const QStringList events = dir.entryList({ "event*" }, QDir::Dirs);
+    if (events.isEmpty()) return {};
+
+    const QString node = QStringLiteral("/dev/input/") + events.first();
+    // devtmpfs creates the node asynchronously; udev then applies its rules
+    QTest::qWaitFor([&] { return QFile::exists(node); }, 2000);
+    QTest::qWait(200);
+    return node;
+}
+
+void TestLibinput::emitKey(int code, int value) {
+    input_event ev[2] = {};
+    ev[0].type = EV_KEY; ev[0].code = quint16(code); ev[0].value = value;
+    ev[1].type = EV_SYN; ev[1].code = SYN_REPORT;
+    QCOMPARE(::write(m_uinput, ev, sizeof(ev)), ssize_t(sizeof(ev)));
+}
+
+void TestLibinput::emitMotion(int dx, int dy) {
+    input_event ev[3] = {};
+    ev[0].type = EV_REL; ev[0].code = REL_X; ev[0].value = dx;
+    ev[1].type = EV_REL; ev[1].code = REL_Y; ev[1].value = dy;
+    ev[2].type = EV_SYN; ev[2].code = SYN_REPORT;
+    QCOMPARE(::write(m_uinput, ev, sizeof(ev)), ssize_t(sizeof(ev)));
+}
+
+void TestLibinput::noDevices() {
+    QVERIFY(!m_backend->startWithDevices({}));
+    QVERIFY(!m_backend->isActive());
+    QVERIFY(!m_input->nativeInput());
+}
+
+void TestLibinput::missingDevice() {
+    QVERIFY(!m_backend->startWithDevices({ "/dev/input/event-does-not-exist" }));
+    QVERIFY(!m_backend->isActive());
+    QVERIFY(!m_input->nativeInput());
+}
+
+void TestLibinput::keyChordFromDevice() {
+    const QString node = createKeyboard();
+    if (node.isEmpty()) QSKIP("uinput not available");
+    if (!m_backend->startWithDevices({ node }))
+        QSKIP("libinput cannot open the uinput device (permissions or no keymap)");
+
+    QVERIFY(m_backend->isActive());
+    QVERIFY(m_input->nativeInput());
+
+    emitKey(KEY_LEFTMETA, 1);
+    emitKey(KEY_ENTER,    1);
+    emitKey(KEY_ENTER,    0);
+    emitKey(KEY_LEFTMETA, 0);
+
+    QTRY_COMPARE(m_fired, 1);
+    QVERIFY(m_last.op == ActionOp::Exec);
+    QCOMPARE(m_last.str, QString("alacritty"));
+
+    // A plain key is forwarded (to nothing, headless), never a binding
+    emitKey(KEY_A, 1);
+    emitKey(KEY_A, 0);
+    QTest::qWait(100);
+    QCOMPARE(m_fired, 1);
+
+    m_backend->stop();
+    QVERIFY(!m_input->nativeInput());
+}
+
+void TestLibinput::pointerMotionFromDevice() {
+    const QString node = createMouse();
+    if (node.isEmpty()) QSKIP("uinput not available");
+    if (!m_backend->startWithDevices({ node }))
+        QSKIP("libinput cannot open the uinput device (permissions)");
+
+    // Headless: no compositor, so no output to clamp to and no window to hit
+    QCOMPARE(m_input->cursorPos(), QPoint(0, 0));
+    for (int i = 0; i < 10; ++i) emitMotion(5, 3);
+    QTRY_VERIFY(m_input->cursorPos().x() > 0 && m_input->cursorPos().y() > 0);
+    QVERIFY(m_input->cursorPos().x() > m_input->cursorPos().y());
+
+    // Never left of or above the origin
+    for (int i = 0; i < 50; ++i) emitMotion(-40, -40);
+    QTRY_COMPARE(m_input->cursorPos(), QPoint(0, 0));
+}
+
+QTEST_MAIN(TestLibinput)
+#include "tst_libinput.moc"
@@ -0,0 +1,213 @@
+#include <QtTest>
+#include <QLoggingCategory>
+#include <QRandomGenerator>
+
+#include "core/SpatialIndex.h"
+#include "core/Workspace.h"
+#include "core/Window.h"
+
+#include <memory>
+#include <vector>
+
+// ─────────────────────────────────────────────────────────────────────────────
+// TestSpatialIndex
+//
+// Hit-testing and directional lookup at 10 / 100 / 1000 floating windows of
+// scratchpad-like sizes scattered over a 4K output, against the linear
+// back-to-front scan the index replaced.
+// ─────────────────────────────────────────────────────────────────────────────
+class TestSpatialIndex : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanup();
+
+    void topAtMatchesLinearScan_data();
+    void topAtMatchesLinearScan();
+    void maximizedWindowIsOnTop();
+
+    void topAt_data();
+    void topAt();
+    void linearScan_data();
+    void linearScan();
+    void nearest_data();
+    void nearest();
+    void update_data();
+    void update();
+
+private:
+    void    scatter(int count);
+    Window* linearTopAt(const QPoint& pos) const;
+
+    static void addCountRows();
+    static QList<QPoint> probes();
+
+    SpatialIndex                         m_index;
+    QList<Window*>                       m_windows;
+    std::vector<std::unique_ptr<Window>> m_owned;
+};
+
+static const QRect kOutput(0, 0, 3840, 2160);
+
+void TestSpatialIndex::initTestCase() {
+    // Window and Workspace log every state change at debug level
+    QLoggingCategory::setFilterRules(QStringLiteral("*.debug=false"));
+}
+
+void TestSpatialIndex::cleanup() {
+    m_index.clear();
+    m_windows.clear();
+    m_owned.clear();
+}
+
+void TestSpatialIndex::scatter(int count) {
+    QRandomGenerator rng(count);   // fixed seed per size
+    for (int i = 0; i < count; ++i) {
+        auto w = std::make_unique<Window>(nullptr);
+        w->setState(WindowState::Floating);
+        const int width  = 200 + rng.bounded(900);
+        const int height = 150 + rng.bounded(700);
+        w->setGeometry(QRect(rng.bounded(kOutput.width()  - width),
+                             rng.bounded(kOutput.height() - height),
+                             width, height));
+        m_windows.append(w.get());
+        m_owned.push_back(std::move(w));
+    }
+    for (Window* w : std::as_const(m_windows)) m_index.update(w);
+    m_index.restack(m_windows);
+}
+
+Window* TestSpatialIndex::linearTopAt(const QPoint& pos) const {
+    for (auto it = m_windows.crbegin(); it != m_windows.crend(); ++it) {
+        if ((*it)->isVisible() && (*it)->geometry().contains(pos)) return *it;
+    }
+    return nullptr;
+}
+
+void TestSpatialIndex::addCountRows() {
+    QTest::addColumn<int>("count");
+    QTest::newRow("10")   << 10;
+    QTest::newRow("100")  << 100;
+    QTest::newRow("1000") << 1000;
+}
+
+QList<QPoint> TestSpatialIndex::probes() {
+    QList<QPoint> points;
+    QRandomGenerator rng(42);
+    for (int i = 0; i < 256; ++i)
+        points.append(QPoint(rng.bounded(kOutput.width()), rng.bounded(kOutput.height())));
+    return points;
+}
+
+// ── Correctness ───────────────────────────────────────────────────────────────
+
+void TestSpatialIndex::topAtMatchesLinearScan_data() {
+    addCountRows();
+}
+
+void TestSpatialIndex::topAtMatchesLinearScan() {
+    QFETCH(int, count);
+    scatter(count);
+
+    // Hide a few so the visibility filter is exercised too
+    for (int i = 0; i < m_windows.size(); i += 7) m_windows[i]->setVisible(false);
+
+    for (const QPoint& p : probes())
+        QCOMPARE(m_index.topAt(p), linearTopAt(p));
+}
+
+void TestSpatialIndex::maximizedWindowIsOnTop() {
+    Workspace ws(1);
+    Window below(nullptr), above(nullptr);
+    for (Window* w : {&below, &above}) {
+        w->setState(WindowState::Floating);
+        w->setGeometry(QRect(100, 100, 400, 300));
+        ws.addWindow(w);
+    }
+    QCOMPARE(ws.windowAt(QPoint(200, 200)), &above);
+
+    // The spatial index must be restacked after the window moves to the end
+    // of the list, not before
+    below.setState(WindowState::Maximized);
+    QCOMPARE(ws.windowAt(QPoint(200, 200)), &below);
+
+    ws.removeWindow(&below);
+    ws.removeWindow(&above);
+}
+
+// ── Benchmarks ────────────────────────────────────────────────────────────────
+
+void TestSpatialIndex::topAt_data() {
+    addCountRows();
+}
+
+void TestSpatialIndex::topAt() {
+    QFETCH(int, count);
+    scatter(count);
+    const QList<QPoint> points = probes();
+    Window* sink = nullptr;
+    QBENCHMARK {
+        for (const QPoint& p : points) sink = m_index.topAt(p);
+    }
+    Q_UNUSED(sink);
+}
+
+void TestSpatialIndex::linearScan_data() {
+    addCountRows();
+}
+
+void TestSpatialIndex::linearScan() {
+    QFETCH(int, count);
+    scatter(count);
+    const QList<QPoint> points = probes();
+    Window* sink = nullptr;
+    QBENCHMARK {
+        // What windowAt() used to do: copy the list, scan back to front
+        for (const QPoint& p : points) {
+            const QList<Window*> copy = m_windows;
+            Q_UNUSED(copy);
+            sink = linearTopAt(p);
+        }
+    }
+    Q_UNUSED(sink);
+}
+
+void TestSpatialIndex::nearest_data() {
+    addCountRows();
+}
+
+void TestSpatialIndex::nearest() {
+    QFETCH(int, count);
+    scatter(count);
+    const QList<QPoint> points = probes();
+    static constexpr Qt::Edge kDirs[] = {
+        Qt::LeftEdge, Qt::RightEdge, Qt::TopEdge, Qt::BottomEdge
+    };
+    Window* sink = nullptr;
+    QBENCHMARK {
+        int i = 0;
+        for (const QPoint& p : points) sink = m_index.nearest(p, kDirs[i++ & 3]);
+    }
+    Q_UNUSED(sink);
+}
+
+void TestSpatialIndex::update_data() {
+    addCountRows();
+}
+
+void TestSpatialIndex::update() {
+    // One window dragged across the output, as during an interactive move
+    QFETCH(int, count);
+    scatter(count);
+    Window* w = m_windows.first();
+    int x = 0;
+    QBENCHMARK {
+        x = (x + 37) % (kOutput.width() - w->geometry().width());
+        w->setGeometry(QRect(QPoint(x, w->geometry().y()), w->geometry().size()));
+        m_index.update(w);
+    }
+}
+
+QTEST_MAIN(TestSpatialIndex)
+#include "tst_spatialindex.moc"
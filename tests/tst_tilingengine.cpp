@@ -0,0 +1,126 @@
+#include <QtTest>
+
+#include "core/TilingEngine.h"
+#include "core/BSPTree.h"
+#include "core/Window.h"
+
+#include "AllocCounter.h"
+
+#include <memory>
+#include <vector>
+
+// ─────────────────────────────────────────────────────────────────────────────
+// TestTilingEngine
+// ─────────────────────────────────────────────────────────────────────────────
+class TestTilingEngine : public QObject {
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void steadyStateDoesNotAllocate_data();
+    void steadyStateDoesNotAllocate();
+
+    void tileInto_data();
+    void tileInto();
+
+private:
+    void makeWindows(int n);
+    QList<Window*> m_windows;
+    std::vector<std::unique_ptr<Window>> m_owned;
+};
+
+void TestTilingEngine::init() {
+    makeWindows(12);
+}
+
+void TestTilingEngine::cleanup() {
+    m_windows.clear();
+    m_owned.clear();
+}
+
+void TestTilingEngine::makeWindows(int n) {
+    m_windows.clear();
+    m_owned.clear();
+    for (int i = 0; i < n; ++i) {
+        auto w = std::make_unique<Window>(nullptr);
+        w->setState(WindowState::Tiled);
+        m_windows.append(w.get());
+        m_owned.push_back(std::move(w));
+    }
+}
+
+static void addLayoutRows() {
+    QTest::addColumn<int>("layoutIndex");
+    QTest::newRow("spiral")      << int(TilingLayout::Spiral);
+    QTest::newRow("tall")        << int(TilingLayout::Tall);
+    QTest::newRow("wide")        << int(TilingLayout::Wide);
+    QTest::newRow("grid")        << int(TilingLayout::Grid);
+    QTest::newRow("dwindle")     << int(TilingLayout::Dwindle);
+    QTest::newRow("monocle")     << int(TilingLayout::Monocle);
+    QTest::newRow("centered")    << int(TilingLayout::Centered);
+    QTest::newRow("threecolumn") << int(TilingLayout::ThreeColumn);
+    QTest::newRow("bsp")         << int(TilingLayout::BSP);
+}
+
+void TestTilingEngine::steadyStateDoesNotAllocate_data() {
+    addLayoutRows();
+}
+
+void TestTilingEngine::steadyStateDoesNotAllocate() {
+#ifndef HLWM_COUNT_ALLOCS
+    QSKIP("allocation counting needs glibc");
+#endif
+    QFETCH(int, layoutIndex);
+    const auto layout = TilingLayout(layoutIndex);
+
+    TilingEngine engine;
+    BSPTree tree;
+    BSPTree* bsp = (layout == TilingLayout::BSP) ? &tree : nullptr;
+    QList<TileResult> out;
+
+    // Every call below uses a different area than the previous one, so each
+    // misses the layout cache and runs the full layout pass.
+    auto areaFor = [](int i) { return QRect(0, 0, 1920 - (i % 8) * 10, 1080); };
+
+    // Warm-up grows the scratch buffers, the output list and the BSP tree
+    for (int i = 0; i < 8; ++i)
+        engine.tileInto(m_windows, areaFor(i), layout, out, bsp, m_windows.first());
+    const quint64 missesBefore = engine.cacheMisses();
+
+    long allocs = 0;
+    {
+        AllocScope scope;
+        for (int i = 1; i <= 100; ++i)
+            engine.tileInto(m_windows, areaFor(i), layout, out, bsp, m_windows.first());
+        allocs = scope.count();
+    }
+
+    QCOMPARE(engine.cacheMisses() - missesBefore, quint64(100));
+    QCOMPARE(out.size(), m_windows.size());
+    QCOMPARE(allocs, 0L);
+}
+
+void TestTilingEngine::tileInto_data() {
+    addLayoutRows();
+}
+
+void TestTilingEngine::tileInto() {
+    QFETCH(int, layoutIndex);
+    const auto layout = TilingLayout(layoutIndex);
+
+    TilingEngine engine;
+    BSPTree tree;
+    BSPTree* bsp = (layout == TilingLayout::BSP) ? &tree : nullptr;
+    QList<TileResult> out;
+    int i = 0;
+
+    QBENCHMARK {
+        engine.tileInto(m_windows, QRect(0, 0, 1920 - (++i % 8) * 10, 1080),
+                        layout, out, bsp, m_windows.first());
+    }
+}
+
+QTEST_MAIN(TestTilingEngine)
+#include "tst_tilingengine.moc"